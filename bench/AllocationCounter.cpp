@@ -0,0 +1,155 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        AllocationCounter.cpp
+// Description: Counts every heap allocation made in the program it is linked into, so the
+//              benchmarks and tests can check which paths allocate.
+// Notes:       Linking AllocationCounter.cpp replaces every form of operator new and operator
+//              delete in the program, so it must be linked into programs only, never into ui_lib.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Allocation counting - every form of operator new in the process goes through here, and every
+// form of operator delete frees what it handed out
+//--------------------------------------------------------------------------------------------------
+static std::atomic<unsigned long int> allocation_count (0);
+
+static void* count_allocation (const std::size_t& size, const std::size_t& alignment)
+{
+    allocation_count.fetch_add (1, std::memory_order_relaxed);
+
+    std::size_t rounded_size = size == 0 ? 1 : size;
+
+    if (alignment <= alignof (std::max_align_t))
+        return std::malloc (rounded_size);
+
+    // aligned_alloc() wants the size to be a whole number of alignments
+    rounded_size = (rounded_size + alignment - 1) / alignment * alignment;
+
+    return std::aligned_alloc (alignment, rounded_size);
+}
+
+void* operator new (std::size_t size)
+{
+    void* memory = count_allocation (size, 0);
+
+    if (memory == NULL)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[] (std::size_t size)
+{
+    return operator new (size);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    void* memory = count_allocation (size, (std::size_t) alignment);
+
+    if (memory == NULL)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+    return operator new (size, alignment);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    return count_allocation (size, 0);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    return count_allocation (size, 0);
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return count_allocation (size, (std::size_t) alignment);
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment,
+                      const std::nothrow_t&) noexcept
+{
+    return count_allocation (size, (std::size_t) alignment);
+}
+
+void operator delete (void* memory) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete (void* memory, std::size_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory, std::size_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete (void* memory, std::align_val_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory, std::align_val_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete (void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete (void* memory, const std::nothrow_t&) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory, const std::nothrow_t&) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete (void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free (memory);
+}
+
+void operator delete[] (void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free (memory);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many times operator new, in any of its forms, has been called so far
+//--------------------------------------------------------------------------------------------------
+unsigned long int get_allocation_count()
+{
+    return allocation_count.load (std::memory_order_relaxed);
+}
@@ -0,0 +1,17 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        AllocationCounter.hpp
+// Description: Counts every heap allocation made in the program it is linked into, so the
+//              benchmarks and tests can check which paths allocate.
+// Notes:       Linking AllocationCounter.cpp replaces every form of operator new and operator
+//              delete in the program, so it must be linked into programs only, never into ui_lib.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef AllocationCounter_hpp
+#define AllocationCounter_hpp
+
+// Returns how many times operator new, in any of its forms, has been called so far
+unsigned long int get_allocation_count();
+
+#endif /* AllocationCounter_hpp */
@@ -0,0 +1,764 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        bench.cpp
+// Description: Benchmarks for the UI library's write, clear, refresh and text measuring paths
+// Notes:       Everything runs headless: nCurses is started with newterm() writing into a temporary
+//              file (which also lets us count the bytes that would have gone to the terminal) and
+//              reading from /dev/null, and some benchmarks are repeated on the MemoryBackend to
+//              take terminal output out of the picture entirely.
+//
+//              Every result is printed as one JSON object per line so that runs can be compared
+//              by a script.  An optional argument scales the number of iterations, for example
+//              "ui_bench 0.1" for a quick smoke run.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+#include "AllocationCounter.hpp"
+#include "MemoryBackend.hpp"
+#include "NcursesBackend.hpp"
+#include "UI.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Helpers
+//--------------------------------------------------------------------------------------------------
+static const unsigned int screen_width = 160;
+static const unsigned int screen_height = 50;
+static double iteration_scale = 1.0;
+
+typedef std::chrono::steady_clock Clock;
+
+// Scales a default iteration count by the command line argument, never going below 1
+static unsigned long int iterations (const unsigned long int& default_iterations)
+{
+    unsigned long int scaled = (unsigned long int) (default_iterations * iteration_scale);
+
+    return scaled > 0 ? scaled : 1;
+}
+
+static double seconds_since (const Clock::time_point& start)
+{
+    return std::chrono::duration<double> (Clock::now() - start).count();
+}
+
+// Prints one result as a line of JSON
+static void report (const std::string& benchmark, const std::string& backend,
+                    const std::string& metric, const double& value, const std::string& unit)
+{
+    std::printf ("{\"benchmark\": \"%s\", \"backend\": \"%s\", \"metric\": \"%s\", "
+                 "\"value\": %.3f, \"unit\": \"%s\"}\n",
+                 benchmark.c_str(), backend.c_str(), metric.c_str(), value, unit.c_str());
+    std::fflush (stdout);
+}
+
+// An nCurses backend that writes to a temporary file instead of the terminal
+class HeadlessTerminal
+{
+private:
+    FILE* output_file;
+    FILE* input_file;
+
+public:
+    NcursesBackend* backend;
+
+    HeadlessTerminal()
+    {
+        output_file = std::tmpfile();
+        input_file = std::fopen ("/dev/null", "r");
+        backend = new NcursesBackend (output_file, input_file, "xterm");
+    }
+
+    ~HeadlessTerminal()
+    {
+        delete backend;
+        std::fclose (input_file);
+        std::fclose (output_file);
+    }
+
+    // Bytes nCurses has sent to the "terminal" so far
+    long int get_bytes_written()
+    {
+        std::fflush (output_file);
+        return std::ftell (output_file);
+    }
+};
+
+// Makes count windows tiled across the screen, four to a row
+static void make_tiled_windows (UI& ui, const unsigned int& count, const bool& is_centered)
+{
+    const unsigned int columns = count < 4 ? count : 4;
+    const unsigned int rows = (count + columns - 1) / columns;
+    const unsigned int width = screen_width / columns;
+    const unsigned int height = screen_height / rows;
+
+    for (unsigned int i = 0; i < count; i++)
+        ui.make_new_window ((i % columns) * width, (i / columns) * height, width, height,
+                            "Window " + std::to_string (i), is_centered, 100);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Lines per second through UI::write_to_window for each data type, plus heap allocations per write
+// once the path is warm
+//--------------------------------------------------------------------------------------------------
+template <typename Value>
+static void bench_write_type (UI& ui, const std::string& backend_name, const std::string& type_name,
+                              const Value& value)
+{
+    const unsigned long int warm_up_writes = 1000;
+    const unsigned long int writes = iterations (100000);
+
+    for (unsigned long int i = 0; i < warm_up_writes; i++)
+        ui.write_to_window (0, value, true);
+
+    unsigned long int allocations_before = get_allocation_count();
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < writes; i++)
+        ui.write_to_window (0, value, true);
+
+    double elapsed = seconds_since (start);
+    unsigned long int allocations = get_allocation_count() - allocations_before;
+
+    report ("write_to_window/" + type_name, backend_name, "lines_per_second", writes / elapsed,
+            "lines/s");
+    report ("write_to_window/" + type_name, backend_name, "allocations_per_write",
+            (double) allocations / writes, "allocations");
+}
+
+static void bench_write_types (UI& ui, const std::string& backend_name)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+
+    ui.make_new_window (0, 0, 80, 24, "Types", false, 1000);
+
+    bench_write_type (ui, backend_name, "string", text);
+    bench_write_type (ui, backend_name, "string_view", std::string_view (text));
+    bench_write_type (ui, backend_name, "int", 1234567);
+    bench_write_type (ui, backend_name, "float", 3.14159f);
+    bench_write_type (ui, backend_name, "double", 2.718281828);
+    bench_write_type (ui, backend_name, "char", 'x');
+}
+
+//--------------------------------------------------------------------------------------------------
+// Cost of UI::write_to_all_windows as the number of windows grows
+//--------------------------------------------------------------------------------------------------
+static void bench_write_to_all_windows (UI& ui, const std::string& backend_name,
+                                        const unsigned int& window_count)
+{
+    const unsigned long int calls = iterations (2000);
+
+    make_tiled_windows (ui, window_count, false);
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < calls; i++)
+        ui.write_to_all_windows ("Broadcast status line", true);
+
+    report ("write_to_all_windows/" + std::to_string (window_count), backend_name,
+            "microseconds_per_call", seconds_since (start) * 1e6 / calls, "us");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Centered versus left-aligned writes
+//--------------------------------------------------------------------------------------------------
+static void bench_alignment (UI& ui, const std::string& backend_name, const bool& is_centered)
+{
+    const unsigned long int writes = iterations (100000);
+
+    ui.make_new_window (0, 0, 80, 24, "Alignment", is_centered, 1000);
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < writes; i++)
+        ui.write_to_window (0, "Aligned line of text", true);
+
+    report (is_centered ? "write/centered" : "write/left_aligned", backend_name,
+            "nanoseconds_per_write", seconds_since (start) * 1e9 / writes, "ns");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Writes of a line of CJK text, which go through the UTF-8 paths rather than the ASCII ones
+//--------------------------------------------------------------------------------------------------
+static void bench_utf8_write (UI& ui, const std::string& backend_name)
+{
+    const unsigned long int writes = iterations (100000);
+
+    ui.make_new_window (0, 0, 80, 24, "UTF-8", TextAlignment::left, TextWrap::word, 1000);
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < writes; i++)
+        ui.write_to_window (0, "\u65e5\u672c\u8a9e\u306e\u30c6\u30ad\u30b9\u30c8 "
+                               "\u4e2d\u6587 text", true);
+
+    report ("write/utf8", backend_name, "nanoseconds_per_write",
+            seconds_since (start) * 1e9 / writes, "ns");
+}
+
+//--------------------------------------------------------------------------------------------------
+// A log viewer writing lines that cycle through four levels, either all plain or with each line
+// colored by its level and the level name in bold
+//--------------------------------------------------------------------------------------------------
+static void bench_log_viewer (UI& ui, const std::string& backend_name, const bool& is_styled)
+{
+    const unsigned long int writes = iterations (100000);
+    const std::string lines[] = { "DEBUG cache refreshed in 12 ms",
+                                  "INFO  request served, 200 OK",
+                                  "WARN  slow response from upstream",
+                                  "ERROR connection reset by peer" };
+    const Color colors[] = { Color::blue, Color::default_color, Color::yellow, Color::red };
+
+    ui.make_new_window (0, 0, 80, 24, "Log", TextAlignment::left, TextWrap::word, 1000);
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < writes; i++)
+    {
+        const std::string& line = lines[i % 4];
+
+        if (is_styled)
+        {
+            const StyleSpan spans[] = {
+                { 0, 5, { colors[i % 4], Color::default_color, bold_attribute } },
+                { 5, line.length() - 5, { colors[i % 4], Color::default_color, 0 } } };
+
+            ui.write_spans (0, line, spans, 2, true);
+        }
+        else
+            ui.write_to_window (0, line, true);
+    }
+
+    report (is_styled ? "log_viewer/styled" : "log_viewer/plain", backend_name,
+            "nanoseconds_per_write", seconds_since (start) * 1e9 / writes, "ns");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Cost of UI::clear_all_windows on windows that are full of text
+//--------------------------------------------------------------------------------------------------
+static void bench_clear_all_windows (UI& ui, const std::string& backend_name)
+{
+    const unsigned int window_count = 16;
+    const unsigned long int calls = iterations (2000);
+
+    make_tiled_windows (ui, window_count, false);
+
+    double elapsed = 0;
+
+    for (unsigned long int i = 0; i < calls; i++)
+    {
+        ui.write_to_all_windows ("Line of text that will be cleared", true);
+
+        Clock::time_point start = Clock::now();
+        ui.clear_all_windows();
+        elapsed += seconds_since (start);
+    }
+
+    report ("clear_all_windows/16", backend_name, "microseconds_per_call", elapsed * 1e6 / calls,
+            "us");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Cost of a UI::get_stats() snapshot with 16 windows that have been written to
+//--------------------------------------------------------------------------------------------------
+static void bench_get_stats (UI& ui, const std::string& backend_name)
+{
+    const unsigned int window_count = 16;
+    const unsigned long int calls = iterations (20000);
+
+    make_tiled_windows (ui, window_count, false);
+    ui.write_to_all_windows ("Line of text", true);
+
+    unsigned long int total = 0;
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < calls; i++)
+        total += ui.get_stats().writes;
+
+    report ("stats/get_stats", backend_name, "microseconds_per_call",
+            seconds_since (start) * 1e6 / calls, "us");
+
+    // Printed nowhere, but stops the snapshots being thrown away
+    if (total == 1)
+        std::printf ("\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Tailing a log file into a window: an attached stream, which writes each read of the file as one
+// write, versus reading the file a line at a time and writing every line
+//--------------------------------------------------------------------------------------------------
+static void bench_tail (UI& ui, const std::string& backend_name, const bool& is_streamed)
+{
+    const unsigned long int lines = iterations (200000);
+    char path[] = "/tmp/ui_bench_tail_XXXXXX";
+    int descriptor = mkstemp (path);
+
+    if (descriptor < 0)
+        return;
+
+    FILE* file = fdopen (descriptor, "w+");
+
+    for (unsigned long int i = 0; i < lines; i++)
+        std::fprintf (file, "INFO  request %lu served, 200 OK\n", i);
+
+    std::fflush (file);
+    std::rewind (file);
+
+    ui.make_new_window (0, 0, 80, 24, "Tail", TextAlignment::left, TextWrap::word, 1000);
+
+    Clock::time_point start = Clock::now();
+
+    if (is_streamed)
+    {
+        ui.attach_stream (0, descriptor);
+
+        // The stream reads at most 1 MiB of a file at a time
+        while (ui.read_streams() > 0)
+            continue;
+
+        ui.detach_stream (0);
+    }
+    else
+    {
+        char line[256];
+
+        while (std::fgets (line, sizeof (line), file) != NULL)
+            ui.write_to_window (0, std::string_view (line, std::strlen (line) - 1), true);
+    }
+
+    report (is_streamed ? "tail/stream" : "tail/line_by_line", backend_name,
+            "nanoseconds_per_line", seconds_since (start) * 1e9 / lines, "ns");
+
+    std::fclose (file);
+    unlink (path);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Jumping around a ten million row table, which should cost the same wherever the row is
+//--------------------------------------------------------------------------------------------------
+static void bench_table_jump (UI& ui, const std::string& backend_name)
+{
+    const unsigned long int row_count = 10000000;
+    const unsigned long int jumps = iterations (20000);
+    const std::vector<unsigned int> column_widths = { 10, 30, 12 };
+
+    unsigned int window = ui.make_new_window (0, 0, 80, 40, "Table", false, 0);
+
+    ui.attach_table (window, column_widths, row_count,
+                     [] (const unsigned long int& row, const unsigned int& column)
+                     {
+                         return column == 1 ? std::string ("Row name") : std::to_string (row);
+                     });
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int i = 0; i < jumps; i++)
+        ui.jump_table_to_row (window, (i * 7919 * 104729) % row_count);
+
+    report ("table/jump_to_row", backend_name, "microseconds_per_jump",
+            seconds_since (start) * 1e6 / jumps, "us");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Bytes sent to the terminal per frame, where a frame writes one line to each of eight windows,
+// with and without batched refresh.  Returns the bytes per frame.
+// Notes: Each window is sent its own numbers.  Were every window sent the same ones, the rows of
+//        the two bands of windows would be identical, and nCurses only recognizes a scrolled line
+//        by it being unique on the screen, so batched frames would repaint every line instead of
+//        scrolling them.
+//--------------------------------------------------------------------------------------------------
+static double bench_bytes_per_frame (const bool& is_batched)
+{
+    const unsigned int window_count = 8;
+    const unsigned long int frames = iterations (2000);
+
+    HeadlessTerminal terminal;
+    UI ui (*terminal.backend);
+
+    make_tiled_windows (ui, window_count, false);
+    ui.set_batched_refresh (is_batched);
+
+    long int bytes_before = terminal.get_bytes_written();
+
+    for (unsigned long int frame = 0; frame < frames; frame++)
+    {
+        for (unsigned int window = 0; window < window_count; window++)
+            ui.write_to_window (window, (int) (frame * window_count + window), true);
+
+        ui.flush();
+    }
+
+    double bytes_per_frame = (double) (terminal.get_bytes_written() - bytes_before) / frames;
+
+    report (is_batched ? "frame/batched" : "frame/unbatched", "ncurses", "bytes_per_frame",
+            bytes_per_frame, "bytes");
+
+    return bytes_per_frame;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Bytes sent to the terminal per frame by a status panel that is redrawn in full every frame while
+// only one counter in it changes, either cleared and rewritten or drawn as a retained-mode frame
+//--------------------------------------------------------------------------------------------------
+static void bench_status_panel (const bool& is_retained)
+{
+    const unsigned long int frames = iterations (2000);
+    const unsigned int panel_lines = 8;
+
+    HeadlessTerminal terminal;
+    UI ui (*terminal.backend);
+
+    unsigned int panel = ui.make_new_window (0, 0, 60, panel_lines + 3, "Status", false, 0);
+
+    long int bytes_before = terminal.get_bytes_written();
+
+    for (unsigned long int frame = 0; frame < frames; frame++)
+    {
+        if (is_retained)
+            ui.begin_window_frame (panel);
+        else
+            ui.clear_window (panel);
+
+        for (unsigned int line = 0; line < panel_lines; line++)
+        {
+            ui.write_formatted (panel, line + 1 < panel_lines, "Worker %u: %lu requests served",
+                                line, line == 0 ? frame : 1000ul);
+        }
+
+        if (is_retained)
+            ui.end_window_frame (panel);
+    }
+
+    report (is_retained ? "status_panel/retained" : "status_panel/clear_and_rewrite", "ncurses",
+            "bytes_per_frame", (double) (terminal.get_bytes_written() - bytes_before) / frames,
+            "bytes");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Opening and closing a popup over sixteen windows full of text, by hiding and showing one popup
+// or by destroying it and making it again, in bytes sent to the terminal and time per cycle
+//--------------------------------------------------------------------------------------------------
+static void bench_popup (const bool& is_hidden)
+{
+    const unsigned int window_count = 16;
+    const unsigned long int cycles = iterations (2000);
+
+    HeadlessTerminal terminal;
+    UI ui (*terminal.backend);
+
+    make_tiled_windows (ui, window_count, false);
+
+    for (unsigned int window = 0; window < window_count; window++)
+        for (unsigned int line = 0; line < 20; line++)
+            ui.write_to_window (window, "A line of text that fills the window underneath", true);
+
+    const Layout popup_layout = make_percent_layout (25, 25, 50, 50);
+    unsigned int popup = ui.make_new_window (popup_layout, "Popup", true, 0);
+    ui.write_to_window (popup, "Are you sure?", true);
+
+    long int bytes_before = terminal.get_bytes_written();
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int cycle = 0; cycle < cycles; cycle++)
+    {
+        if (is_hidden)
+        {
+            ui.set_window_visible (popup, false);
+            ui.set_window_visible (popup, true);
+            continue;
+        }
+
+        ui.destroy_window (popup);
+        popup = ui.make_new_window (popup_layout, "Popup", true, 0);
+        ui.write_to_window (popup, "Are you sure?", true);
+    }
+
+    double elapsed = seconds_since (start);
+    const std::string name = is_hidden ? "popup/hide_and_show" : "popup/destroy_and_make";
+
+    report (name, "ncurses", "bytes_per_cycle",
+            (double) (terminal.get_bytes_written() - bytes_before) / cycles, "bytes");
+    report (name, "ncurses", "nanoseconds_per_cycle", elapsed * 1e9 / cycles, "ns");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Laying out fifty percentage-placed windows again after the terminal is resized, each window
+// rewrapping and redrawing a few hundred lines of history
+//--------------------------------------------------------------------------------------------------
+template <typename ResizeScreen>
+static void bench_relayout (UI& ui, const std::string& backend_name, ResizeScreen resize_screen)
+{
+    const unsigned int window_count = 50;
+    const unsigned long int relayouts = iterations (200);
+
+    for (unsigned int i = 0; i < window_count; i++)
+    {
+        unsigned int window = ui.make_new_window (make_percent_layout ((i % 10) * 10.0,
+                                                                       (i / 10) * 20.0, 10, 20),
+                                                  "", false, 500);
+
+        for (unsigned int line = 0; line < 300; line++)
+            ui.write_to_window (window, "A line of history to rewrap", true);
+    }
+
+    double elapsed = 0;
+
+    for (unsigned long int i = 0; i < relayouts; i++)
+    {
+        // Alternate between the full screen and a slightly smaller one
+        bool is_smaller = i % 2 == 0;
+        resize_screen (is_smaller ? screen_width - 10 : screen_width,
+                       is_smaller ? screen_height - 5 : screen_height);
+
+        Clock::time_point start = Clock::now();
+        ui.handle_resize();
+        elapsed += seconds_since (start);
+    }
+
+    report ("relayout/50_windows", backend_name, "milliseconds_per_relayout",
+            elapsed * 1e3 / relayouts, "ms");
+}
+
+//--------------------------------------------------------------------------------------------------
+// A telemetry tick of 500 updates spread over 16 windows, written one at a time or as one batch
+//--------------------------------------------------------------------------------------------------
+static void bench_write_batch (const bool& is_batch)
+{
+    const unsigned int window_count = 16;
+    const unsigned int updates_per_tick = 500;
+    const unsigned long int ticks = iterations (200);
+
+    HeadlessTerminal terminal;
+    UI ui (*terminal.backend);
+
+    make_tiled_windows (ui, window_count, false);
+
+    std::vector<std::string> texts;
+    std::vector<WriteOp> ops;
+
+    for (unsigned int i = 0; i < updates_per_tick; i++)
+        texts.push_back ("metric_" + std::to_string (i) + " = " + std::to_string (i * 31));
+
+    for (unsigned int i = 0; i < updates_per_tick; i++)
+        ops.push_back ({ i % window_count, texts[i], true });
+
+    long int bytes_before = terminal.get_bytes_written();
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int tick = 0; tick < ticks; tick++)
+    {
+        if (is_batch)
+            ui.write_batch (ops);
+        else
+        {
+            for (unsigned int i = 0; i < updates_per_tick; i++)
+                ui.write_to_window (ops[i].window_number, ops[i].text, ops[i].newline);
+        }
+    }
+
+    double elapsed = seconds_since (start);
+    std::string name = is_batch ? "tick/write_batch" : "tick/write_to_window";
+
+    report (name, "ncurses", "microseconds_per_tick", elapsed * 1e6 / ticks, "us");
+    report (name, "ncurses", "bytes_per_tick",
+            (double) (terminal.get_bytes_written() - bytes_before) / ticks, "bytes");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Measuring text in display columns against just taking its length in bytes, on lines of ASCII and
+// on lines that mix ASCII with accented, CJK and emoji characters
+//--------------------------------------------------------------------------------------------------
+static void bench_display_width (const bool& is_mixed)
+{
+    const unsigned long int passes = iterations (200000);
+    const std::string line = is_mixed
+        ? "status: r\u00e9sum\u00e9 \u4e2d\u6587 ok \U0001f600 load 0.42 \u65e5\u672c\u8a9e"
+        : "status: ok, load 0.42, 1024 requests served, 3 errors";
+
+    std::vector<std::string> lines (64, line);
+    unsigned long int total = 0;
+    std::size_t bytes = 0;
+
+    for (const std::string& text : lines)
+        bytes += text.length();
+
+    Clock::time_point start = Clock::now();
+
+    for (unsigned long int pass = 0; pass < passes / lines.size(); pass++)
+    {
+        for (const std::string& text : lines)
+            total += text.length();
+
+        // Keep the compiler from hoisting the lengths out of the loop
+        lines[pass % lines.size()][0] = (char) ('a' + total % 26);
+    }
+
+    double length_seconds = seconds_since (start);
+    start = Clock::now();
+
+    for (unsigned long int pass = 0; pass < passes / lines.size(); pass++)
+    {
+        for (const std::string& text : lines)
+            total += get_display_width (text.data(), text.length());
+
+        lines[pass % lines.size()][0] = (char) ('a' + total % 26);
+    }
+
+    double width_seconds = seconds_since (start);
+    double megabytes = (double) bytes * (passes / lines.size()) / 1e6;
+    std::string suffix = is_mixed ? "/mixed_utf8" : "/ascii";
+
+    report ("measure/byte_length" + suffix, "none", "megabytes_per_second",
+            megabytes / length_seconds, "MB/s");
+    report ("measure/display_width" + suffix, "none", "megabytes_per_second",
+            megabytes / width_seconds, "MB/s");
+
+    // Printed nowhere, but stops both loops being thrown away
+    if (total == 1)
+        std::printf ("\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Runs each benchmark on a fresh UI on both backends
+//--------------------------------------------------------------------------------------------------
+template <typename Benchmark>
+static void run_on_both_backends (Benchmark benchmark)
+{
+    {
+        HeadlessTerminal terminal;
+        UI ui (*terminal.backend);
+        benchmark (ui, "ncurses");
+    }
+
+    {
+        MemoryBackend screen (screen_width, screen_height);
+        UI ui (screen);
+        benchmark (ui, "memory");
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    if (argc > 1)
+        iteration_scale = std::atof (argv[1]);
+
+    // Make newterm() size its screen from these rather than from terminfo
+    setenv ("COLUMNS", std::to_string (screen_width).c_str(), 1);
+    setenv ("LINES", std::to_string (screen_height).c_str(), 1);
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_write_types (ui, backend_name);
+    });
+
+    const unsigned int window_counts[] = { 1, 2, 4, 8, 16 };
+
+    for (unsigned int window_count : window_counts)
+    {
+        run_on_both_backends ([window_count] (UI& ui, const std::string& backend_name)
+        {
+            bench_write_to_all_windows (ui, backend_name, window_count);
+        });
+    }
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_alignment (ui, backend_name, false);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_alignment (ui, backend_name, true);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_utf8_write (ui, backend_name);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_log_viewer (ui, backend_name, false);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_log_viewer (ui, backend_name, true);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_clear_all_windows (ui, backend_name);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_table_jump (ui, backend_name);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_get_stats (ui, backend_name);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_tail (ui, backend_name, false);
+    });
+
+    run_on_both_backends ([] (UI& ui, const std::string& backend_name)
+    {
+        bench_tail (ui, backend_name, true);
+    });
+
+    {
+        HeadlessTerminal terminal;
+        UI ui (*terminal.backend);
+
+        bench_relayout (ui, "ncurses", [] (const unsigned int& width, const unsigned int& height)
+        {
+            resizeterm (height, width);
+        });
+    }
+
+    {
+        MemoryBackend screen (screen_width, screen_height);
+        UI ui (screen);
+
+        bench_relayout (ui, "memory", [&screen] (const unsigned int& width,
+                                                 const unsigned int& height)
+        {
+            screen.resize_screen (width, height);
+            screen.discard_typeahead();
+        });
+    }
+
+    double unbatched_bytes = bench_bytes_per_frame (false);
+    double batched_bytes = bench_bytes_per_frame (true);
+    int exit_status = 0;
+
+    // Batching exists to send less, so sending more is a failure rather than just a slow result
+    if (batched_bytes > unbatched_bytes)
+    {
+        std::fprintf (stderr, "frame/batched sent %.3f bytes per frame, more than the %.3f of "
+                      "frame/unbatched\n", batched_bytes, unbatched_bytes);
+        exit_status = 1;
+    }
+
+    bench_write_batch (false);
+    bench_write_batch (true);
+    bench_status_panel (false);
+    bench_status_panel (true);
+    bench_popup (false);
+    bench_popup (true);
+    bench_display_width (false);
+    bench_display_width (true);
+
+    return exit_status;
+}
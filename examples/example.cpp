@@ -0,0 +1,47 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        example.cpp
+// Description: The large example from the README: three titled windows that each take live input
+//              until a '.' is typed
+// Notes:
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "UI.hpp"
+
+int main()
+{
+    // Declare UI object
+    UI ui;
+
+    // Helper ints to make changing this particular UI configuration simple
+    const unsigned int x = 1;
+    const unsigned int y = 1;
+    const unsigned int width = 30;
+    const unsigned int height = 20;
+    const unsigned int x_window_distance = 2;
+
+    // Make windows
+    // Note: window creation is a dynamic procedure
+    ui.make_new_window (x + (0 * (x_window_distance + width)), y, width, height, "Left Window", false);
+    ui.make_new_window (x + (1 * (x_window_distance + width)), y, width, height, "Middle Window", false);
+    ui.make_new_window (x + (2 * (x_window_distance + width)), y, width, height, "Right Window", false);
+
+    // Enumerations to make remembering a window easier
+    enum windows
+    {
+        left,
+        middle,
+        right,
+    };
+
+    ui.write_to_all_windows (std::to_string (ui.get_number_of_windows()), true);
+
+    // Random character used to break input loops and advance to the next window
+    const char input_break = '.';
+
+    // Live input into each of the windows
+    while (ui.live_input (left,   false) != input_break);
+    while (ui.live_input (middle, false) != input_break);
+    while (ui.live_input (right,  false) != input_break);
+}
@@ -0,0 +1,139 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Backend.hpp
+// Description: Abstract base classes for the rendering backend that Window draws through.  A
+//              Backend owns the screen and hands out Surfaces, rectangular areas of the screen that
+//              can be written to and refreshed.
+// Notes:       NcursesBackend is the default and draws to the terminal; MemoryBackend draws into an
+//              in-memory cell grid so the library can run headless.
+//
+//              Surfaces follow nCurses' rules for writing: text is written at the cursor, a '\n'
+//              clears the rest of the line and moves to the next one, text wraps at the right edge,
+//              and a surface with scrolling turned on scrolls up when the cursor moves past its
+//              last line.  Nothing written to a surface is guaranteed to reach the screen until the
+//              surface is refreshed, or staged and then the Backend is updated.
+//
+//              Surfaces are stacked, each new one on top of the rest, and a surface only shows
+//              where no visible surface above it covers it, however they are refreshed.  Hiding,
+//              raising, lowering, moving or destroying a surface only repaints the part of the
+//              screen it uncovers, and only at the next Backend::update().
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Backend_hpp
+#define Backend_hpp
+
+#include <cstddef>
+#include <memory>
+#include "Style.hpp"
+
+// Returned by read_key() when there is no key to return
+const int no_key = -1;
+
+// Returned by read_key() for keys that aren't characters.  Characters are returned as themselves,
+// from 0 to 255, and the backspace key is always key_backspace whatever the terminal sends for it.
+const int key_up = 0x100;
+const int key_down = 0x101;
+const int key_left = 0x102;
+const int key_right = 0x103;
+const int key_home = 0x104;
+const int key_end = 0x105;
+const int key_page_up = 0x106;
+const int key_page_down = 0x107;
+const int key_insert = 0x108;
+const int key_delete = 0x109;
+const int key_backspace = 0x10A;
+const int key_resize = 0x10B;
+const int key_function_1 = 0x110; // F1 to F12 are key_function_1 to key_function_1 + 11
+const int key_unknown = 0x1FF;
+
+class Surface
+{
+public:
+    virtual ~Surface() {}
+
+    virtual void put_text (const char* text, const std::size_t& length) = 0;
+    virtual void put_text_at (const unsigned int& row, const unsigned int& column,
+                              const char* text, const std::size_t& length) = 0;
+    virtual void move_cursor (const unsigned int& row, const unsigned int& column) = 0;
+    virtual unsigned int get_cursor_row() = 0;
+    virtual unsigned int get_cursor_column() = 0;
+
+    virtual unsigned int get_width() = 0;
+    virtual unsigned int get_height() = 0;
+
+    // Moves the surface to (x, y) on the screen and changes its size.  What it showed is lost.
+    virtual void move_and_resize (const unsigned int& x, const unsigned int& y,
+                                  const unsigned int& width, const unsigned int& height) = 0;
+
+    virtual void set_scrolling (const bool& scrolling) = 0;
+
+    // Text written from now on is drawn in style.  Asking for the style already in use does
+    // nothing, so a run of text in one style costs one switch however it is written.
+    virtual void set_style (const Style& style) = 0;
+    virtual void draw_border() = 0;
+
+    // erase_surface() blanks the surface; clear_surface() also forces the whole surface to be
+    // repainted
+    virtual void erase_surface() = 0;
+    virtual void clear_surface() = 0;
+    virtual void touch_surface() = 0;
+
+    // refresh_surface() sends the surface to the screen now; stage_surface() only queues it for
+    // Backend::update()
+    virtual void refresh_surface() = 0;
+    virtual void stage_surface() = 0;
+
+    // A hidden surface keeps what was written to it but covers nothing.  Showing a surface puts it
+    // on top of the stack, like raise_surface().
+    virtual void set_visible (const bool& visible) = 0;
+    virtual bool get_visible() = 0;
+    virtual void raise_surface() = 0;
+    virtual void lower_surface() = 0;
+
+    // A pad surface is larger than the area of the screen it shows, its view.  The view shows the
+    // pad from (row, column), moved only as far as keeps the view inside the pad.  Other surfaces
+    // always show all of themselves from (0, 0).
+    virtual void set_view_origin (const unsigned int& row, const unsigned int& column) = 0;
+    virtual unsigned int get_view_row() = 0;
+    virtual unsigned int get_view_column() = 0;
+
+    virtual int read_key() = 0;
+};
+
+class Backend
+{
+public:
+    virtual ~Backend() {}
+
+    virtual std::unique_ptr<Surface> make_surface (const unsigned int& x, const unsigned int& y,
+                                                   const unsigned int& width,
+                                                   const unsigned int& height) = 0;
+
+    // Makes a pad surface width by height cells, shown through a view_width by view_height area of
+    // the screen at (x, y).  move_and_resize() moves and resizes the view and keeps the pad's size.
+    virtual std::unique_ptr<Surface> make_pad_surface (const unsigned int& x, const unsigned int& y,
+                                                       const unsigned int& view_width,
+                                                       const unsigned int& view_height,
+                                                       const unsigned int& width,
+                                                       const unsigned int& height) = 0;
+
+    // Sends everything staged since the last update to the screen at once
+    virtual void update() = 0;
+
+    // The size of the whole screen, which changes when the terminal is resized
+    virtual unsigned int get_screen_width() = 0;
+    virtual unsigned int get_screen_height() = 0;
+
+    // read_key() waits for a key; poll_key() waits at most timeout_milliseconds and returns no_key
+    // if none arrived, so a timeout of 0 only returns keys that have already been typed
+    virtual int read_key() = 0;
+    virtual int poll_key (const unsigned int& timeout_milliseconds) = 0;
+    virtual void discard_typeahead() = 0;
+
+    // The file descriptor keys are read from, so the UI can wait for keys and other descriptors
+    // with one poll(), or -1 if keys don't come from a descriptor
+    virtual int get_input_descriptor() = 0;
+};
+
+#endif /* Backend_hpp */
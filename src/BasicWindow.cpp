@@ -0,0 +1,73 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        BasicWindow.cpp
+// Description: A Window whose alignment, wrapping and refresh policies are chosen at compile time,
+//              and the write path that those policies are built into.
+// Notes:       make_window() is the one place that turns the run time choice of policies into a
+//              BasicWindow type; everything after it only sees a Window.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <new>
+#include "BasicWindow.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Makes a window aligned by AlignPolicy and wrapped however wrap asks for
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy>
+static Window* make_aligned_window (const unsigned int& x, const unsigned int& y,
+                                    const unsigned int& width, const unsigned int& height,
+                                    const std::string& window_title, const TextWrap& wrap,
+                                    const unsigned int& history_capacity, Backend& backend,
+                                    const unsigned int& pad_width, const unsigned int& pad_height)
+{
+    switch (wrap)
+    {
+        case TextWrap::word:
+            return new (std::nothrow) BasicWindow<AlignPolicy, WordWrap> (
+                x, y, width, height, window_title, history_capacity, backend, pad_width,
+                pad_height);
+
+        case TextWrap::truncate:
+            return new (std::nothrow) BasicWindow<AlignPolicy, Truncate> (
+                x, y, width, height, window_title, history_capacity, backend, pad_width,
+                pad_height);
+
+        default:
+            return new (std::nothrow) BasicWindow<AlignPolicy, CharacterWrap> (
+                x, y, width, height, window_title, history_capacity, backend, pad_width,
+                pad_height);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Makes a window with the policies named by alignment and wrap, refreshing as configured
+//         by set_deferred_refresh().  A pad_width or pad_height above 0 draws the text on a pad of
+//         that size, of which the window shows a part.  Returns NULL if the window couldn't be
+//         allocated.
+//--------------------------------------------------------------------------------------------------
+Window* make_window (const unsigned int& x, const unsigned int& y,
+                     const unsigned int& width, const unsigned int& height,
+                     const std::string& window_title, const TextAlignment& alignment,
+                     const TextWrap& wrap, const unsigned int& history_capacity,
+                     Backend& backend, const unsigned int& pad_width,
+                     const unsigned int& pad_height)
+{
+    switch (alignment)
+    {
+        case TextAlignment::center:
+            return make_aligned_window<CenterAlign> (x, y, width, height, window_title, wrap,
+                                                     history_capacity, backend, pad_width,
+                                                     pad_height);
+
+        case TextAlignment::right:
+            return make_aligned_window<RightAlign> (x, y, width, height, window_title, wrap,
+                                                    history_capacity, backend, pad_width,
+                                                    pad_height);
+
+        default:
+            return make_aligned_window<LeftAlign> (x, y, width, height, window_title, wrap,
+                                                   history_capacity, backend, pad_width,
+                                                   pad_height);
+    }
+}
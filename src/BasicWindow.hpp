@@ -0,0 +1,466 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        BasicWindow.hpp
+// Description: A Window whose alignment, wrapping and refresh policies are chosen at compile time,
+//              and the write path that those policies are built into.
+// Notes:       The write path is a template, so every BasicWindow gets its own copy with the
+//              policies inlined and no branching on them left.  The UI only ever holds a Window,
+//              so code that goes through the UI keeps a single virtual call per write, while code
+//              that holds a BasicWindow of a known type calls the write path directly.
+//
+//              BasicWindow<CenterAlign, WordWrap> window (x, y, width, height, "Title", 1000,
+//                                                     backend);
+//
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef BasicWindow_hpp
+#define BasicWindow_hpp
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Backend.hpp"
+#include "TextPolicy.hpp"
+#include "Window.hpp"
+
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy = ConfiguredRefresh>
+class BasicWindow final : public Window
+{
+private:
+    void write_definition (const char* text, const std::size_t& length,
+                           const bool& newline) override;
+    void write_spans_definition (const char* text, const std::size_t& length,
+                                 const StyleSpan* spans, const std::size_t& span_count,
+                                 const bool& newline) override;
+    void rewrap_history() override;
+
+public:
+    BasicWindow (const unsigned int& x, const unsigned int& y,
+                 const unsigned int& width, const unsigned int& height,
+                 const std::string& window_title, const unsigned int& history_capacity,
+                 Backend& backend_input, const unsigned int& pad_width = 0,
+                 const unsigned int& pad_height = 0);
+
+    // The text overloads skip the virtual call; the number and styled overloads go through Window
+    using Window::write;
+    void write (const char* text, const std::size_t& length, const bool& newline);
+    void write (const char* text, const bool& newline);
+    void write (const std::string_view& text, const bool& newline);
+    void write (const std::string& text, const bool& newline);
+};
+
+// Makes a window with the policies named at run time, or returns NULL if it couldn't be allocated
+Window* make_window (const unsigned int& x, const unsigned int& y,
+                     const unsigned int& width, const unsigned int& height,
+                     const std::string& window_title, const TextAlignment& alignment,
+                     const TextWrap& wrap, const unsigned int& history_capacity,
+                     Backend& backend, const unsigned int& pad_width = 0,
+                     const unsigned int& pad_height = 0);
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the line pieces WrapPolicy breaks the text into, starting at column of a line
+//          width columns wide.  Text laid out the same way not long ago is found in the line break
+//          cache instead of being measured again.
+//--------------------------------------------------------------------------------------------------
+template <typename WrapPolicy>
+const std::vector<LinePiece>& Window::get_line_pieces (const char* text,
+                                                       const std::size_t& length,
+                                                       unsigned int column,
+                                                       const unsigned int& width)
+{
+    // An empty line has no pieces, and shouldn't take a cache entry from one that has
+    if (length == 0)
+    {
+        long_text_pieces.clear();
+        return long_text_pieces;
+    }
+
+    std::vector<LinePiece>* pieces = line_breaks.find (text, length, column, width,
+                                                       WrapPolicy::wrap);
+
+    if (pieces != NULL)
+        return *pieces;
+
+    pieces = line_breaks.insert (text, length, column, width, WrapPolicy::wrap);
+
+    if (pieces == NULL)
+    {
+        pieces = &long_text_pieces;
+        pieces->clear();
+    }
+
+    std::size_t position = 0;
+
+    while (position < length)
+    {
+        LinePiece piece;
+        piece.start = position;
+
+        WrapPolicy::get_piece (text + position, length - position, column, width, piece);
+        pieces->push_back (piece);
+
+        position += piece.length + piece.skip;
+        column = piece.line_break != LineBreak::none ? 0 : (column + piece.columns) % width;
+    }
+
+    return *pieces;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Lays the line pieces of the text out into target, aligning each one on its line with
+//          AlignPolicy, and draws them on surface too unless it is NULL.  Returns whether the last
+//          piece filled its line to the edge.
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy>
+bool Window::put_line_pieces (History& target, Surface* surface, const char* text,
+                              const StyleSpan* spans, const std::size_t& span_count,
+                              const std::vector<LinePiece>& pieces, unsigned int column,
+                              const unsigned int& width)
+{
+    bool is_line_full = false;
+
+    for (const LinePiece& piece : pieces)
+    {
+        if (piece.length > 0 || piece.has_ellipsis)
+        {
+            unsigned int columns = piece.columns + (piece.has_ellipsis ? ellipsis_columns : 0);
+
+            // Align by moving the cursor rather than by building a padded copy of the text
+            unsigned int offset = AlignPolicy::get_offset (columns, column, width);
+
+            target.append_padding (offset);
+
+            if (surface != NULL && offset > 0)
+                surface->move_cursor (surface->get_cursor_row(), column + offset);
+
+            // Text is written raw; it is never treated as a printf format.  The ellipsis takes
+            // the style of the text it follows.
+            Style style = put_styled_text (target, surface, text, piece.start, piece.length,
+                                           spans, span_count);
+
+            if (piece.has_ellipsis)
+                target.append (ellipsis, ellipsis_length, style);
+
+            if (surface != NULL)
+            {
+                if (piece.has_ellipsis)
+                {
+                    if (span_count > 0)
+                        surface->set_style (style);
+
+                    surface->put_text (ellipsis, ellipsis_length);
+                }
+
+                bytes_written += piece.length + (piece.has_ellipsis ? ellipsis_length : 0);
+            }
+
+            // A wide character with one column left wraps early, so the history, which wraps
+            // exactly as the backend does, knows the column better than the arithmetic
+            if (target.get_capacity() > 0)
+                column = target.get_current_line_columns();
+            else
+                column = (column + offset + columns) % width;
+
+            is_line_full = column == 0;
+        }
+
+        if (piece.line_break == LineBreak::hard)
+            put_line_break (target, surface, LineEnd::line_break, is_line_full);
+        else if (piece.line_break == LineBreak::soft)
+            put_line_break (target, surface, piece.skip > 0 ? LineEnd::word_wrap : LineEnd::wrap,
+                            is_line_full);
+
+        if (piece.line_break != LineBreak::none)
+        {
+            column = 0;
+            is_line_full = false;
+        }
+    }
+
+    return is_line_full;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Protected: Writes text into the window the way the policies lay it out, with the parts covered
+//            by spans drawn in their styles.  The wrap policy breaks the text into line pieces, the
+//            alignment policy places each piece on its line, and the refresh policy decides how
+//            the finished write reaches the screen.  Tabs and other control characters are
+//            expanded first, so they are measured as the columns nCurses would draw them in.
+// Notes:     While the user is scrolled back, the view stays pinned to the same lines and the text
+//            is only recorded; it is drawn once the window is scrolled back down to it.  A frame
+//            always replaces the whole view, so it is drawn regardless.
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void Window::write_with_policies (const char* text, const std::size_t& length,
+                                  const StyleSpan* spans, const std::size_t& span_count,
+                                  const bool& newline)
+{
+    Surface& surface = get_drawing_surface();
+
+    counters.writes.add (1);
+    counters.bytes_written.add (length);
+
+    // A latest value window only ever shows its most recent write
+    if (is_latest_value_only)
+    {
+        history.clear();
+        scroll_offset = 0;
+        surface.erase_surface();
+    }
+
+    unsigned int lines_before = history.get_line_count();
+    unsigned int width = get_width();
+
+    if (width == 0)
+        return;
+
+    bool is_drawn = scroll_offset == 0 || is_in_frame;
+    Surface* drawing_surface = is_drawn ? &surface : NULL;
+
+    // While the user is scrolled back the surface's cursor isn't kept up to date, so ask the
+    // history where the line ends instead
+    unsigned int column = is_drawn ? surface.get_cursor_column()
+                                   : history.get_current_line_columns();
+
+    const char* layout_text = text;
+    std::size_t layout_length = length;
+    const StyleSpan* layout_spans = spans;
+
+    if (has_control_characters (text, length))
+    {
+        expand_control_characters (text, length, column, width, expanded_text,
+                                   expanded_positions);
+        expanded_spans.assign (spans, spans + span_count);
+
+        for (StyleSpan& span : expanded_spans)
+        {
+            std::size_t span_end = expanded_positions[span.start + span.length];
+
+            span.start = expanded_positions[span.start];
+            span.length = span_end - span.start;
+        }
+
+        layout_text = expanded_text.data();
+        layout_length = expanded_text.size();
+        layout_spans = expanded_spans.data();
+    }
+
+    const std::vector<LinePiece>& pieces = get_line_pieces<WrapPolicy> (layout_text,
+                                                                        layout_length, column,
+                                                                        width);
+    bool is_line_full = put_line_pieces<AlignPolicy> (history, drawing_surface, layout_text,
+                                                      layout_spans, span_count, pieces, column,
+                                                      width);
+
+    // Leave the surface plain, so plain writes never need to switch style
+    if (span_count > 0 && is_drawn)
+        surface.set_style (plain_style);
+
+    if (newline)
+        put_line_break (history, drawing_surface, LineEnd::line_break, is_line_full);
+
+    if (! is_drawn)
+    {
+        scroll_offset += history.get_line_count() - lines_before;
+
+        if (scroll_offset > get_max_scroll_offset())
+            scroll_offset = get_max_scroll_offset();
+
+        return;
+    }
+
+    // Inside a frame nothing reaches the screen until end_frame()
+    if (is_in_frame)
+        return;
+
+    is_previous_frame_valid = false;
+
+    if constexpr (RefreshPolicy::mode == RefreshMode::immediate)
+        refresh_text_surface();
+    else if constexpr (RefreshPolicy::mode == RefreshMode::deferred)
+    {
+        is_dirty = true;
+        deferred_refresh_count++;
+    }
+    else
+        refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Protected: Lays the history out again at the window's current width.  Each line written is put
+//            back together from the stored lines it was wrapped into, without their alignment
+//            padding, and then aligned and wrapped afresh.  Nothing is done if the width is the
+//            same, so a window that only moves keeps its lines exactly as they are.
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy>
+void Window::rewrap_with_policies()
+{
+    unsigned int width = get_width();
+
+    if (width == 0 || width == history.get_line_width())
+        return;
+
+    History rewrapped (history.get_capacity(), width);
+    std::string line;
+    std::vector<StyleSpan> line_spans;
+    std::size_t wrap_space = std::string::npos;
+    bool is_styled = history.has_styles();
+    unsigned int line_count = history.get_line_count();
+    unsigned int length = 0;
+
+    for (unsigned int i = 0; i < line_count; i++)
+    {
+        const char* text = history.get_line (i, length);
+        const unsigned char* style_ids = history.get_line_style_ids (i);
+        unsigned int padding = history.get_line_padding (i);
+        LineEnd line_end = history.get_line_end (i);
+
+        // Turn the style of each byte back into spans, joining runs split by a wrap.  The space a
+        // word wrap dropped joins them too when the text on both sides of it is in one style.
+        for (unsigned int j = padding; is_styled && j < length; j++)
+        {
+            if (style_ids[j] == 0)
+                continue;
+
+            const Style& style = history.get_style (style_ids[j]);
+            std::size_t position = line.size() + j - padding;
+
+            if (! line_spans.empty() && line_spans.back().style == style)
+            {
+                std::size_t span_end = line_spans.back().start + line_spans.back().length;
+
+                if (span_end == position || (span_end == wrap_space && position == span_end + 1))
+                {
+                    line_spans.back().length += position + 1 - span_end;
+                    continue;
+                }
+            }
+
+            line_spans.push_back ({ position, 1, style });
+        }
+
+        if (padding < length)
+            line.append (text + padding, length - padding);
+
+        if (line_end == LineEnd::word_wrap)
+        {
+            wrap_space = line.size();
+            line.push_back (' ');
+        }
+
+        if (line_end != LineEnd::line_break && i + 1 < line_count)
+            continue;
+
+        const std::vector<LinePiece>& pieces = get_line_pieces<WrapPolicy> (line.data(),
+                                                                            line.size(), 0,
+                                                                            width);
+        bool is_line_full = put_line_pieces<AlignPolicy> (rewrapped, NULL, line.data(),
+                                                          line_spans.data(), line_spans.size(),
+                                                          pieces, 0, width);
+
+        if (i + 1 < line_count)
+            put_line_break (rewrapped, NULL, LineEnd::line_break, is_line_full);
+
+        line.clear();
+        line_spans.clear();
+        wrap_space = std::string::npos;
+    }
+
+    history.swap (rewrapped);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Write definition provides the required definition for the private virtual pure function
+//          of the Write base class, for writes made through a Window or through Write's number
+//          overloads
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write_definition (
+    const char* text, const std::size_t& length, const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text, length, NULL, 0, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Provides Window's styled write path, for writes made through Window::write_spans() and
+//          the styled Window::write() overloads
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write_spans_definition (
+    const char* text, const std::size_t& length, const StyleSpan* spans,
+    const std::size_t& span_count, const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text, length, spans, span_count,
+                                                                 newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Lays the history out again with this window's alignment and wrapping
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::rewrap_history()
+{
+    rewrap_with_policies<AlignPolicy, WrapPolicy>();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Makes a window whose text is laid out by AlignPolicy and WrapPolicy, on a
+//         pad of pad_width by pad_height if either is above 0
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::BasicWindow (
+    const unsigned int& x, const unsigned int& y, const unsigned int& width,
+    const unsigned int& height, const std::string& window_title,
+    const unsigned int& history_capacity, Backend& backend_input, const unsigned int& pad_width,
+    const unsigned int& pad_height)
+    : Window (x, y, width, height, window_title, AlignPolicy::alignment, history_capacity,
+              backend_input, pad_width, pad_height)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes length characters of text, calling the write path directly
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write (
+    const char* text, const std::size_t& length, const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text, length, NULL, 0, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a null terminated string, calling the write path directly
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write (const char* text,
+                                                                 const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text, std::strlen (text), NULL,
+                                                                 0, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a string view, calling the write path directly
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write (const std::string_view& text,
+                                                                 const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text.data(), text.size(), NULL,
+                                                                 0, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a string, calling the write path directly
+//--------------------------------------------------------------------------------------------------
+template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+void BasicWindow<AlignPolicy, WrapPolicy, RefreshPolicy>::write (const std::string& text,
+                                                                 const bool& newline)
+{
+    write_with_policies<AlignPolicy, WrapPolicy, RefreshPolicy> (text.data(), text.size(), NULL,
+                                                                 0, newline);
+}
+
+#endif /* BasicWindow_hpp */
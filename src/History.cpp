@@ -0,0 +1,438 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        History.cpp
+// Description: A fixed-capacity ring buffer of text lines used by Window to remember everything
+//              that has been written to it, so it can be scrolled back through later.
+// Notes:       Every line is given a slot of the same size, and the oldest line is simply
+//              overwritten once the buffer is full.  Slots start out with one byte per column,
+//              enough for ASCII; the first line that needs more grows every slot at once, to two
+//              and then at most four bytes per column, so appending text only allocates a couple
+//              of times in the life of a history.  Lines remember how they ended and how much
+//              alignment padding they start with, so the window can take the text apart and lay it
+//              out again when it changes width.  Once anything styled is appended, every byte also
+//              keeps a one byte id of the style it was written in, which indexes a small table of
+//              the styles this history has seen.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "History.hpp"
+#include "TextLayout.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the id of a style, adding it to the table the first time it is seen.  Writes
+//          tend to come in the same style as the one before, so that is checked first.
+//--------------------------------------------------------------------------------------------------
+unsigned char History::get_style_id (const Style& style)
+{
+    if (styles[last_style_id] == style)
+        return last_style_id;
+
+    for (std::size_t i = 0; i < styles.size(); i++)
+    {
+        if (styles[i] == style)
+        {
+            last_style_id = (unsigned char) i;
+            return last_style_id;
+        }
+    }
+
+    if (styles.size() == max_history_styles)
+        return 0;
+
+    styles.push_back (style);
+    last_style_id = (unsigned char) (styles.size() - 1);
+
+    return last_style_id;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Converts a line number (0 being the oldest line still stored) to its slot in the ring
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_slot (const unsigned int& line)
+{
+    return (first_line + line) % capacity;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the number of bytes set aside for each line
+//--------------------------------------------------------------------------------------------------
+std::size_t History::get_slot_size()
+{
+    return (std::size_t) line_width * bytes_per_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Doubles the bytes every slot has per column until a slot holds bytes_needed, or until
+//          it can hold a line of the widest UTF-8 characters, moving each line into its new slot
+//--------------------------------------------------------------------------------------------------
+void History::grow_slots (const std::size_t& bytes_needed)
+{
+    std::size_t slot_size = get_slot_size();
+    unsigned int new_bytes_per_column = bytes_per_column;
+
+    while (new_bytes_per_column < max_bytes_per_column
+           && (std::size_t) line_width * new_bytes_per_column < bytes_needed)
+        new_bytes_per_column *= 2;
+
+    if (new_bytes_per_column == bytes_per_column)
+        return;
+
+    std::size_t new_slot_size = (std::size_t) line_width * new_bytes_per_column;
+    std::vector<char> new_cells (capacity * new_slot_size);
+    std::vector<unsigned char> new_style_ids (line_style_ids.empty() ? 0 : new_cells.size(), 0);
+
+    for (unsigned int slot = 0; slot < capacity; slot++)
+    {
+        std::memcpy (&new_cells[slot * new_slot_size], &line_cells[slot * slot_size],
+                     line_lengths[slot]);
+
+        if (! new_style_ids.empty())
+        {
+            std::memcpy (&new_style_ids[slot * new_slot_size], &line_style_ids[slot * slot_size],
+                         line_lengths[slot]);
+        }
+    }
+
+    line_cells.swap (new_cells);
+    line_style_ids.swap (new_style_ids);
+    bytes_per_column = new_bytes_per_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Moves on to a new, empty current line, overwriting the oldest line if the ring is full
+//--------------------------------------------------------------------------------------------------
+void History::start_new_line()
+{
+    if (line_count < capacity)
+        line_count++;
+    else
+        first_line = (first_line + 1) % capacity;
+
+    unsigned int slot = get_slot (line_count - 1);
+    line_lengths[slot] = 0;
+    line_columns[slot] = 0;
+    line_ends[slot] = LineEnd::line_break;
+    line_paddings[slot] = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Preallocates room for capacity_input lines of line_width_input columns of
+//         ASCII.  A capacity of zero disables the history entirely.
+//--------------------------------------------------------------------------------------------------
+History::History (const unsigned int& capacity_input, const unsigned int& line_width_input)
+    : capacity (capacity_input), line_width (line_width_input), bytes_per_column (1),
+      line_cells ((std::size_t) capacity_input * line_width_input),
+      line_lengths (capacity_input, 0), line_columns (capacity_input, 0),
+      line_ends (capacity_input, LineEnd::line_break),
+      line_paddings (capacity_input, 0), last_style_id (0)
+{
+    // Id 0 is always plain text
+    styles.reserve (max_history_styles);
+    styles.push_back (plain_style);
+
+    clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Appends text in style exactly the way nCurses lays it out in a scrolling window: a '\n'
+//         ends the current line, a line that reaches the window's width wraps onto the next one,
+//         and a wide character with only one column left wraps before it is written.
+//--------------------------------------------------------------------------------------------------
+void History::append (const char* text, const std::size_t& length, const Style& style)
+{
+    if (capacity == 0 || line_width == 0)
+        return;
+
+    std::size_t slot_size = get_slot_size();
+    unsigned char style_id = get_style_id (style);
+    std::size_t i = 0;
+
+    // Plain text needs no style ids, so they only take up memory once styled text arrives
+    if (style_id != 0 && line_style_ids.empty())
+        line_style_ids.assign (line_cells.size(), 0);
+
+    while (i < length)
+    {
+        if (text[i] == '\n')
+        {
+            start_new_line();
+            i++;
+            continue;
+        }
+
+        unsigned int slot = get_slot (line_count - 1);
+
+        // Copy a run of ASCII up to the end of the line in one go
+        if ((unsigned char) text[i] < 0x80)
+        {
+            std::size_t column_room = line_width - line_columns[slot];
+
+            if (slot_size - line_lengths[slot] < column_room)
+            {
+                grow_slots (line_lengths[slot] + column_room);
+                slot_size = get_slot_size();
+            }
+
+            std::size_t room = std::min<std::size_t> (column_room, slot_size - line_lengths[slot]);
+            std::size_t run = 0;
+
+            // Only a line padded out to the last byte with combining marks has no room left
+            if (room == 0)
+            {
+                line_ends[slot] = LineEnd::wrap;
+                start_new_line();
+                continue;
+            }
+
+            while (run < room && i + run < length && (unsigned char) text[i + run] < 0x80 &&
+                   text[i + run] != '\n')
+                run++;
+
+            std::memcpy (&line_cells[slot * slot_size + line_lengths[slot]], text + i, run);
+
+            if (! line_style_ids.empty())
+            {
+                std::memset (&line_style_ids[slot * slot_size + line_lengths[slot]], style_id,
+                             run);
+            }
+
+            line_lengths[slot] += run;
+            line_columns[slot] += run;
+            i += run;
+
+            if (line_columns[slot] == line_width)
+            {
+                line_ends[slot] = LineEnd::wrap;
+                start_new_line();
+            }
+
+            continue;
+        }
+
+        char32_t code_point;
+        std::size_t size = decode_utf8 (text + i, length - i, code_point);
+        unsigned int columns = get_character_width (code_point);
+
+        if (columns > line_width)
+        {
+            i += size;
+            continue;
+        }
+
+        if (line_columns[slot] + columns > line_width)
+        {
+            line_ends[slot] = LineEnd::wrap;
+            start_new_line();
+            slot = get_slot (line_count - 1);
+        }
+
+        if (line_lengths[slot] + size > slot_size)
+        {
+            grow_slots (line_lengths[slot] + size);
+            slot_size = get_slot_size();
+        }
+
+        // Only a long run of combining marks can run out of bytes before columns; the extra marks
+        // are dropped
+        if (line_lengths[slot] + size <= slot_size)
+        {
+            std::memcpy (&line_cells[slot * slot_size + line_lengths[slot]], text + i, size);
+
+            if (! line_style_ids.empty())
+            {
+                std::memset (&line_style_ids[slot * slot_size + line_lengths[slot]], style_id,
+                             size);
+            }
+
+            line_lengths[slot] += size;
+            line_columns[slot] += columns;
+        }
+
+        i += size;
+
+        if (line_columns[slot] == line_width)
+        {
+            line_ends[slot] = LineEnd::wrap;
+            start_new_line();
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Appends count spaces of alignment padding without needing a padded copy of the text that
+//         follows them.  Padding at the start of a line is remembered so it can be told apart from
+//         the text; anywhere else it is simply spaces.
+//--------------------------------------------------------------------------------------------------
+void History::append_padding (const unsigned int& count)
+{
+    if (count == 0 || capacity == 0 || line_width == 0)
+        return;
+
+    unsigned int slot = get_slot (line_count - 1);
+
+    if (line_columns[slot] == 0 && count < line_width)
+        line_paddings[slot] = count;
+
+    for (unsigned int i = 0; i < count; i++)
+        append (" ", 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Ends the current line before it reaches the width, the way line_end says it ended
+//--------------------------------------------------------------------------------------------------
+void History::end_line (const LineEnd& line_end)
+{
+    if (capacity == 0 || line_width == 0)
+        return;
+
+    line_ends[get_slot (line_count - 1)] = line_end;
+    start_new_line();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Records how the line before the current one ended, for a break that falls exactly where
+//         that line wrapped at the width.  Nothing moves, since the current line is already a new
+//         one, but a line break there now keeps the lines separate when the text is laid out again.
+//--------------------------------------------------------------------------------------------------
+void History::end_line_at_wrap (const LineEnd& line_end)
+{
+    if (line_count < 2 || get_current_line_columns() > 0)
+        return;
+
+    line_ends[get_slot (line_count - 2)] = line_end;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Forgets all stored lines, leaving a single empty current line
+//--------------------------------------------------------------------------------------------------
+void History::clear()
+{
+    first_line = 0;
+    line_count = 0;
+
+    if (capacity > 0)
+    {
+        line_count = 1;
+        line_lengths[0] = 0;
+        line_columns[0] = 0;
+        line_ends[0] = LineEnd::line_break;
+        line_paddings[0] = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Trades contents with another history of the same capacity, such as one the window has
+//         just laid its text out into at a new width
+//--------------------------------------------------------------------------------------------------
+void History::swap (History& other)
+{
+    if (other.capacity != capacity)
+        return;
+
+    std::swap (line_width, other.line_width);
+    std::swap (bytes_per_column, other.bytes_per_column);
+    line_cells.swap (other.line_cells);
+    line_style_ids.swap (other.line_style_ids);
+    line_lengths.swap (other.line_lengths);
+    line_columns.swap (other.line_columns);
+    line_ends.swap (other.line_ends);
+    line_paddings.swap (other.line_paddings);
+    std::swap (first_line, other.first_line);
+    std::swap (line_count, other.line_count);
+    styles.swap (other.styles);
+    std::swap (last_style_id, other.last_style_id);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of lines stored, including the current (possibly empty) line
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_line_count()
+{
+    return line_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of columns filled on the current (newest) line
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_current_line_columns()
+{
+    if (line_count == 0)
+        return 0;
+
+    return line_columns[get_slot (line_count - 1)];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the maximum number of lines that can be stored
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_capacity()
+{
+    return capacity;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of columns a line can hold before it wraps
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_line_width()
+{
+    return line_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the UTF-8 text of the requested line (0 being the oldest) and sets length to the
+//         number of bytes in it.  The text is not null terminated.
+//--------------------------------------------------------------------------------------------------
+const char* History::get_line (const unsigned int& line, unsigned int& length)
+{
+    unsigned int slot = get_slot (line);
+    length = line_lengths[slot];
+    return &line_cells[slot * get_slot_size()];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the style ids of the requested line's bytes, one for each byte get_line()
+//         returns, or NULL while everything appended has been plain (see has_styles())
+//--------------------------------------------------------------------------------------------------
+const unsigned char* History::get_line_style_ids (const unsigned int& line)
+{
+    if (line_style_ids.empty())
+        return NULL;
+
+    return &line_style_ids[get_slot (line) * get_slot_size()];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the style a style id stands for
+//--------------------------------------------------------------------------------------------------
+const Style& History::get_style (const unsigned char& style_id)
+{
+    return styles[style_id];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether anything other than plain text has been appended since the history was
+//         made, so readers of a history that is all plain can skip its style ids
+//--------------------------------------------------------------------------------------------------
+bool History::has_styles()
+{
+    return styles.size() > 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how the requested line ended.  The current line always reads as a line break.
+//--------------------------------------------------------------------------------------------------
+LineEnd History::get_line_end (const unsigned int& line)
+{
+    return line_ends[get_slot (line)];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many spaces of alignment padding the requested line starts with
+//--------------------------------------------------------------------------------------------------
+unsigned int History::get_line_padding (const unsigned int& line)
+{
+    return line_paddings[get_slot (line)];
+}
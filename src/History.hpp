@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        History.hpp
+// Description: A fixed-capacity ring buffer of text lines used by Window to remember everything
+//              that has been written to it, so it can be scrolled back through later.
+// Notes:       Every line is given a slot of the same size, and the oldest line is simply
+//              overwritten once the buffer is full.  Slots start out with one byte per column,
+//              enough for ASCII; the first line that needs more grows every slot at once, to two
+//              and then at most four bytes per column, so appending text only allocates a couple
+//              of times in the life of a history.  Lines remember how they ended and how much
+//              alignment padding they start with, so the window can take the text apart and lay it
+//              out again when it changes width.  Once anything styled is appended, every byte also
+//              keeps a one byte id of the style it was written in, which indexes a small table of
+//              the styles this history has seen.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef History_hpp
+#define History_hpp
+
+#include <cstddef>
+#include <vector>
+#include "Style.hpp"
+
+// How a stored line ends: with a line break, by wrapping at the width, or by wrapping at spaces
+// that were left out
+enum class LineEnd : char { line_break, wrap, word_wrap };
+
+// The most distinct styles one history can tell apart; text in any style past these is kept plain
+const unsigned int max_history_styles = 256;
+
+class History
+{
+private:
+    const unsigned int capacity;
+    unsigned int line_width;
+    unsigned int bytes_per_column;
+    std::vector<char> line_cells;
+    std::vector<unsigned char> line_style_ids;
+    std::vector<unsigned int> line_lengths;
+    std::vector<unsigned int> line_columns;
+    std::vector<LineEnd> line_ends;
+    std::vector<unsigned int> line_paddings;
+    unsigned int first_line;
+    unsigned int line_count;
+    std::vector<Style> styles;
+    unsigned char last_style_id;
+
+    // Private methods
+    unsigned char get_style_id (const Style& style);
+    unsigned int get_slot (const unsigned int& line);
+    std::size_t get_slot_size();
+    void grow_slots (const std::size_t& bytes_needed);
+    void start_new_line();
+
+public:
+    History (const unsigned int& capacity_input, const unsigned int& line_width_input);
+
+    void append (const char* text, const std::size_t& length, const Style& style = plain_style);
+    void append_padding (const unsigned int& count);
+    void end_line (const LineEnd& line_end);
+    void end_line_at_wrap (const LineEnd& line_end);
+    void clear();
+    void swap (History& other);
+
+    unsigned int get_line_count();
+    unsigned int get_current_line_columns();
+    unsigned int get_capacity();
+    unsigned int get_line_width();
+    const char* get_line (const unsigned int& line, unsigned int& length);
+    const unsigned char* get_line_style_ids (const unsigned int& line);
+    const Style& get_style (const unsigned char& style_id);
+    bool has_styles();
+    LineEnd get_line_end (const unsigned int& line);
+    unsigned int get_line_padding (const unsigned int& line);
+};
+
+#endif /* History_hpp */
@@ -0,0 +1,176 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Layout.cpp
+// Description: Window geometry that is relative to the screen, so windows can follow the terminal
+//              as it is resized.
+// Notes:       Each edge of a Layout is a fraction of the screen's width or height plus a number of
+//              cells.  Fixed geometry uses only cells, percentage geometry only fractions, and
+//              splitting a layout mixes the two, for example "the left third of everything above
+//              the bottom three lines".  resolve_layout() turns a layout into cells for one screen
+//              size.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cmath>
+#include "Layout.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the edge part of the way from one edge to another
+//--------------------------------------------------------------------------------------------------
+static LayoutEdge interpolate_edge (const LayoutEdge& from, const LayoutEdge& to,
+                                    const double& fraction)
+{
+    LayoutEdge edge;
+    edge.fraction = from.fraction + (to.fraction - from.fraction) * fraction;
+    edge.offset = from.offset + (to.offset - from.offset) * fraction;
+    return edge;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns an edge a number of cells away from another
+//--------------------------------------------------------------------------------------------------
+static LayoutEdge offset_edge (const LayoutEdge& edge, const int& cells)
+{
+    LayoutEdge moved = edge;
+    moved.offset += cells;
+    return moved;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Resolves the span between two edges on one axis of the screen, keeping it at least
+//          minimum_layout_size cells long and entirely on the screen where the screen allows.  On
+//          a screen smaller than that, the span is exactly minimum_layout_size cells from the
+//          start of the screen.
+//--------------------------------------------------------------------------------------------------
+static void resolve_span (const LayoutEdge& start_edge, const LayoutEdge& end_edge,
+                          const unsigned int& screen_size, unsigned int& start,
+                          unsigned int& size)
+{
+    double start_cell = std::floor (start_edge.fraction * screen_size + start_edge.offset + 0.5);
+    double end_cell = std::floor (end_edge.fraction * screen_size + end_edge.offset + 0.5);
+
+    double length = end_cell - start_cell;
+
+    if (length < minimum_layout_size)
+        length = minimum_layout_size;
+
+    if (length > screen_size)
+        length = screen_size >= minimum_layout_size ? screen_size : minimum_layout_size;
+
+    if (start_cell + length > screen_size)
+        start_cell = screen_size - length;
+
+    if (start_cell < 0)
+        start_cell = 0;
+
+    start = (unsigned int) start_cell;
+    size = (unsigned int) length;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns a layout that stays at the same place and size whatever the screen's size, like
+//         the geometry given to make_new_window()
+//--------------------------------------------------------------------------------------------------
+Layout make_fixed_layout (const unsigned int& x, const unsigned int& y,
+                          const unsigned int& width, const unsigned int& height)
+{
+    Layout layout;
+    layout.left = { 0, (double) x };
+    layout.top = { 0, (double) y };
+    layout.right = { 0, (double) x + width };
+    layout.bottom = { 0, (double) y + height };
+    return layout;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns a layout given in percentages of the screen's width and height
+//--------------------------------------------------------------------------------------------------
+Layout make_percent_layout (const double& x_percent, const double& y_percent,
+                            const double& width_percent, const double& height_percent)
+{
+    Layout layout;
+    layout.left = { x_percent / 100, 0 };
+    layout.top = { y_percent / 100, 0 };
+    layout.right = { (x_percent + width_percent) / 100, 0 };
+    layout.bottom = { (y_percent + height_percent) / 100, 0 };
+    return layout;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the part of a layout on one side of it, taking up a fraction of its width (for
+//         the left and right sides) or height (for the top and bottom)
+//--------------------------------------------------------------------------------------------------
+Layout split_layout (const Layout& parent, const LayoutSide& side, const double& fraction)
+{
+    Layout layout = parent;
+
+    switch (side)
+    {
+        case LayoutSide::left:
+            layout.right = interpolate_edge (parent.left, parent.right, fraction);
+            break;
+
+        case LayoutSide::right:
+            layout.left = interpolate_edge (parent.right, parent.left, fraction);
+            break;
+
+        case LayoutSide::top:
+            layout.bottom = interpolate_edge (parent.top, parent.bottom, fraction);
+            break;
+
+        case LayoutSide::bottom:
+            layout.top = interpolate_edge (parent.bottom, parent.top, fraction);
+            break;
+    }
+
+    return layout;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the part of a layout on one side of it that is a fixed number of cells wide (for
+//         the left and right sides) or tall (for the top and bottom).  A negative number of cells
+//         leaves that many cells of the layout out instead, so splitting the top by -3 cells gives
+//         everything above the bottom three lines.
+//--------------------------------------------------------------------------------------------------
+Layout split_layout_cells (const Layout& parent, const LayoutSide& side, const int& cells)
+{
+    Layout layout = parent;
+
+    switch (side)
+    {
+        case LayoutSide::left:
+            layout.right = cells >= 0 ? offset_edge (parent.left, cells)
+                                      : offset_edge (parent.right, cells);
+            break;
+
+        case LayoutSide::right:
+            layout.left = cells >= 0 ? offset_edge (parent.right, -cells)
+                                     : offset_edge (parent.left, -cells);
+            break;
+
+        case LayoutSide::top:
+            layout.bottom = cells >= 0 ? offset_edge (parent.top, cells)
+                                       : offset_edge (parent.bottom, cells);
+            break;
+
+        case LayoutSide::bottom:
+            layout.top = cells >= 0 ? offset_edge (parent.bottom, -cells)
+                                    : offset_edge (parent.top, -cells);
+            break;
+    }
+
+    return layout;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Works out where a layout puts a window on a screen of the given size.  The window is kept
+//         at least minimum_layout_size cells in each direction and moved or shrunk as needed to
+//         stay on the screen.
+//--------------------------------------------------------------------------------------------------
+void resolve_layout (const Layout& layout, const unsigned int& screen_width,
+                     const unsigned int& screen_height, unsigned int& x, unsigned int& y,
+                     unsigned int& width, unsigned int& height)
+{
+    resolve_span (layout.left, layout.right, screen_width, x, width);
+    resolve_span (layout.top, layout.bottom, screen_height, y, height);
+}
@@ -0,0 +1,48 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Layout.hpp
+// Description: Window geometry that is relative to the screen, so windows can follow the terminal
+//              as it is resized.
+// Notes:       Each edge of a Layout is a fraction of the screen's width or height plus a number of
+//              cells.  Fixed geometry uses only cells, percentage geometry only fractions, and
+//              splitting a layout mixes the two, for example "the left third of everything above
+//              the bottom three lines".  resolve_layout() turns a layout into cells for one screen
+//              size.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Layout_hpp
+#define Layout_hpp
+
+// An edge lies at fraction * screen size + offset cells
+struct LayoutEdge
+{
+    double fraction;
+    double offset;
+};
+
+struct Layout
+{
+    LayoutEdge left;
+    LayoutEdge top;
+    LayoutEdge right;
+    LayoutEdge bottom;
+};
+
+enum class LayoutSide { left, right, top, bottom };
+
+// The smallest window a layout resolves to: a border around a single cell
+const unsigned int minimum_layout_size = 3;
+
+Layout make_fixed_layout (const unsigned int& x, const unsigned int& y,
+                          const unsigned int& width, const unsigned int& height);
+Layout make_percent_layout (const double& x_percent, const double& y_percent,
+                            const double& width_percent, const double& height_percent);
+Layout split_layout (const Layout& parent, const LayoutSide& side, const double& fraction);
+Layout split_layout_cells (const Layout& parent, const LayoutSide& side, const int& cells);
+
+void resolve_layout (const Layout& layout, const unsigned int& screen_width,
+                     const unsigned int& screen_height, unsigned int& x, unsigned int& y,
+                     unsigned int& width, unsigned int& height);
+
+#endif /* Layout_hpp */
@@ -0,0 +1,227 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        LineEditor.cpp
+// Description: The editable line behind Window's line editing: a text buffer with a cursor, insert
+//              and overwrite modes, and a history of submitted lines to recall with the up and
+//              down keys.
+// Notes:       LineEditor only edits text; drawing it is left to Window, which can then apply a
+//              whole burst of keys before it repaints.  The text is UTF-8, typed a byte at a time,
+//              and the cursor only ever stops at the start of a character.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "Backend.hpp"
+#include "LineEditor.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether a byte continues a UTF-8 character rather than starting one
+//--------------------------------------------------------------------------------------------------
+static bool is_continuation_byte (const char& byte)
+{
+    return ((unsigned char) byte & 0xC0) == 0x80;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns where the character before position starts
+//--------------------------------------------------------------------------------------------------
+std::size_t LineEditor::get_previous_character (const std::size_t& position)
+{
+    std::size_t previous = position;
+
+    if (previous > 0)
+        previous--;
+
+    while (previous > 0 && is_continuation_byte (text[previous]))
+        previous--;
+
+    return previous;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns where the character after the one starting at position starts
+//--------------------------------------------------------------------------------------------------
+std::size_t LineEditor::get_next_character (const std::size_t& position)
+{
+    std::size_t next = position;
+
+    if (next < text.size())
+        next++;
+
+    while (next < text.size() && is_continuation_byte (text[next]))
+        next++;
+
+    return next;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Types one byte of a character at the cursor.  In overwrite mode, the first byte of a
+//          character replaces the whole character under the cursor; the bytes that continue it
+//          are always inserted after it.
+//--------------------------------------------------------------------------------------------------
+void LineEditor::insert_character (const char& character)
+{
+    if (is_overwrite_mode && cursor < text.size() && ! is_continuation_byte (character))
+        text.erase (cursor, get_next_character (cursor) - cursor);
+
+    text.insert (cursor, 1, character);
+    cursor++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Replaces the line with a line from the history, where position history.size() is the
+//          line that was being typed before browsing started
+//--------------------------------------------------------------------------------------------------
+void LineEditor::recall_history (const std::size_t& position)
+{
+    if (history_position == history.size())
+        draft = text;
+
+    history_position = position;
+    text = position == history.size() ? draft : history[position];
+    cursor = text.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Remembers a submitted line, skipping empty lines and repeats of the previous line
+//--------------------------------------------------------------------------------------------------
+void LineEditor::add_to_history (const std::string& line)
+{
+    if (history_capacity == 0 || line.empty() || (! history.empty() && history.back() == line))
+        return;
+
+    if (history.size() == history_capacity)
+        history.pop_front();
+
+    history.push_back (line);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Starts with an empty line that remembers up to history_capacity_input
+//         submitted lines
+//--------------------------------------------------------------------------------------------------
+LineEditor::LineEditor (const std::size_t& history_capacity_input)
+    : cursor (0), is_overwrite_mode (false), history_capacity (history_capacity_input),
+      history_position (0)
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Applies one key to the line.  Printable characters are typed at the cursor; the arrow,
+//         home and end keys move the cursor a whole character at a time; backspace and delete
+//         remove whole characters; insert
+//         switches between insert and overwrite mode; up and down browse the history; and enter
+//         submits the line, which is then collected with take_line().
+//--------------------------------------------------------------------------------------------------
+LineEditAction LineEditor::handle_key (const int& key)
+{
+    if (key == '\n' || key == '\r')
+        return LineEditAction::submitted;
+
+    // Printable characters, including the bytes of UTF-8 sequences
+    if ((key >= ' ' && key < 127) || (key >= 128 && key <= 255))
+    {
+        insert_character ((char) key);
+        return LineEditAction::edited;
+    }
+
+    switch (key)
+    {
+        case key_left:
+            cursor = get_previous_character (cursor);
+            break;
+
+        case key_right:
+            cursor = get_next_character (cursor);
+            break;
+
+        case key_home:
+            cursor = 0;
+            break;
+
+        case key_end:
+            cursor = text.size();
+            break;
+
+        case key_backspace:
+        {
+            std::size_t previous = get_previous_character (cursor);
+
+            text.erase (previous, cursor - previous);
+            cursor = previous;
+            break;
+        }
+
+        case key_delete:
+            text.erase (cursor, get_next_character (cursor) - cursor);
+            break;
+
+        case key_insert:
+            is_overwrite_mode = ! is_overwrite_mode;
+            break;
+
+        case key_up:
+            if (history_position > 0)
+                recall_history (history_position - 1);
+            break;
+
+        case key_down:
+            if (history_position < history.size())
+                recall_history (history_position + 1);
+            break;
+
+        default:
+            return LineEditAction::ignored;
+    }
+
+    return LineEditAction::edited;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the line, adds it to the history and starts a new, empty line
+//--------------------------------------------------------------------------------------------------
+std::string LineEditor::take_line()
+{
+    std::string line;
+    line.swap (text);
+
+    add_to_history (line);
+    clear();
+
+    return line;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Empties the line without adding it to the history
+//--------------------------------------------------------------------------------------------------
+void LineEditor::clear()
+{
+    text.clear();
+    cursor = 0;
+    draft.clear();
+    history_position = history.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the text of the line
+//--------------------------------------------------------------------------------------------------
+const std::string& LineEditor::get_text()
+{
+    return text;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the position of the cursor within the line
+//--------------------------------------------------------------------------------------------------
+std::size_t LineEditor::get_cursor()
+{
+    return cursor;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether typing replaces characters instead of inserting them
+//--------------------------------------------------------------------------------------------------
+bool LineEditor::get_overwrite_mode()
+{
+    return is_overwrite_mode;
+}
@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        LineEditor.hpp
+// Description: The editable line behind Window's line editing: a text buffer with a cursor, insert
+//              and overwrite modes, and a history of submitted lines to recall with the up and
+//              down keys.
+// Notes:       LineEditor only edits text; drawing it is left to Window, which can then apply a
+//              whole burst of keys before it repaints.  The text is UTF-8, typed a byte at a time,
+//              and the cursor only ever stops at the start of a character.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LineEditor_hpp
+#define LineEditor_hpp
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+// What a key did to the line: nothing, changed the text or cursor, or submitted the line
+enum class LineEditAction { ignored, edited, submitted };
+
+class LineEditor
+{
+private:
+    std::string text;
+    std::size_t cursor;
+    bool is_overwrite_mode;
+
+    std::deque<std::string> history;
+    const std::size_t history_capacity;
+    std::size_t history_position;
+    std::string draft;
+
+    // Private methods
+    std::size_t get_previous_character (const std::size_t& position);
+    std::size_t get_next_character (const std::size_t& position);
+    void insert_character (const char& character);
+    void recall_history (const std::size_t& position);
+    void add_to_history (const std::string& line);
+
+public:
+    LineEditor (const std::size_t& history_capacity_input);
+
+    LineEditAction handle_key (const int& key);
+    std::string take_line();
+    void clear();
+
+    const std::string& get_text();
+    std::size_t get_cursor();
+    bool get_overwrite_mode();
+};
+
+#endif /* LineEditor_hpp */
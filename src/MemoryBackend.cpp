@@ -0,0 +1,916 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        MemoryBackend.cpp
+// Description: A headless Backend that draws into an in-memory grid of cells instead of a terminal.
+//              Useful for deterministic tests, for benchmarks that shouldn't measure terminal I/O,
+//              and for taking snapshots of the screen.
+// Notes:       Cells are stored as a struct of arrays: one array of glyphs and a parallel array of
+//              attributes (styles packed by pack_style()), one entry per cell, row after row.  Like
+//              nCurses, there is a staged (virtual) screen that surfaces are copied to, and a
+//              visible screen that only changes when update() is called.  Keys can be fed in with
+//              push_key(), and resize_screen() acts like the terminal being resized.  Each glyph is
+//              a whole Unicode character; a wide character fills its cell and the one after it,
+//              which holds continuation_glyph.
+//
+//              The backend keeps its surfaces in a stack, bottom first.  Staging a surface copies
+//              it and then copies back the parts of the visible surfaces above it that it painted
+//              over; hiding, lowering, moving or destroying one blanks only the area it uncovered
+//              and paints every visible surface back into that area, bottom to top.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include "MemoryBackend.hpp"
+#include "TextLayout.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Allocates a blank grid
+//--------------------------------------------------------------------------------------------------
+CellGrid::CellGrid (const unsigned int& width_input, const unsigned int& height_input)
+    : width (width_input), height (height_input),
+      glyphs ((std::size_t) width_input * height_input, ' '),
+      attributes ((std::size_t) width_input * height_input, 0)
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sets every cell to glyph with no attributes
+//--------------------------------------------------------------------------------------------------
+void CellGrid::fill (const char32_t& glyph)
+{
+    std::fill (glyphs.begin(), glyphs.end(), glyph);
+    std::fill (attributes.begin(), attributes.end(), 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes one character columns wide at the cursor following nCurses' rules: '\n' clears
+//          the rest of the line and moves down, reaching the right edge wraps to the next line, and
+//          a wide character with only one column left blanks it and wraps first.  Writing over
+//          half of a wide character blanks the other half.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::put_character (const char32_t& character, const unsigned int& columns)
+{
+    if (cells.width == 0 || cells.height == 0 || columns > cells.width)
+        return;
+
+    std::size_t cell = (std::size_t) cursor_row * cells.width + cursor_column;
+
+    if (character == '\n')
+    {
+        std::fill (cells.glyphs.begin() + cell,
+                   cells.glyphs.begin() + (std::size_t) (cursor_row + 1) * cells.width, ' ');
+        std::fill (cells.attributes.begin() + cell,
+                   cells.attributes.begin() + (std::size_t) (cursor_row + 1) * cells.width, 0);
+        move_to_next_line();
+        return;
+    }
+
+    if (cursor_column + columns > cells.width)
+    {
+        if (cursor_column > 0 && cells.glyphs[cell] == continuation_glyph)
+            cells.glyphs[cell - 1] = ' ';
+
+        cells.glyphs[cell] = ' ';
+        cells.attributes[cell] = current_attributes;
+
+        if (cursor_row + 1 >= cells.height && ! is_scrolling)
+            return;
+
+        move_to_next_line();
+        cell = (std::size_t) cursor_row * cells.width + cursor_column;
+    }
+
+    if (cursor_column > 0 && cells.glyphs[cell] == continuation_glyph)
+        cells.glyphs[cell - 1] = ' ';
+
+    if (cursor_column + columns < cells.width && cells.glyphs[cell + columns] == continuation_glyph)
+        cells.glyphs[cell + columns] = ' ';
+
+    cells.glyphs[cell] = character;
+    cells.attributes[cell] = current_attributes;
+
+    if (columns > 1)
+    {
+        cells.glyphs[cell + 1] = continuation_glyph;
+        cells.attributes[cell + 1] = current_attributes;
+    }
+
+    if (cursor_column + columns < cells.width)
+        cursor_column += columns;
+    else if (cursor_row + 1 < cells.height || is_scrolling)
+        move_to_next_line();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes the ASCII at the start of the text, up to the first '\n', non-ASCII byte or the
+//          end of the line, straight into the cells, and adds the number of bytes it used to
+//          position.  Only the last character goes through put_character(), so it wraps the way
+//          nCurses does.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::put_ascii_run (const char* text, const std::size_t& length,
+                                   std::size_t& position)
+{
+    if (cells.width == 0 || cells.height == 0 || text[0] == '\n')
+    {
+        put_character (text[0], 1);
+        position++;
+        return;
+    }
+
+    std::size_t room = cells.width - cursor_column - 1;
+    std::size_t run = 0;
+
+    while (run < room && run < length && (unsigned char) text[run] < 0x80 && text[run] != '\n')
+        run++;
+
+    if (run > 0)
+    {
+        std::size_t cell = (std::size_t) cursor_row * cells.width + cursor_column;
+
+        if (cursor_column > 0 && cells.glyphs[cell] == continuation_glyph)
+            cells.glyphs[cell - 1] = ' ';
+
+        if (cells.glyphs[cell + run] == continuation_glyph)
+            cells.glyphs[cell + run] = ' ';
+
+        std::copy (text, text + run, cells.glyphs.begin() + cell);
+        std::fill (cells.attributes.begin() + cell, cells.attributes.begin() + cell + run,
+                   current_attributes);
+
+        cursor_column += run;
+        position += run;
+        return;
+    }
+
+    put_character (text[0], 1);
+    position++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Moves the cursor to the start of the next line, scrolling the surface up by a line if
+//          the cursor is already on the last line and scrolling is turned on
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::move_to_next_line()
+{
+    if (cursor_row + 1 < cells.height)
+    {
+        cursor_row++;
+        cursor_column = 0;
+        return;
+    }
+
+    if (! is_scrolling)
+        return;
+
+    std::copy (cells.glyphs.begin() + cells.width, cells.glyphs.end(), cells.glyphs.begin());
+    std::copy (cells.attributes.begin() + cells.width, cells.attributes.end(),
+               cells.attributes.begin());
+
+    std::fill (cells.glyphs.end() - cells.width, cells.glyphs.end(), ' ');
+    std::fill (cells.attributes.end() - cells.width, cells.attributes.end(), 0);
+
+    cursor_column = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates a blank surface at the given position on the backend's screen, on
+//         top of every surface already there
+//--------------------------------------------------------------------------------------------------
+MemorySurface::MemorySurface (MemoryBackend& backend_input, const unsigned int& x_input,
+                              const unsigned int& y_input, const unsigned int& width,
+                              const unsigned int& height)
+    : backend (&backend_input), cells (width, height), cursor_row (0), cursor_column (0),
+      is_scrolling (false), current_attributes (0), is_visible (true), x (x_input), y (y_input),
+      view_width (width), view_height (height), view_row (0), view_column (0), is_pad (false)
+{
+    backend->add_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates a blank pad of width by height cells, shown through a view of
+//         view_width by view_height at the given position.  The pad is never smaller than its view.
+//--------------------------------------------------------------------------------------------------
+MemorySurface::MemorySurface (MemoryBackend& backend_input, const unsigned int& x_input,
+                              const unsigned int& y_input, const unsigned int& view_width_input,
+                              const unsigned int& view_height_input, const unsigned int& width,
+                              const unsigned int& height)
+    : backend (&backend_input),
+      cells (std::max (width, view_width_input), std::max (height, view_height_input)),
+      cursor_row (0), cursor_column (0), is_scrolling (false), current_attributes (0),
+      is_visible (true), x (x_input), y (y_input), view_width (view_width_input),
+      view_height (view_height_input), view_row (0), view_column (0), is_pad (true)
+{
+    backend->add_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates a blank offscreen surface.  Refreshing or staging it does nothing
+//         and it never has any keys to read.
+//--------------------------------------------------------------------------------------------------
+MemorySurface::MemorySurface (const unsigned int& width, const unsigned int& height)
+    : backend (NULL), cells (width, height), cursor_row (0), cursor_column (0),
+      is_scrolling (false), current_attributes (0), is_visible (false), x (0), y (0),
+      view_width (width), view_height (height), view_row (0), view_column (0), is_pad (false)
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destructor - Takes the surface off the backend's screen, staging whatever it uncovers
+//--------------------------------------------------------------------------------------------------
+MemorySurface::~MemorySurface()
+{
+    if (backend != NULL)
+        backend->remove_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes UTF-8 text at the cursor.  Characters that take no columns, such as combining
+//         marks, are dropped rather than combined with the glyph before them.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::put_text (const char* text, const std::size_t& length)
+{
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        if ((unsigned char) text[i] < 0x80)
+        {
+            put_ascii_run (text + i, length - i, i);
+            continue;
+        }
+
+        char32_t character;
+        i += decode_utf8 (text + i, length - i, character);
+
+        unsigned int columns = get_character_width (character);
+
+        if (columns > 0)
+            put_character (character, columns);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the cursor and writes text there
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::put_text_at (const unsigned int& row, const unsigned int& column,
+                                 const char* text, const std::size_t& length)
+{
+    move_cursor (row, column);
+    put_text (text, length);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the cursor, ignoring positions outside the surface like nCurses does
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::move_cursor (const unsigned int& row, const unsigned int& column)
+{
+    if (row >= cells.height || column >= cells.width)
+        return;
+
+    cursor_row = row;
+    cursor_column = column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the line the cursor is on
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_cursor_row()
+{
+    return cursor_row;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column the cursor is in
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_cursor_column()
+{
+    return cursor_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the width (columns) of the surface
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_width()
+{
+    return cells.width;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the height (lines) of the surface
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_height()
+{
+    return cells.height;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the surface and reallocates it, blank, at the new size, staging whatever it
+//         uncovers.  A pad's view is moved and resized instead, and the pad keeps its size unless
+//         the view has outgrown it.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::move_and_resize (const unsigned int& x_input, const unsigned int& y_input,
+                                     const unsigned int& width, const unsigned int& height)
+{
+    unsigned int old_x = x;
+    unsigned int old_y = y;
+    unsigned int old_width = view_width;
+    unsigned int old_height = view_height;
+
+    x = x_input;
+    y = y_input;
+    view_width = width;
+    view_height = height;
+
+    if (is_pad)
+        cells = CellGrid (std::max (cells.width, width), std::max (cells.height, height));
+    else
+        cells = CellGrid (width, height);
+
+    cursor_row = 0;
+    cursor_column = 0;
+    set_view_origin (view_row, view_column);
+
+    if (backend != NULL && is_visible)
+        backend->restage_region (old_x, old_y, old_width, old_height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Turns scrolling past the last line on or off
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::set_scrolling (const bool& scrolling)
+{
+    is_scrolling = scrolling;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws text written from now on in style
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::set_style (const Style& style)
+{
+    current_attributes = pack_style (style);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws a box around the edge of the surface out of plain ASCII characters
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::draw_border()
+{
+    if (cells.width < 2 || cells.height < 2)
+        return;
+
+    for (unsigned int column = 0; column < cells.width; column++)
+    {
+        cells.glyphs[column] = '-';
+        cells.glyphs[(std::size_t) (cells.height - 1) * cells.width + column] = '-';
+    }
+
+    for (unsigned int row = 0; row < cells.height; row++)
+    {
+        char side = (row == 0 || row == cells.height - 1) ? '+' : '|';
+
+        cells.glyphs[(std::size_t) row * cells.width] = side;
+        cells.glyphs[(std::size_t) row * cells.width + cells.width - 1] = side;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Blanks the surface and moves the cursor home
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::erase_surface()
+{
+    cells.fill (' ');
+    cursor_row = 0;
+    cursor_column = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Same as erase_surface(); every stage copies the whole surface anyway
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::clear_surface()
+{
+    erase_surface();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Nothing to do; every stage copies the whole surface anyway
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::touch_surface()
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Stages the surface and updates the backend's visible screen
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::refresh_surface()
+{
+    if (backend == NULL)
+        return;
+
+    stage_surface();
+    backend->update();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies the surface onto the backend's staged screen, under any surfaces above it
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::stage_surface()
+{
+    if (backend != NULL && is_visible)
+        backend->stage_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Shows or hides the surface.  Showing it puts it on top and stages it; hiding it stages
+//         whatever it was covering.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::set_visible (const bool& visible)
+{
+    if (visible == is_visible || backend == NULL)
+        return;
+
+    is_visible = visible;
+
+    if (is_visible)
+        backend->raise_surface (this);
+    else
+        backend->restage_region (x, y, view_width, view_height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the surface is shown
+//--------------------------------------------------------------------------------------------------
+bool MemorySurface::get_visible()
+{
+    return is_visible;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the surface on top of every other surface and stages it.  Does nothing while hidden.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::raise_surface()
+{
+    if (backend != NULL && is_visible)
+        backend->raise_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the surface under every other surface and stages what that uncovers.  Does nothing
+//         while hidden.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::lower_surface()
+{
+    if (backend != NULL && is_visible)
+        backend->lower_surface (this);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sets the cell of a pad shown in the top left corner of its view, kept far enough in that
+//         the view never runs off the pad.  Takes effect the next time the pad is staged.
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::set_view_origin (const unsigned int& row, const unsigned int& column)
+{
+    view_row = std::min (row, cells.height - view_height);
+    view_column = std::min (column, cells.width - view_width);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the row of the pad shown in the top line of its view
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_view_row()
+{
+    return view_row;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column of the pad shown in the left column of its view
+//--------------------------------------------------------------------------------------------------
+unsigned int MemorySurface::get_view_column()
+{
+    return view_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the next key pushed into the backend, or no_key if there isn't one
+//--------------------------------------------------------------------------------------------------
+int MemorySurface::read_key()
+{
+    if (backend == NULL)
+        return no_key;
+
+    return backend->read_key();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the surface's cells, for callers that need to read back what was drawn
+//--------------------------------------------------------------------------------------------------
+CellGrid& MemorySurface::get_cells()
+{
+    return cells;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the area of the screen the surface shows in
+//--------------------------------------------------------------------------------------------------
+void MemorySurface::get_view (unsigned int& x_output, unsigned int& y_output,
+                              unsigned int& width, unsigned int& height)
+{
+    x_output = x;
+    y_output = y;
+    width = view_width;
+    height = view_height;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns where a surface is in the stack, or the stack's size if it isn't there
+//--------------------------------------------------------------------------------------------------
+std::size_t MemoryBackend::find_surface (MemorySurface* surface)
+{
+    return std::find (surfaces.begin(), surfaces.end(), surface) - surfaces.begin();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Copies the part of a surface's view that falls between columns left and right and
+//          lines top and bottom of the screen (right and bottom excluded) onto the staged screen.
+//          Wide characters are only mended where the view's edge is inside that area; the area's
+//          own edges are left for paint_region() to mend once everything has been painted.
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::paint_view (MemorySurface& surface, const unsigned int& left,
+                                const unsigned int& top, const unsigned int& right,
+                                const unsigned int& bottom)
+{
+    unsigned int x, y, width, height;
+    surface.get_view (x, y, width, height);
+
+    unsigned int first_column = std::max (left, x);
+    unsigned int first_row = std::max (top, y);
+    unsigned int last_column = std::min ({right, x + width, staged_screen.width});
+    unsigned int last_row = std::min ({bottom, y + height, staged_screen.height});
+
+    if (first_column >= last_column || first_row >= last_row)
+        return;
+
+    const CellGrid& cells = surface.get_cells();
+    std::size_t columns = last_column - first_column;
+
+    for (unsigned int row = first_row; row < last_row; row++)
+    {
+        std::size_t source = (std::size_t) (surface.get_view_row() + row - y) * cells.width
+                             + surface.get_view_column() + first_column - x;
+        std::size_t row_start = (std::size_t) row * staged_screen.width;
+        std::size_t destination = row_start + first_column;
+
+        std::copy (cells.glyphs.begin() + source, cells.glyphs.begin() + source + columns,
+                   staged_screen.glyphs.begin() + destination);
+        std::copy (cells.attributes.begin() + source, cells.attributes.begin() + source + columns,
+                   staged_screen.attributes.begin() + destination);
+
+        if (first_column > left)
+            mend_wide_character (row_start, first_column);
+
+        if (last_column < right)
+            mend_wide_character (row_start, last_column);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Paints the shown surfaces from first_surface up to the top of the stack into an area of
+//          the staged screen, bottom to top, then mends the wide characters its edges cut through
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::paint_region (const std::size_t& first_surface, const unsigned int& left,
+                                  const unsigned int& top, const unsigned int& right,
+                                  const unsigned int& bottom)
+{
+    for (std::size_t i = first_surface; i < surfaces.size(); i++)
+        if (surfaces[i]->get_visible())
+            paint_view (*surfaces[i], left, top, right, bottom);
+
+    unsigned int last_row = std::min (bottom, staged_screen.height);
+
+    for (unsigned int row = top; row < last_row; row++)
+    {
+        mend_wide_character ((std::size_t) row * staged_screen.width, left);
+        mend_wide_character ((std::size_t) row * staged_screen.width, right);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Blanks either half of a wide character on the staged screen that painting split from
+//          its other half, where column is the first column painted or the one after the last
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::mend_wide_character (const std::size_t& row_start, const unsigned int& column)
+{
+    if (column >= staged_screen.width)
+        return;
+
+    std::vector<char32_t>& glyphs = staged_screen.glyphs;
+    bool is_second_half = glyphs[row_start + column] == continuation_glyph;
+    bool is_after_first_half = column > 0
+                               && glyphs[row_start + column - 1] != continuation_glyph
+                               && get_character_width (glyphs[row_start + column - 1]) == 2;
+
+    if (is_second_half && ! is_after_first_half)
+        glyphs[row_start + column] = ' ';
+    else if (is_after_first_half && ! is_second_half)
+        glyphs[row_start + column - 1] = ' ';
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates blank staged and visible screens of the given size
+//--------------------------------------------------------------------------------------------------
+MemoryBackend::MemoryBackend (const unsigned int& width, const unsigned int& height)
+    : staged_screen (width, height), visible_screen (width, height), update_count (0)
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Creates a new in-memory surface
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Surface> MemoryBackend::make_surface (const unsigned int& x, const unsigned int& y,
+                                                      const unsigned int& width,
+                                                      const unsigned int& height)
+{
+    return std::unique_ptr<Surface> (new MemorySurface (*this, x, y, width, height));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Creates a new in-memory pad, shown through a view of view_width by view_height
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Surface> MemoryBackend::make_pad_surface (const unsigned int& x,
+                                                          const unsigned int& y,
+                                                          const unsigned int& view_width,
+                                                          const unsigned int& view_height,
+                                                          const unsigned int& width,
+                                                          const unsigned int& height)
+{
+    return std::unique_ptr<Surface> (new MemorySurface (*this, x, y, view_width, view_height,
+                                                        width, height));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Makes everything staged so far visible
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::update()
+{
+    visible_screen.glyphs = staged_screen.glyphs;
+    visible_screen.attributes = staged_screen.attributes;
+    update_count++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the width (columns) of the screen
+//--------------------------------------------------------------------------------------------------
+unsigned int MemoryBackend::get_screen_width()
+{
+    return staged_screen.width;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the height (lines) of the screen
+//--------------------------------------------------------------------------------------------------
+unsigned int MemoryBackend::get_screen_height()
+{
+    return staged_screen.height;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the next key pushed with push_key(), or no_key if there isn't one.  Never waits.
+//--------------------------------------------------------------------------------------------------
+int MemoryBackend::read_key()
+{
+    if (pending_keys.empty())
+        return no_key;
+
+    int key = pending_keys.front();
+    pending_keys.pop_front();
+
+    return key;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Same as read_key(); keys are only ever pushed from the same thread, so waiting for one
+//         would never end
+//--------------------------------------------------------------------------------------------------
+int MemoryBackend::poll_key (const unsigned int&)
+{
+    return read_key();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Throws away any keys that were pushed but not read yet
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::discard_typeahead()
+{
+    pending_keys.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns -1, as pushed keys don't come from a descriptor
+//--------------------------------------------------------------------------------------------------
+int MemoryBackend::get_input_descriptor()
+{
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Resizes the screen the way a terminal window being resized would: the screen is blanked
+//         and a key_resize is queued for the program to read
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::resize_screen (const unsigned int& width, const unsigned int& height)
+{
+    staged_screen = CellGrid (width, height);
+    visible_screen = CellGrid (width, height);
+
+    push_key (key_resize);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts a new surface on top of the stack
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::add_surface (MemorySurface* surface)
+{
+    surfaces.push_back (surface);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Takes a surface out of the stack, staging what it uncovers if it was shown
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::remove_surface (MemorySurface* surface)
+{
+    std::size_t index = find_surface (surface);
+
+    if (index == surfaces.size())
+        return;
+
+    surfaces.erase (surfaces.begin() + index);
+
+    if (! surface->get_visible())
+        return;
+
+    unsigned int x, y, width, height;
+    surface->get_view (x, y, width, height);
+    restage_region (x, y, width, height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts a surface on top of the stack and stages it
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::raise_surface (MemorySurface* surface)
+{
+    std::size_t index = find_surface (surface);
+
+    if (index == surfaces.size())
+        return;
+
+    std::rotate (surfaces.begin() + index, surfaces.begin() + index + 1, surfaces.end());
+    stage_surface (surface);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts a surface at the bottom of the stack and stages what that uncovers
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::lower_surface (MemorySurface* surface)
+{
+    std::size_t index = find_surface (surface);
+
+    if (index == surfaces.size())
+        return;
+
+    std::rotate (surfaces.begin(), surfaces.begin() + index, surfaces.begin() + index + 1);
+
+    unsigned int x, y, width, height;
+    surface->get_view (x, y, width, height);
+    restage_region (x, y, width, height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies a surface's view onto the staged screen, clipping anything that falls off the
+//         edge of the screen, then copies back the parts of shown surfaces above it that it painted
+//         over
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::stage_surface (MemorySurface* surface)
+{
+    std::size_t index = find_surface (surface);
+
+    if (index == surfaces.size())
+        return;
+
+    unsigned int x, y, width, height;
+    surface->get_view (x, y, width, height);
+    paint_region (index, x, y, std::min (x + width, staged_screen.width), y + height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Blanks an area of the staged screen and paints every shown surface back into it, from
+//         the bottom of the stack to the top.  The column either side of the area is painted too,
+//         as it may hold half of a wide character that was blanked when the area was covered.
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::restage_region (const unsigned int& x, const unsigned int& y,
+                                    const unsigned int& width, const unsigned int& height)
+{
+    unsigned int left = x > 0 ? x - 1 : 0;
+    unsigned int right = std::min (x + width + 1, staged_screen.width);
+    unsigned int bottom = std::min (y + height, staged_screen.height);
+
+    if (left >= right || y >= bottom)
+        return;
+
+    for (unsigned int row = y; row < bottom; row++)
+    {
+        std::size_t start = (std::size_t) row * staged_screen.width;
+
+        std::fill (staged_screen.glyphs.begin() + start + left,
+                   staged_screen.glyphs.begin() + start + right, ' ');
+        std::fill (staged_screen.attributes.begin() + start + left,
+                   staged_screen.attributes.begin() + start + right, 0);
+    }
+
+    paint_region (0, left, y, right, bottom);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Queues a key to be returned by a later read_key()
+//--------------------------------------------------------------------------------------------------
+void MemoryBackend::push_key (const int& key)
+{
+    pending_keys.push_back (key);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the width (columns) of the screen
+//--------------------------------------------------------------------------------------------------
+unsigned int MemoryBackend::get_width()
+{
+    return visible_screen.width;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the height (lines) of the screen
+//--------------------------------------------------------------------------------------------------
+unsigned int MemoryBackend::get_height()
+{
+    return visible_screen.height;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the visible glyph at a position on the screen, which is continuation_glyph for
+//         the second cell of a wide character
+//--------------------------------------------------------------------------------------------------
+char32_t MemoryBackend::get_glyph (const unsigned int& row, const unsigned int& column)
+{
+    return visible_screen.glyphs[(std::size_t) row * visible_screen.width + column];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the visible attributes at a position on the screen
+//--------------------------------------------------------------------------------------------------
+unsigned int MemoryBackend::get_attributes (const unsigned int& row, const unsigned int& column)
+{
+    return visible_screen.attributes[(std::size_t) row * visible_screen.width + column];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns one visible line of the screen as UTF-8 text
+//--------------------------------------------------------------------------------------------------
+std::string MemoryBackend::get_screen_line (const unsigned int& row)
+{
+    std::size_t line_start = (std::size_t) row * visible_screen.width;
+    std::string line;
+    char character[4];
+
+    line.reserve (visible_screen.width);
+
+    for (unsigned int column = 0; column < visible_screen.width; column++)
+    {
+        char32_t glyph = visible_screen.glyphs[line_start + column];
+
+        if (glyph != continuation_glyph)
+            line.append (character, encode_utf8 (glyph, character));
+    }
+
+    return line;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns a snapshot of the whole visible screen, one line of text per row
+//--------------------------------------------------------------------------------------------------
+std::string MemoryBackend::get_screen_text()
+{
+    std::string screen_text;
+
+    for (unsigned int row = 0; row < visible_screen.height; row++)
+        screen_text += get_screen_line (row) + "\n";
+
+    return screen_text;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many times update() has been called, i.e. how many frames were drawn
+//--------------------------------------------------------------------------------------------------
+unsigned long int MemoryBackend::get_update_count()
+{
+    return update_count;
+}
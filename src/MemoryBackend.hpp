@@ -0,0 +1,187 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        MemoryBackend.hpp
+// Description: A headless Backend that draws into an in-memory grid of cells instead of a terminal.
+//              Useful for deterministic tests, for benchmarks that shouldn't measure terminal I/O,
+//              and for taking snapshots of the screen.
+// Notes:       Cells are stored as a struct of arrays: one array of glyphs and a parallel array of
+//              attributes (styles packed by pack_style()), one entry per cell, row after row.  Like
+//              nCurses, there is a staged (virtual) screen that surfaces are copied to, and a
+//              visible screen that only changes when update() is called.  Keys can be fed in with
+//              push_key(), and resize_screen() acts like the terminal being resized.  Each glyph is
+//              a whole Unicode character; a wide character fills its cell and the one after it,
+//              which holds continuation_glyph.
+//
+//              The backend keeps its surfaces in a stack, bottom first.  Staging a surface copies
+//              it and then copies back the parts of the visible surfaces above it that it painted
+//              over; hiding, lowering, moving or destroying one blanks only the area it uncovered
+//              and paints every visible surface back into that area, bottom to top.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef MemoryBackend_hpp
+#define MemoryBackend_hpp
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "Backend.hpp"
+
+// One screen's worth of cells
+struct CellGrid
+{
+    unsigned int width;
+    unsigned int height;
+    std::vector<char32_t> glyphs;
+    std::vector<unsigned int> attributes;
+
+    CellGrid (const unsigned int& width_input, const unsigned int& height_input);
+    void fill (const char32_t& glyph);
+};
+
+// The glyph of the second cell of a wide character, which is drawn by the cell before it
+const char32_t continuation_glyph = 0;
+
+class MemoryBackend;
+
+// A surface on a MemoryBackend's screen, or an offscreen one that is never staged anywhere, such as
+// the back buffer Window draws a frame into
+class MemorySurface final : public Surface
+{
+private:
+    MemoryBackend* backend;
+    CellGrid cells;
+    unsigned int cursor_row;
+    unsigned int cursor_column;
+    bool is_scrolling;
+    unsigned int current_attributes;
+    bool is_visible;
+
+    // The area of the screen the surface shows in, and the cell of the surface shown in its top
+    // left corner, which is only ever moved from (0, 0) for pads
+    unsigned int x;
+    unsigned int y;
+    unsigned int view_width;
+    unsigned int view_height;
+    unsigned int view_row;
+    unsigned int view_column;
+    bool is_pad;
+
+    // Private methods
+    void put_character (const char32_t& character, const unsigned int& columns);
+    void put_ascii_run (const char* text, const std::size_t& length, std::size_t& position);
+    void move_to_next_line();
+
+public:
+    MemorySurface (MemoryBackend& backend_input, const unsigned int& x_input,
+                   const unsigned int& y_input, const unsigned int& width,
+                   const unsigned int& height);
+    MemorySurface (MemoryBackend& backend_input, const unsigned int& x_input,
+                   const unsigned int& y_input, const unsigned int& view_width_input,
+                   const unsigned int& view_height_input, const unsigned int& width,
+                   const unsigned int& height);
+    MemorySurface (const unsigned int& width, const unsigned int& height);
+    ~MemorySurface();
+
+    void put_text (const char* text, const std::size_t& length) override;
+    void put_text_at (const unsigned int& row, const unsigned int& column,
+                      const char* text, const std::size_t& length) override;
+    void move_cursor (const unsigned int& row, const unsigned int& column) override;
+    unsigned int get_cursor_row() override;
+    unsigned int get_cursor_column() override;
+
+    unsigned int get_width() override;
+    unsigned int get_height() override;
+    void move_and_resize (const unsigned int& x, const unsigned int& y,
+                          const unsigned int& width, const unsigned int& height) override;
+
+    void set_scrolling (const bool& scrolling) override;
+    void set_style (const Style& style) override;
+    void draw_border() override;
+
+    void erase_surface() override;
+    void clear_surface() override;
+    void touch_surface() override;
+
+    void refresh_surface() override;
+    void stage_surface() override;
+
+    void set_visible (const bool& visible) override;
+    bool get_visible() override;
+    void raise_surface() override;
+    void lower_surface() override;
+
+    void set_view_origin (const unsigned int& row, const unsigned int& column) override;
+    unsigned int get_view_row() override;
+    unsigned int get_view_column() override;
+
+    int read_key() override;
+
+    CellGrid& get_cells();
+    void get_view (unsigned int& x_output, unsigned int& y_output, unsigned int& width,
+                   unsigned int& height);
+};
+
+class MemoryBackend : public Backend
+{
+private:
+    CellGrid staged_screen;
+    CellGrid visible_screen;
+    std::deque<int> pending_keys;
+    unsigned long int update_count;
+    std::vector<MemorySurface*> surfaces;
+
+    // Private methods
+    std::size_t find_surface (MemorySurface* surface);
+    void paint_view (MemorySurface& surface, const unsigned int& left, const unsigned int& top,
+                     const unsigned int& right, const unsigned int& bottom);
+    void paint_region (const std::size_t& first_surface, const unsigned int& left,
+                       const unsigned int& top, const unsigned int& right,
+                       const unsigned int& bottom);
+    void mend_wide_character (const std::size_t& row_start, const unsigned int& column);
+
+public:
+    MemoryBackend (const unsigned int& width, const unsigned int& height);
+
+    std::unique_ptr<Surface> make_surface (const unsigned int& x, const unsigned int& y,
+                                           const unsigned int& width,
+                                           const unsigned int& height) override;
+    std::unique_ptr<Surface> make_pad_surface (const unsigned int& x, const unsigned int& y,
+                                               const unsigned int& view_width,
+                                               const unsigned int& view_height,
+                                               const unsigned int& width,
+                                               const unsigned int& height) override;
+
+    void update() override;
+
+    unsigned int get_screen_width() override;
+    unsigned int get_screen_height() override;
+
+    int read_key() override;
+    int poll_key (const unsigned int& timeout_milliseconds) override;
+    void discard_typeahead() override;
+    int get_input_descriptor() override;
+
+    // For MemorySurface: the stack of surfaces on the screen, and staging onto it
+    void add_surface (MemorySurface* surface);
+    void remove_surface (MemorySurface* surface);
+    void raise_surface (MemorySurface* surface);
+    void lower_surface (MemorySurface* surface);
+    void stage_surface (MemorySurface* surface);
+    void restage_region (const unsigned int& x, const unsigned int& y, const unsigned int& width,
+                         const unsigned int& height);
+
+    // Headless-only methods
+    void push_key (const int& key);
+    void resize_screen (const unsigned int& width, const unsigned int& height);
+
+    unsigned int get_width();
+    unsigned int get_height();
+    char32_t get_glyph (const unsigned int& row, const unsigned int& column);
+    unsigned int get_attributes (const unsigned int& row, const unsigned int& column);
+    std::string get_screen_line (const unsigned int& row);
+    std::string get_screen_text();
+    unsigned long int get_update_count();
+};
+
+#endif /* MemoryBackend_hpp */
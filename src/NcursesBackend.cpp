@@ -0,0 +1,793 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        NcursesBackend.cpp
+// Description: The default Backend, which draws to the terminal using nCurses
+// Notes:       Constructing an NcursesBackend starts nCurses with initscr() and destroying it ends
+//              nCurses with endwin(), so only one may exist at a time and every Surface it makes
+//              must be destroyed before it is.  The newterm() constructor draws to any pair of
+//              files instead of the terminal, so the library can be benchmarked headless.  Text is
+//              UTF-8 and is drawn through the wide character functions of nCursesW.
+//
+//              Every surface is a panel, so the panel library keeps overlapping surfaces in order.
+//              A surface that nothing covers is staged with wnoutrefresh() as before; one that is
+//              covered, and every change to the stack, waits for update_panels() in update(),
+//              which only copies what changed and the parts of the surfaces above that it touched.
+//              A pad can't be a panel, so a pad surface is drawn on a pad and the part in view is
+//              copied into a panel window with copywin() when it is staged.  Keys are read through
+//              a pad of their own, as wgetch() on any other window refreshes it and would paint it
+//              over the panels above it.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <clocale>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "NcursesBackend.hpp"
+#include "TextLayout.hpp"
+
+// How many characters of non-ASCII text are decoded at a time before being drawn
+const std::size_t wide_chunk_length = 128;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Translates what wgetch() returned into the library's key codes
+//--------------------------------------------------------------------------------------------------
+static int decode_key (const int& key)
+{
+    if (key == ERR)
+        return no_key;
+
+    // Terminals disagree about what backspace sends
+    if (key == KEY_BACKSPACE || key == 127 || key == 8)
+        return key_backspace;
+
+    if (key >= 0 && key <= 255)
+        return key;
+
+    if (key >= KEY_F (1) && key <= KEY_F (12))
+        return key_function_1 + (key - KEY_F (1));
+
+    switch (key)
+    {
+        case KEY_UP:        return key_up;
+        case KEY_DOWN:      return key_down;
+        case KEY_LEFT:      return key_left;
+        case KEY_RIGHT:     return key_right;
+        case KEY_HOME:      return key_home;
+        case KEY_END:       return key_end;
+        case KEY_PPAGE:     return key_page_up;
+        case KEY_NPAGE:     return key_page_down;
+        case KEY_IC:        return key_insert;
+        case KEY_DC:        return key_delete;
+        case KEY_ENTER:     return '\n';
+        case KEY_RESIZE:    return key_resize;
+        default:            return key_unknown;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the nCurses number of a color.  The terminal's own color is -1 when the terminal
+//          lets it be used in color pairs, and white on black otherwise.
+//--------------------------------------------------------------------------------------------------
+short ColorPairCache::get_color_number (const Color& color, const bool& is_foreground)
+{
+    switch (color)
+    {
+        case Color::black:      return COLOR_BLACK;
+        case Color::red:        return COLOR_RED;
+        case Color::green:      return COLOR_GREEN;
+        case Color::yellow:     return COLOR_YELLOW;
+        case Color::blue:       return COLOR_BLUE;
+        case Color::magenta:    return COLOR_MAGENTA;
+        case Color::cyan:       return COLOR_CYAN;
+        case Color::white:      return COLOR_WHITE;
+        default:                break;
+    }
+
+    if (has_default_colors)
+        return -1;
+
+    return is_foreground ? COLOR_WHITE : COLOR_BLACK;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Starts with no pairs set up.  Nothing works in color until start().
+//--------------------------------------------------------------------------------------------------
+ColorPairCache::ColorPairCache()
+    : next_pair (1), has_default_colors (false), is_color_available (false),
+      allocation_count (0)
+{
+    for (unsigned int foreground = 0; foreground < color_count; foreground++)
+        for (unsigned int background = 0; background < color_count; background++)
+            pairs[foreground][background] = unassigned_pair;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Turns color on, if the terminal has it.  Must be called once nCurses has started.
+//--------------------------------------------------------------------------------------------------
+void ColorPairCache::start()
+{
+    if (! has_colors() || start_color() == ERR)
+        return;
+
+    is_color_available = true;
+    has_default_colors = use_default_colors() == OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the color pair for a foreground and background, setting it up the first time it
+//         is asked for.  The terminal's own colors are always pair 0.
+// Notes:  On a terminal without color, once every pair the terminal has is used up, or when
+//         init_pair() fails, new combinations are drawn in pair 0 rather than taking a pair
+//         already on the screen.  That answer is kept like any other, so nCurses is only asked
+//         once per combination however it turns out.
+//--------------------------------------------------------------------------------------------------
+short ColorPairCache::get_pair (const Color& foreground, const Color& background)
+{
+    if (! is_color_available)
+        return 0;
+
+    short& pair = pairs[(unsigned int) foreground][(unsigned int) background];
+
+    if (pair != unassigned_pair)
+        return pair;
+
+    pair = 0;
+
+    if (foreground == Color::default_color && background == Color::default_color)
+        return 0;
+
+    if (next_pair >= COLOR_PAIRS)
+        return 0;
+
+    if (init_pair (next_pair, get_color_number (foreground, true),
+                   get_color_number (background, false)) == ERR)
+        return 0;
+
+    pair = next_pair++;
+    allocation_count++;
+
+    return pair;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many color pairs have been set up with init_pair()
+//--------------------------------------------------------------------------------------------------
+unsigned long int ColorPairCache::get_allocation_count()
+{
+    return allocation_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether a visible panel above this surface overlaps it, so staging it by itself
+//          would paint over that panel
+//--------------------------------------------------------------------------------------------------
+bool NcursesSurface::is_covered()
+{
+    int top = getbegy (view_window_ptr);
+    int left = getbegx (view_window_ptr);
+    int bottom = top + getmaxy (view_window_ptr);
+    int right = left + getmaxx (view_window_ptr);
+
+    for (PANEL* above = panel_above (panel); above != NULL; above = panel_above (above))
+    {
+        WINDOW* window = panel_window (above);
+
+        if (getbegy (window) < bottom && top < getbegy (window) + getmaxy (window) &&
+            getbegx (window) < right && left < getbegx (window) + getmaxx (window))
+            return true;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Marks the lines of every panel below this surface that it covers, and of the screen's
+//          background, as changed, so the next update() paints them back once it has moved away
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::uncover()
+{
+    int top = getbegy (view_window_ptr);
+    int left = getbegx (view_window_ptr);
+    int bottom = top + getmaxy (view_window_ptr);
+    int right = left + getmaxx (view_window_ptr);
+
+    for (PANEL* below = panel_below (panel); below != NULL; below = panel_below (below))
+    {
+        WINDOW* window = panel_window (below);
+        int window_top = getbegy (window);
+        int window_bottom = window_top + getmaxy (window);
+
+        if (window_top >= bottom || top >= window_bottom || getbegx (window) >= right ||
+            left >= getbegx (window) + getmaxx (window))
+            continue;
+
+        int first = top > window_top ? top : window_top;
+        int last = bottom < window_bottom ? bottom : window_bottom;
+
+        touchline (window, first - window_top, last - first);
+    }
+
+    if (bottom > getmaxy (stdscr))
+        bottom = getmaxy (stdscr);
+
+    if (top < bottom)
+        touchline (stdscr, top, bottom - top);
+
+    backend->mark_panels_changed();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Copies the part of a pad that is in view into the window that shows it.  copywin() only
+//          marks the cells that differ as changed.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::copy_view()
+{
+    copywin (ncurse_window_ptr, view_window_ptr, view_row, view_column, 0, 0,
+             getmaxy (view_window_ptr) - 1, getmaxx (view_window_ptr) - 1, FALSE);
+    untouchwin (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates the nCurses WINDOW backing this surface, on top of every other
+//         surface
+//--------------------------------------------------------------------------------------------------
+NcursesSurface::NcursesSurface (NcursesBackend& backend_input, const unsigned int& x,
+                                const unsigned int& y, const unsigned int& width,
+                                const unsigned int& height)
+    : backend (&backend_input), color_pairs (&backend_input.get_color_pairs()),
+      current_style (plain_style), is_visible (true), view_row (0), view_column (0)
+{
+    ncurse_window_ptr = newwin (height, width, y, x);
+    view_window_ptr = ncurse_window_ptr;
+    panel = new_panel (view_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Creates a pad width by height cells, and the WINDOW that shows the part of
+//         it in view at (x, y), on top of every other surface.  The pad is never smaller than the
+//         view.
+//--------------------------------------------------------------------------------------------------
+NcursesSurface::NcursesSurface (NcursesBackend& backend_input, const unsigned int& x,
+                                const unsigned int& y, const unsigned int& view_width,
+                                const unsigned int& view_height, const unsigned int& width,
+                                const unsigned int& height)
+    : backend (&backend_input), color_pairs (&backend_input.get_color_pairs()),
+      current_style (plain_style), is_visible (true), view_row (0), view_column (0)
+{
+    ncurse_window_ptr = newpad (height > view_height ? height : view_height,
+                                width > view_width ? width : view_width);
+    view_window_ptr = newwin (view_height, view_width, y, x);
+    panel = new_panel (view_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destructor - Hands the panel and WINDOWs back to nCurses.  Whatever the surface covered
+//         is painted back by the next update().
+//--------------------------------------------------------------------------------------------------
+NcursesSurface::~NcursesSurface()
+{
+    del_panel (panel);
+    backend->mark_panels_changed();
+
+    if (view_window_ptr != ncurse_window_ptr)
+        delwin (view_window_ptr);
+
+    delwin (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes text at the cursor.  The text is written raw, never as a format: ASCII straight
+//         through waddnstr(), and anything else decoded from UTF-8 and written with waddnwstr() so
+//         nCurses places wide characters and combining marks itself.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::put_text (const char* text, const std::size_t& length)
+{
+    if (is_ascii (text, length))
+    {
+        waddnstr (ncurse_window_ptr, text, (int) length);
+        return;
+    }
+
+    wchar_t characters[wide_chunk_length];
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        std::size_t count = 0;
+
+        while (i < length && count < wide_chunk_length)
+        {
+            char32_t code_point;
+            i += decode_utf8 (text + i, length - i, code_point);
+            characters[count++] = (wchar_t) code_point;
+        }
+
+        waddnwstr (ncurse_window_ptr, characters, (int) count);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the cursor and writes text there
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::put_text_at (const unsigned int& row, const unsigned int& column,
+                                  const char* text, const std::size_t& length)
+{
+    wmove (ncurse_window_ptr, row, column);
+    put_text (text, length);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the cursor
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::move_cursor (const unsigned int& row, const unsigned int& column)
+{
+    wmove (ncurse_window_ptr, row, column);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the line the cursor is on
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_cursor_row()
+{
+    return getcury (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column the cursor is in
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_cursor_column()
+{
+    return getcurx (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the width (columns) of the surface
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_width()
+{
+    return getmaxx (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the height (lines) of the surface
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_height()
+{
+    return getmaxy (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Resizes the WINDOW and then moves it, in that order so that the panel is never moved to
+//         where it would hang off the screen.  A pad's view is moved and resized instead, and the
+//         pad keeps its size unless the view has outgrown it.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::move_and_resize (const unsigned int& x, const unsigned int& y,
+                                      const unsigned int& width, const unsigned int& height)
+{
+    if (is_visible)
+        uncover();
+
+    wresize (view_window_ptr, height, width);
+    move_panel (panel, y, x);
+    werase (ncurse_window_ptr);
+
+    if (view_window_ptr != ncurse_window_ptr)
+    {
+        unsigned int pad_height = getmaxy (ncurse_window_ptr);
+        unsigned int pad_width = getmaxx (ncurse_window_ptr);
+
+        if (height > pad_height || width > pad_width)
+            wresize (ncurse_window_ptr, height > pad_height ? height : pad_height,
+                     width > pad_width ? width : pad_width);
+
+        werase (view_window_ptr);
+        set_view_origin (view_row, view_column);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Turns scrolling past the last line on or off
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::set_scrolling (const bool& scrolling)
+{
+    scrollok (ncurse_window_ptr, scrolling ? TRUE : FALSE);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws text written from now on in style, with one wattr_set() call and only when the
+//         style actually changes
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::set_style (const Style& style)
+{
+    if (style == current_style)
+        return;
+
+    current_style = style;
+
+    attr_t attributes = A_NORMAL;
+
+    if (style.attributes & highlight_attribute)
+        attributes |= A_REVERSE;
+
+    if (style.attributes & bold_attribute)
+        attributes |= A_BOLD;
+
+    if (style.attributes & underline_attribute)
+        attributes |= A_UNDERLINE;
+
+    if (style.attributes & dim_attribute)
+        attributes |= A_DIM;
+
+    wattr_set (ncurse_window_ptr, attributes,
+               color_pairs->get_pair (style.foreground, style.background), NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws a box around the edge of the surface
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::draw_border()
+{
+    box (ncurse_window_ptr, 0, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Blanks the surface
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::erase_surface()
+{
+    werase (ncurse_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Blanks the surface and makes nCurses repaint the whole terminal on the next update, as
+//         wclear() followed by wrefresh() would
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::clear_surface()
+{
+    werase (ncurse_window_ptr);
+    clearok (curscr, TRUE);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Marks the whole surface as changed so the next refresh redraws it
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::touch_surface()
+{
+    touchwin (view_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sends the surface to the terminal now, unless it is hidden
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::refresh_surface()
+{
+    if (! is_visible)
+        return;
+
+    stage_surface();
+    backend->update();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies the surface to nCurses' virtual screen, to be sent by the next doupdate().  A
+//         covered surface is left for update_panels() instead, so it doesn't paint over the panels
+//         above it.  Hidden surfaces aren't staged.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::stage_surface()
+{
+    if (! is_visible)
+        return;
+
+    if (view_window_ptr != ncurse_window_ptr)
+        copy_view();
+
+    if (is_covered())
+        backend->mark_panels_changed();
+    else
+        wnoutrefresh (view_window_ptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Hides or shows the panel.  Showing it puts it on top of every other surface.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::set_visible (const bool& visible)
+{
+    if (visible == is_visible)
+        return;
+
+    is_visible = visible;
+
+    if (visible)
+    {
+        if (view_window_ptr != ncurse_window_ptr)
+            copy_view();
+
+        show_panel (panel);
+    }
+    else
+        hide_panel (panel);
+
+    backend->mark_panels_changed();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the surface is showing
+//--------------------------------------------------------------------------------------------------
+bool NcursesSurface::get_visible()
+{
+    return is_visible;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the surface on top of every other surface.  Does nothing while it is hidden, as
+//         top_panel() would show it.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::raise_surface()
+{
+    if (! is_visible)
+        return;
+
+    top_panel (panel);
+    backend->mark_panels_changed();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the surface beneath every other surface.  Does nothing while it is hidden, as
+//         bottom_panel() would show it.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::lower_surface()
+{
+    if (! is_visible)
+        return;
+
+    bottom_panel (panel);
+    backend->mark_panels_changed();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves a pad's view, keeping it inside the pad.  The view is copied again when the surface
+//         is next staged.
+//--------------------------------------------------------------------------------------------------
+void NcursesSurface::set_view_origin (const unsigned int& row, const unsigned int& column)
+{
+    if (view_window_ptr == ncurse_window_ptr)
+        return;
+
+    unsigned int pad_height = getmaxy (ncurse_window_ptr);
+    unsigned int pad_width = getmaxx (ncurse_window_ptr);
+    unsigned int view_height = getmaxy (view_window_ptr);
+    unsigned int view_width = getmaxx (view_window_ptr);
+    unsigned int max_row = pad_height > view_height ? pad_height - view_height : 0;
+    unsigned int max_column = pad_width > view_width ? pad_width - view_width : 0;
+
+    view_row = row < max_row ? row : max_row;
+    view_column = column < max_column ? column : max_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the row of the pad shown at the top of the view
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_view_row()
+{
+    return view_row;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column of the pad shown at the left of the view
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesSurface::get_view_column()
+{
+    return view_column;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Waits for a key typed into this surface.  Whatever was drawn on the surface and not yet
+//         refreshed is shown first, as wgetch() would show it.
+//--------------------------------------------------------------------------------------------------
+int NcursesSurface::read_key()
+{
+    if (is_wintouched (ncurse_window_ptr))
+        refresh_surface();
+
+    return backend->read_key();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Settings shared by both constructors once nCurses has started
+//--------------------------------------------------------------------------------------------------
+void NcursesBackend::set_up_terminal()
+{
+    refresh();
+
+    // Set noecho so that input isn't automatically inserted into a window by nCurses when wgetch()
+    // is called from within a Window.  We have our own custom input method, live_input(), that
+    // inserts the text received from wgetch() into the correct window.
+    noecho();
+
+    // Keys are read through a pad, which wgetch() never refreshes, and arrive with arrow keys,
+    // function keys and the like as single key codes
+    input_pad = newpad (1, 1);
+    keypad (input_pad, TRUE);
+    is_panel_update_pending = false;
+
+    // Color pairs are only set up as styles that use them are drawn
+    color_pairs.start();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Sets up nCurses on the terminal
+//--------------------------------------------------------------------------------------------------
+NcursesBackend::NcursesBackend()
+{
+    // Take the character set from the environment, so nCurses knows the terminal speaks UTF-8
+    setlocale (LC_CTYPE, "");
+
+    // start nCurses
+    initscr();
+    screen = NULL;
+    input_descriptor = STDIN_FILENO;
+
+    set_up_terminal();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Sets up nCurses to write to output_file and read from input_file, as if
+//         they were a terminal of type terminal_type (for example "xterm").  Both files must stay
+//         open for the lifetime of the backend.  Throws std::runtime_error if nCurses can't start
+//         on them, for example because terminfo has no such terminal type.
+//--------------------------------------------------------------------------------------------------
+NcursesBackend::NcursesBackend (FILE* output_file, FILE* input_file, const char* terminal_type)
+{
+    // Take the character set from the environment, so nCurses knows the terminal speaks UTF-8
+    setlocale (LC_CTYPE, "");
+
+    // start nCurses
+    screen = newterm (terminal_type, output_file, input_file);
+
+    if (screen == NULL)
+        throw std::runtime_error (std::string ("nCurses could not start a terminal of type ") +
+                                  (terminal_type != NULL ? terminal_type : "$TERM"));
+
+    input_descriptor = fileno (input_file);
+
+    set_up_terminal();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destructor - Closes down nCurses
+//--------------------------------------------------------------------------------------------------
+NcursesBackend::~NcursesBackend()
+{
+    delwin (input_pad);
+    endwin();
+
+    if (screen != NULL)
+        delscreen (screen);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Creates a new nCurses window
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Surface> NcursesBackend::make_surface (const unsigned int& x, const unsigned int& y,
+                                                       const unsigned int& width,
+                                                       const unsigned int& height)
+{
+    return std::unique_ptr<Surface> (new NcursesSurface (*this, x, y, width, height));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Creates a new nCurses pad and the window that shows it
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<Surface> NcursesBackend::make_pad_surface (const unsigned int& x,
+                                                           const unsigned int& y,
+                                                           const unsigned int& view_width,
+                                                           const unsigned int& view_height,
+                                                           const unsigned int& width,
+                                                           const unsigned int& height)
+{
+    return std::unique_ptr<Surface> (new NcursesSurface (*this, x, y, view_width, view_height,
+                                                         width, height));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sends everything staged with wnoutrefresh() to the terminal in one go, after having the
+//         panel library stage the covered surfaces and whatever the stack uncovered
+//--------------------------------------------------------------------------------------------------
+void NcursesBackend::update()
+{
+    if (is_panel_update_pending)
+    {
+        update_panels();
+        is_panel_update_pending = false;
+    }
+
+    doupdate();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the width (columns) of the terminal, which nCurses updates when it is resized
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesBackend::get_screen_width()
+{
+    return COLS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the height (lines) of the terminal, which nCurses updates when it is resized
+//--------------------------------------------------------------------------------------------------
+unsigned int NcursesBackend::get_screen_height()
+{
+    return LINES;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Waits for a key typed anywhere
+//--------------------------------------------------------------------------------------------------
+int NcursesBackend::read_key()
+{
+    int key = decode_key (wgetch (input_pad));
+
+    // A resized terminal has to be painted again from every panel
+    if (key == key_resize)
+        is_panel_update_pending = true;
+
+    return key;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Waits at most timeout_milliseconds for a key typed anywhere.  Keys typed while nothing
+//         was reading are kept by the terminal driver, so none are lost between calls.
+//--------------------------------------------------------------------------------------------------
+int NcursesBackend::poll_key (const unsigned int& timeout_milliseconds)
+{
+    wtimeout (input_pad, (int) timeout_milliseconds);
+    int key = decode_key (wgetch (input_pad));
+    wtimeout (input_pad, -1);
+
+    if (key == key_resize)
+        is_panel_update_pending = true;
+
+    return key;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Throws away any keys that were typed but not read yet
+//--------------------------------------------------------------------------------------------------
+void NcursesBackend::discard_typeahead()
+{
+    flushinp();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the descriptor of the terminal nCurses reads keys from
+//--------------------------------------------------------------------------------------------------
+int NcursesBackend::get_input_descriptor()
+{
+    return input_descriptor;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many color pairs styles have needed set up so far
+//--------------------------------------------------------------------------------------------------
+unsigned long int NcursesBackend::get_color_pair_count()
+{
+    return color_pairs.get_allocation_count();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the color pairs every surface draws in
+//--------------------------------------------------------------------------------------------------
+ColorPairCache& NcursesBackend::get_color_pairs()
+{
+    return color_pairs;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Has the next update() call update_panels() before doupdate()
+//--------------------------------------------------------------------------------------------------
+void NcursesBackend::mark_panels_changed()
+{
+    is_panel_update_pending = true;
+}
@@ -0,0 +1,173 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        NcursesBackend.hpp
+// Description: The default Backend, which draws to the terminal using nCurses
+// Notes:       Constructing an NcursesBackend starts nCurses with initscr() and destroying it ends
+//              nCurses with endwin(), so only one may exist at a time and every Surface it makes
+//              must be destroyed before it is.  The newterm() constructor draws to any pair of
+//              files instead of the terminal, so the library can be benchmarked headless.  Text is
+//              UTF-8 and is drawn through the wide character functions of nCursesW.
+//
+//              Every surface is a panel, so the panel library keeps overlapping surfaces in order.
+//              A surface that nothing covers is staged with wnoutrefresh() as before; one that is
+//              covered, and every change to the stack, waits for update_panels() in update(),
+//              which only copies what changed and the parts of the surfaces above that it touched.
+//              A pad can't be a panel, so a pad surface is drawn on a pad and the part in view is
+//              copied into a panel window with copywin() when it is staged.  Keys are read through
+//              a pad of their own, as wgetch() on any other window refreshes it and would paint it
+//              over the panels above it.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef NcursesBackend_hpp
+#define NcursesBackend_hpp
+
+#include <cstdio>
+
+// Ask for the wide character functions, so UTF-8 text can be drawn a character at a time
+#ifndef NCURSES_WIDECHAR
+#define NCURSES_WIDECHAR 1
+#endif
+
+#include <ncurses.h>
+#include <panel.h>
+#include "Backend.hpp"
+
+// Hands out an nCurses color pair for each foreground and background combination the first time it
+// is drawn, and the same pair every time after that, so init_pair() is only ever called once per
+// combination and never for colors nobody uses
+class ColorPairCache
+{
+private:
+    // The pair of each combination, or unassigned_pair until the combination is first drawn
+    static const short unassigned_pair = -1;
+
+    short pairs[color_count][color_count];
+    short next_pair;
+    bool has_default_colors;
+    bool is_color_available;
+    unsigned long int allocation_count;
+
+    // Private methods
+    short get_color_number (const Color& color, const bool& is_foreground);
+
+public:
+    ColorPairCache();
+
+    void start();
+    short get_pair (const Color& foreground, const Color& background);
+    unsigned long int get_allocation_count();
+};
+
+class NcursesBackend;
+
+class NcursesSurface : public Surface
+{
+private:
+    NcursesBackend* backend;
+    ColorPairCache* color_pairs;
+    Style current_style;
+    bool is_visible;
+
+    // Text is drawn on ncurse_window_ptr and shown through the panel on view_window_ptr.  They are
+    // the same window, except for pads.
+    WINDOW* ncurse_window_ptr;
+    WINDOW* view_window_ptr;
+    PANEL* panel;
+    unsigned int view_row;
+    unsigned int view_column;
+
+    // Private methods
+    bool is_covered();
+    void uncover();
+    void copy_view();
+
+public:
+    NcursesSurface (NcursesBackend& backend_input, const unsigned int& x, const unsigned int& y,
+                    const unsigned int& width, const unsigned int& height);
+    NcursesSurface (NcursesBackend& backend_input, const unsigned int& x, const unsigned int& y,
+                    const unsigned int& view_width, const unsigned int& view_height,
+                    const unsigned int& width, const unsigned int& height);
+    ~NcursesSurface();
+
+    void put_text (const char* text, const std::size_t& length) override;
+    void put_text_at (const unsigned int& row, const unsigned int& column,
+                      const char* text, const std::size_t& length) override;
+    void move_cursor (const unsigned int& row, const unsigned int& column) override;
+    unsigned int get_cursor_row() override;
+    unsigned int get_cursor_column() override;
+
+    unsigned int get_width() override;
+    unsigned int get_height() override;
+    void move_and_resize (const unsigned int& x, const unsigned int& y,
+                          const unsigned int& width, const unsigned int& height) override;
+
+    void set_scrolling (const bool& scrolling) override;
+    void set_style (const Style& style) override;
+    void draw_border() override;
+
+    void erase_surface() override;
+    void clear_surface() override;
+    void touch_surface() override;
+
+    void refresh_surface() override;
+    void stage_surface() override;
+
+    void set_visible (const bool& visible) override;
+    bool get_visible() override;
+    void raise_surface() override;
+    void lower_surface() override;
+
+    void set_view_origin (const unsigned int& row, const unsigned int& column) override;
+    unsigned int get_view_row() override;
+    unsigned int get_view_column() override;
+
+    int read_key() override;
+};
+
+class NcursesBackend : public Backend
+{
+private:
+    SCREEN* screen;
+    ColorPairCache color_pairs;
+    int input_descriptor;
+    WINDOW* input_pad;
+    bool is_panel_update_pending;
+
+    // Private methods
+    void set_up_terminal();
+
+public:
+    NcursesBackend();
+    NcursesBackend (FILE* output_file, FILE* input_file, const char* terminal_type);
+    ~NcursesBackend();
+
+    std::unique_ptr<Surface> make_surface (const unsigned int& x, const unsigned int& y,
+                                           const unsigned int& width,
+                                           const unsigned int& height) override;
+    std::unique_ptr<Surface> make_pad_surface (const unsigned int& x, const unsigned int& y,
+                                               const unsigned int& view_width,
+                                               const unsigned int& view_height,
+                                               const unsigned int& width,
+                                               const unsigned int& height) override;
+
+    void update() override;
+
+    unsigned int get_screen_width() override;
+    unsigned int get_screen_height() override;
+
+    int read_key() override;
+    int poll_key (const unsigned int& timeout_milliseconds) override;
+    void discard_typeahead() override;
+    int get_input_descriptor() override;
+
+    // How many color pairs have been set up with init_pair()
+    unsigned long int get_color_pair_count();
+
+    // For NcursesSurface: the color pairs surfaces draw in, and a way to have the next update()
+    // lay the panels out again because one was covered, moved or restacked
+    ColorPairCache& get_color_pairs();
+    void mark_panels_changed();
+};
+
+#endif /* NcursesBackend_hpp */
@@ -0,0 +1,184 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Stats.cpp
+// Description: Counters and latency histograms for how much work the UI does, and the snapshots
+//              of them that UI::get_stats() hands out.
+// Notes:       A histogram bucket is picked from the position of a duration's highest set bit and
+//              the two bits below it, so recording one costs a few instructions and no search.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "Stats.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the histogram bucket a duration falls in
+//--------------------------------------------------------------------------------------------------
+static unsigned int get_bucket (const unsigned long int& nanoseconds)
+{
+    if (nanoseconds < 4)
+        return nanoseconds;
+
+    unsigned int high_bit = 63 - __builtin_clzl (nanoseconds);
+    unsigned int bucket = 4 + (high_bit - 2) * 4 + ((nanoseconds >> (high_bit - 2)) & 3);
+
+    return bucket < histogram_bucket_count ? bucket : histogram_bucket_count - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the longest duration that falls in a histogram bucket
+//--------------------------------------------------------------------------------------------------
+static unsigned long int get_bucket_limit (const unsigned int& bucket)
+{
+    if (bucket < 4)
+        return bucket;
+
+    unsigned int high_bit = (bucket - 4) / 4 + 2;
+    unsigned long int step = 1UL << (high_bit - 2);
+
+    return (1UL << high_bit) + ((bucket - 4) % 4 + 1) * step - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Starts at 0
+//--------------------------------------------------------------------------------------------------
+StatCounter::StatCounter()
+    : value (0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Adds to the counter.  Only the one thread that owns the counter may call this.
+//--------------------------------------------------------------------------------------------------
+void StatCounter::add (const unsigned long int& amount)
+{
+    value.store (value.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Raises the counter to amount if it is lower, for counters that keep a maximum.  Only the
+//         one thread that owns the counter may call this.
+//--------------------------------------------------------------------------------------------------
+void StatCounter::raise_to (const unsigned long int& amount)
+{
+    if (amount > value.load (std::memory_order_relaxed))
+        value.store (amount, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the counter's value.  Safe from any thread.
+//--------------------------------------------------------------------------------------------------
+unsigned long int StatCounter::get()
+{
+    return value.load (std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - An empty histogram
+//--------------------------------------------------------------------------------------------------
+HistogramSnapshot::HistogramSnapshot()
+    : count (0), total_nanoseconds (0), max_nanoseconds (0), buckets()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Adds another histogram's durations to this one
+//--------------------------------------------------------------------------------------------------
+void HistogramSnapshot::merge (const HistogramSnapshot& other)
+{
+    count += other.count;
+    total_nanoseconds += other.total_nanoseconds;
+
+    if (other.max_nanoseconds > max_nanoseconds)
+        max_nanoseconds = other.max_nanoseconds;
+
+    for (unsigned int i = 0; i < histogram_bucket_count; i++)
+        buckets[i] += other.buckets[i];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the duration that fraction of the recorded durations were no longer than, for
+//         example 0.99 for the 99th percentile.  Returns 0 if nothing was recorded.
+//--------------------------------------------------------------------------------------------------
+unsigned long int HistogramSnapshot::get_percentile (const double& fraction) const
+{
+    if (count == 0)
+        return 0;
+
+    unsigned long int wanted = (unsigned long int) (fraction * count + 0.5);
+    unsigned long int seen = 0;
+
+    if (wanted == 0)
+        wanted = 1;
+
+    for (unsigned int i = 0; i < histogram_bucket_count; i++)
+    {
+        seen += buckets[i];
+
+        if (seen >= wanted)
+        {
+            unsigned long int limit = get_bucket_limit (i);
+            return limit < max_nanoseconds ? limit : max_nanoseconds;
+        }
+    }
+
+    return max_nanoseconds;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the mean of the recorded durations, or 0 if nothing was recorded
+//--------------------------------------------------------------------------------------------------
+unsigned long int HistogramSnapshot::get_mean() const
+{
+    if (count == 0)
+        return 0;
+
+    return total_nanoseconds / count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - An empty histogram
+//--------------------------------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram()
+{
+    for (unsigned int i = 0; i < histogram_bucket_count; i++)
+        buckets[i].store (0, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Records one duration.  Only the one thread that owns the histogram may call this.
+//--------------------------------------------------------------------------------------------------
+void LatencyHistogram::record (const unsigned long int& nanoseconds)
+{
+    std::atomic<unsigned long int>& bucket = buckets[get_bucket (nanoseconds)];
+
+    bucket.store (bucket.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    count.add (1);
+    total_nanoseconds.add (nanoseconds);
+    max_nanoseconds.raise_to (nanoseconds);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Records how long it has been since start
+//--------------------------------------------------------------------------------------------------
+void LatencyHistogram::record_since (const StatClock::time_point& start)
+{
+    record (std::chrono::duration_cast<std::chrono::nanoseconds> (StatClock::now() - start)
+                .count());
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies the histogram out.  Safe from any thread.
+//--------------------------------------------------------------------------------------------------
+HistogramSnapshot LatencyHistogram::get_snapshot()
+{
+    HistogramSnapshot snapshot;
+
+    snapshot.count = count.get();
+    snapshot.total_nanoseconds = total_nanoseconds.get();
+    snapshot.max_nanoseconds = max_nanoseconds.get();
+
+    for (unsigned int i = 0; i < histogram_bucket_count; i++)
+        snapshot.buckets[i] = buckets[i].load (std::memory_order_relaxed);
+
+    return snapshot;
+}
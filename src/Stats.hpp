@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Stats.hpp
+// Description: Counters and latency histograms for how much work the UI does, and the snapshots
+//              of them that UI::get_stats() hands out.
+// Notes:       Every counter and histogram has exactly one thread adding to it (the thread that
+//              draws), so adding is a relaxed load and store with no read-modify-write and no
+//              lock, and any other thread may read it at any time.  A snapshot taken while the UI
+//              is drawing is not one instant, but every number in it was true at some point.
+//
+//              Histograms keep four buckets per power of two of nanoseconds, so a percentile read
+//              from one is never more than a quarter above the real value.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Stats_hpp
+#define Stats_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+typedef std::chrono::steady_clock StatClock;
+
+// Four buckets for each power of two from 4 nanoseconds up to about 73 minutes, after four buckets
+// for 0 to 3 nanoseconds
+const unsigned int histogram_bucket_count = 164;
+
+class StatCounter
+{
+private:
+    std::atomic<unsigned long int> value;
+
+public:
+    StatCounter();
+
+    void add (const unsigned long int& amount);
+    void raise_to (const unsigned long int& amount);
+    unsigned long int get();
+};
+
+struct HistogramSnapshot
+{
+    unsigned long int count;
+    unsigned long int total_nanoseconds;
+    unsigned long int max_nanoseconds;
+    unsigned long int buckets[histogram_bucket_count];
+
+    HistogramSnapshot();
+
+    void merge (const HistogramSnapshot& other);
+    unsigned long int get_percentile (const double& fraction) const;
+    unsigned long int get_mean() const;
+};
+
+class LatencyHistogram
+{
+private:
+    std::atomic<unsigned long int> buckets[histogram_bucket_count];
+    StatCounter count;
+    StatCounter total_nanoseconds;
+    StatCounter max_nanoseconds;
+
+public:
+    LatencyHistogram();
+
+    void record (const unsigned long int& nanoseconds);
+    void record_since (const StatClock::time_point& start);
+    HistogramSnapshot get_snapshot();
+};
+
+// What one window did.  writes and bytes_written count the writes made to the window and the bytes
+// of text in them.  refresh_time times each wrefresh() or wnoutrefresh() of the window's text, and
+// update_time each doupdate() the window made by itself rather than as part of a frame.
+struct WindowStats
+{
+    unsigned int window_number;
+    unsigned long int writes;
+    unsigned long int bytes_written;
+    HistogramSnapshot refresh_time;
+    HistogramSnapshot update_time;
+};
+
+// What the whole UI did.  writes, bytes_written, refresh_time and update_time add up every window,
+// including windows since destroyed, and update_time also times the doupdate() of every frame.
+// input_latency times each burst of keys from the first key being read to the screen showing
+// what the callbacks did with them.  The queue numbers are for the render thread's write queue.
+struct UIStats
+{
+    unsigned long int writes;
+    unsigned long int bytes_written;
+    HistogramSnapshot refresh_time;
+    HistogramSnapshot update_time;
+    HistogramSnapshot input_latency;
+    std::size_t queued_writes;
+    std::size_t max_queued_writes;
+    unsigned long int dropped_writes;
+    std::vector<WindowStats> windows;
+};
+
+// The counters a window keeps for WindowStats
+struct WindowCounters
+{
+    StatCounter writes;
+    StatCounter bytes_written;
+    LatencyHistogram refresh_time;
+    LatencyHistogram update_time;
+};
+
+#endif /* Stats_hpp */
@@ -0,0 +1,307 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StreamReader.cpp
+// Description: Reads text from a file descriptor, or from a file followed by name the way tail -F
+//              follows it, and writes it into a window as it arrives.
+// Notes:       A followed file is reopened by name when the name comes to point at a different
+//              file (it was rotated), once the old file has been read to its end, and read again
+//              from the start when it shrinks (it was truncated in place).  A file that doesn't
+//              exist yet is waited for.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "StreamReader.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how many bytes at the end of text are the start of a UTF-8 character that the
+//          end of the read cut off, so they can wait for the rest of it
+//--------------------------------------------------------------------------------------------------
+static std::size_t get_cut_character_length (const char* text, const std::size_t& length)
+{
+    for (std::size_t i = 1; i <= 3 && i <= length; i++)
+    {
+        unsigned char byte = text[length - i];
+
+        // Continuation bytes are part of whatever character starts before them
+        if ((byte & 0xC0) == 0x80)
+            continue;
+
+        if (byte < 0xC0)
+            return 0;
+
+        std::size_t character_length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2;
+
+        return character_length > i ? i : 0;
+    }
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Opens the followed file.  When starting at its end, only the last buffer's worth of it
+//          is read, from the first whole line in it, the way tail starts with the last lines.
+//--------------------------------------------------------------------------------------------------
+void StreamReader::open_path (const bool& is_starting_at_end)
+{
+    descriptor = open (path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+
+    if (descriptor < 0)
+        return;
+
+    struct stat status;
+
+    if (fstat (descriptor, &status) != 0)
+    {
+        close (descriptor);
+        descriptor = -1;
+        return;
+    }
+
+    device = status.st_dev;
+    inode = status.st_ino;
+    is_pollable = ! S_ISREG (status.st_mode);
+
+    if (is_starting_at_end && ! is_pollable && status.st_size > (off_t) stream_buffer_size)
+    {
+        lseek (descriptor, status.st_size - stream_buffer_size, SEEK_SET);
+        is_skipping_partial_line = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Checks whether the followed file was rotated or truncated, once the open file has been
+//          read to its end.  Returns whether there may be more to read now: a new file was opened
+//          in place of the old one, or the old one was truncated and is read again from its start.
+//--------------------------------------------------------------------------------------------------
+bool StreamReader::check_rotation()
+{
+    struct stat status;
+
+    // Between a rotation's rename and the new file being made, the name points at nothing
+    if (stat (path.c_str(), &status) != 0)
+        return false;
+
+    if (descriptor >= 0 && status.st_dev == device && status.st_ino == inode)
+    {
+        if (lseek (descriptor, 0, SEEK_CUR) <= status.st_size)
+            return false;
+
+        lseek (descriptor, 0, SEEK_SET);
+        return true;
+    }
+
+    if (descriptor >= 0)
+        close (descriptor);
+
+    // A cut off character from the old file will never be finished
+    carried_length = 0;
+    open_path (false);
+
+    return descriptor >= 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes the first length bytes of the buffer to target.  When they hold more than
+//          max_lines lines, only the last max_lines are written, as the rest would only scroll out
+//          of the window's history again.  max_lines of 0 writes everything.
+//--------------------------------------------------------------------------------------------------
+void StreamReader::write_text (Write& target, const std::size_t& length,
+                               const unsigned int& max_lines)
+{
+    const char* text = buffer.data();
+    std::size_t start = 0;
+
+    if (is_skipping_partial_line)
+    {
+        const char* newline = (const char*) std::memchr (text, '\n', length);
+
+        if (newline == NULL)
+            return;
+
+        start = newline - text + 1;
+        is_skipping_partial_line = false;
+    }
+
+    if (max_lines > 0)
+    {
+        std::size_t end = length;
+        unsigned int line_count = 0;
+
+        // The '\n' that ends the last line doesn't start another one
+        if (end > start && text[end - 1] == '\n')
+            end--;
+
+        while (end > start)
+        {
+            const char* newline = (const char*) memrchr (text + start, '\n', end - start);
+
+            if (newline == NULL)
+                break;
+
+            end = newline - text;
+
+            // A line left open by the last read is ended by keeping the '\n' before what's kept
+            if (++line_count == max_lines)
+            {
+                start = is_line_open ? end : end + 1;
+                break;
+            }
+        }
+    }
+
+    if (start >= length)
+        return;
+
+    target.write (text + start, length - start, false);
+    is_line_open = text[length - 1] != '\n';
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Reads from an open file descriptor, which stays the caller's to close once
+//         the reader is gone
+//--------------------------------------------------------------------------------------------------
+StreamReader::StreamReader (const int& descriptor_input)
+    : descriptor (descriptor_input), is_following_path (false), is_pollable (true),
+      is_finished (false), is_line_open (false), is_skipping_partial_line (false), device (0),
+      inode (0), buffer (stream_buffer_size), carried_length (0),
+      next_check_time (std::chrono::steady_clock::now())
+{
+    struct stat status;
+
+    if (fstat (descriptor, &status) == 0)
+        is_pollable = ! S_ISREG (status.st_mode);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Follows the file a path names, starting from its last lines
+//--------------------------------------------------------------------------------------------------
+StreamReader::StreamReader (const std::string& path_input)
+    : descriptor (-1), path (path_input), is_following_path (true), is_pollable (false),
+      is_finished (false), is_line_open (false), is_skipping_partial_line (false), device (0),
+      inode (0), buffer (stream_buffer_size), carried_length (0),
+      next_check_time (std::chrono::steady_clock::now())
+{
+    open_path (true);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destructor - Closes the followed file.  Descriptors handed in are left open.
+//--------------------------------------------------------------------------------------------------
+StreamReader::~StreamReader()
+{
+    if (is_following_path && descriptor >= 0)
+        close (descriptor);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the descriptor to poll() for this reader, or -1 if it is read on a timer instead
+//--------------------------------------------------------------------------------------------------
+int StreamReader::get_poll_descriptor()
+{
+    if (! is_pollable || is_finished)
+        return -1;
+
+    return descriptor;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many milliseconds until a reader that is read on a timer is due to be read
+//--------------------------------------------------------------------------------------------------
+unsigned int StreamReader::get_milliseconds_until_check()
+{
+    std::chrono::steady_clock::duration remaining = next_check_time
+                                                    - std::chrono::steady_clock::now();
+
+    if (remaining <= std::chrono::steady_clock::duration::zero())
+        return 0;
+
+    return std::chrono::duration_cast<std::chrono::milliseconds> (remaining).count() + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the other end of a pipe or socket was closed and everything sent through
+//         it has been read
+//--------------------------------------------------------------------------------------------------
+bool StreamReader::get_finished()
+{
+    return is_finished;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Reads whatever has arrived and writes it to target, keeping at most max_lines lines of
+//         any one read.  is_readable says whether poll() found the descriptor readable; readers
+//         on a timer ignore it and do nothing until they are due.  Returns the bytes read.
+//--------------------------------------------------------------------------------------------------
+unsigned long int StreamReader::read_into (Write& target, const unsigned int& max_lines,
+                                           const bool& is_readable)
+{
+    if (is_finished || (is_pollable && ! is_readable))
+        return 0;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (! is_pollable && now < next_check_time)
+        return 0;
+
+    if (descriptor < 0 && ! (is_following_path && check_rotation()))
+    {
+        next_check_time = now + std::chrono::milliseconds (stream_check_interval_milliseconds);
+        return 0;
+    }
+
+    unsigned long int total = 0;
+
+    while (total < max_stream_read_size)
+    {
+        ssize_t count = read (descriptor, &buffer[carried_length], buffer.size() - carried_length);
+
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        if (count > 0)
+        {
+            std::size_t length = carried_length + count;
+            std::size_t cut_length = get_cut_character_length (buffer.data(), length);
+
+            write_text (target, length - cut_length, max_lines);
+
+            std::memmove (&buffer[0], &buffer[length - cut_length], cut_length);
+            carried_length = cut_length;
+            total += count;
+
+            // A pipe is only read once for each time poll() says it is readable, so it never blocks
+            if (is_pollable)
+                break;
+
+            continue;
+        }
+
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        // A closed pipe has sent everything it ever will, a cut off character included
+        if (is_pollable)
+        {
+            if (carried_length > 0)
+                target.write (buffer.data(), carried_length, false);
+
+            carried_length = 0;
+            is_finished = true;
+            break;
+        }
+
+        // A file may have been rotated or truncated since it was last read to its end
+        if (is_following_path && check_rotation())
+            continue;
+
+        next_check_time = now + std::chrono::milliseconds (stream_check_interval_milliseconds);
+        break;
+    }
+
+    return total;
+}
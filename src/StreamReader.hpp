@@ -0,0 +1,70 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StreamReader.hpp
+// Description: Reads text from a file descriptor, or from a file followed by name the way tail -F
+//              follows it, and writes it into a window as it arrives.
+// Notes:       Text is read into one buffer that is reused for the life of the reader, and each
+//              read is handed to the window as a single write, '\n's and all, so lines are never
+//              copied out one at a time and the window refreshes once per read rather than once per
+//              line.  A read that holds more lines than the window remembers skips straight to the
+//              lines it will keep.
+//
+//              Pipes, sockets and terminals are read once each time poll() says they are readable,
+//              so reading them never blocks.  Regular files are always readable to poll(), so they
+//              are read until their end and then checked again on a timer.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef StreamReader_hpp
+#define StreamReader_hpp
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+#include "Write.hpp"
+
+// Bytes read from a stream at a time
+const std::size_t stream_buffer_size = 65536;
+
+// The most bytes one read_into() takes from a file, so one busy file can't hold up everything else
+const std::size_t max_stream_read_size = 1048576;
+
+// How often a file that has been read to its end is checked for more text, or for being rotated
+const unsigned int stream_check_interval_milliseconds = 100;
+
+class StreamReader
+{
+private:
+    int descriptor;
+    const std::string path;
+    const bool is_following_path;
+    bool is_pollable;
+    bool is_finished;
+    bool is_line_open;
+    bool is_skipping_partial_line;
+    dev_t device;
+    ino_t inode;
+    std::vector<char> buffer;
+    std::size_t carried_length;
+    std::chrono::steady_clock::time_point next_check_time;
+
+    // Private methods
+    void open_path (const bool& is_starting_at_end);
+    bool check_rotation();
+    void write_text (Write& target, const std::size_t& length, const unsigned int& max_lines);
+
+public:
+    StreamReader (const int& descriptor_input);
+    StreamReader (const std::string& path_input);
+    ~StreamReader();
+
+    int get_poll_descriptor();
+    unsigned int get_milliseconds_until_check();
+    bool get_finished();
+    unsigned long int read_into (Write& target, const unsigned int& max_lines,
+                                 const bool& is_readable);
+};
+
+#endif /* StreamReader_hpp */
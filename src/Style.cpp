@@ -0,0 +1,57 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Style.cpp
+// Description: The colors and attributes text can be written in, and the spans that say which part
+//              of a write is drawn in which style.
+// Notes:       A packed style keeps the attribute bits in the low byte, so plain_style packs to 0
+//              and highlighted_style to highlight_attribute.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "Style.hpp"
+
+// Where each part of a style sits in its packed form
+const unsigned int attribute_mask = 0xFF;
+const unsigned int foreground_shift = 8;
+const unsigned int background_shift = 12;
+const unsigned int color_mask = 0xF;
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether two styles draw text the same way
+//--------------------------------------------------------------------------------------------------
+bool operator== (const Style& left, const Style& right)
+{
+    return left.foreground == right.foreground && left.background == right.background &&
+           left.attributes == right.attributes;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether two styles draw text differently
+//--------------------------------------------------------------------------------------------------
+bool operator!= (const Style& left, const Style& right)
+{
+    return ! (left == right);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Packs a style into a single unsigned int
+//--------------------------------------------------------------------------------------------------
+unsigned int pack_style (const Style& style)
+{
+    return (style.attributes & attribute_mask) |
+           ((unsigned int) style.foreground << foreground_shift) |
+           ((unsigned int) style.background << background_shift);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Unpacks a style packed by pack_style()
+//--------------------------------------------------------------------------------------------------
+Style unpack_style (const unsigned int& packed_style)
+{
+    Style style;
+    style.foreground = (Color) ((packed_style >> foreground_shift) & color_mask);
+    style.background = (Color) ((packed_style >> background_shift) & color_mask);
+    style.attributes = packed_style & attribute_mask;
+
+    return style;
+}
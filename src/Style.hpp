@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Style.hpp
+// Description: The colors and attributes text can be written in, and the spans that say which part
+//              of a write is drawn in which style.
+// Notes:       A style packs into a single unsigned int, which is how the MemoryBackend stores it
+//              in each cell and how frames compare cells, so two cells in the same style always
+//              compare equal and a run of them is sent with one style switch.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Style_hpp
+#define Style_hpp
+
+#include <cstddef>
+
+// The eight standard terminal colors, plus whatever the terminal uses when none is asked for
+enum class Color : unsigned char
+{
+    default_color, black, red, green, yellow, blue, magenta, cyan, white
+};
+
+const unsigned int color_count = 9;
+
+// Attribute bits of a style
+const unsigned int highlight_attribute = 1; // Reverse video
+const unsigned int bold_attribute = 2;
+const unsigned int underline_attribute = 4;
+const unsigned int dim_attribute = 8;
+
+struct Style
+{
+    Color foreground;
+    Color background;
+    unsigned int attributes;
+};
+
+bool operator== (const Style& left, const Style& right);
+bool operator!= (const Style& left, const Style& right);
+
+const Style plain_style = { Color::default_color, Color::default_color, 0 };
+const Style highlighted_style = { Color::default_color, Color::default_color, highlight_attribute };
+
+// Part of a write drawn in a style.  start and length are in bytes.  Spans are given in order and
+// don't overlap; text outside every span is drawn in plain_style.
+struct StyleSpan
+{
+    std::size_t start;
+    std::size_t length;
+    Style style;
+};
+
+unsigned int pack_style (const Style& style);
+Style unpack_style (const unsigned int& packed_style);
+
+#endif /* Style_hpp */
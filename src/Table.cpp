@@ -0,0 +1,202 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Table.cpp
+// Description: A virtualized list/table view that draws a Window's rows on demand from a callback,
+//              so data sets of millions of rows can be browsed without ever being stored.
+// Notes:       Only the rows currently visible in the window are requested from the cell source
+//              and drawn.  Jumping to any row is constant time, and one line buffer is reused for
+//              every row drawn.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include "Table.hpp"
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the highest row that can be at the top of the window while still filling it
+//--------------------------------------------------------------------------------------------------
+unsigned long int Table::get_max_top_row()
+{
+    unsigned long int height = window.get_height();
+
+    return row_count > height ? row_count - height : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Scrolls the view by as little as possible so that the selected row is on screen
+//--------------------------------------------------------------------------------------------------
+void Table::keep_selection_visible()
+{
+    unsigned long int height = window.get_height();
+
+    if (selected_row < top_row)
+        top_row = selected_row;
+    else if (height > 0 && selected_row >= top_row + height)
+        top_row = selected_row - height + 1;
+
+    if (top_row > get_max_top_row())
+        top_row = get_max_top_row();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Lays out one row's cells into line_buffer, each cut off or padded to its column's width
+//          in display columns and separated by a single space.  Returns the length of the line in
+//          bytes.
+//--------------------------------------------------------------------------------------------------
+std::size_t Table::build_line (const unsigned long int& row)
+{
+    unsigned int line_width = window.get_width();
+    std::size_t length = 0;
+    unsigned int line_columns = 0;
+
+    for (unsigned int column = 0; column < column_widths.size(); column++)
+    {
+        if (column > 0 && line_columns < line_width && length < line_buffer.size())
+        {
+            line_buffer[length++] = ' ';
+            line_columns++;
+        }
+
+        std::string cell = cell_source (row, column);
+        std::size_t width = column_widths[column];
+
+        if (width > line_width - line_columns)
+            width = line_width - line_columns;
+
+        if (width > line_buffer.size() - length)
+            width = line_buffer.size() - length;
+
+        // Whatever the cell holds, leave enough of the buffer for its padding
+        std::size_t room = line_buffer.size() - length - width;
+        std::size_t copied = get_fitting_length (cell.data(), std::min (cell.size(), room),
+                                                 width);
+        std::size_t padding = width - get_display_width (cell.data(), copied);
+
+        cell.copy (&line_buffer[length], copied);
+        std::fill (line_buffer.begin() + length + copied,
+                   line_buffer.begin() + length + copied + padding, ' ');
+
+        length += copied + padding;
+        line_columns += width;
+    }
+
+    return length;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Shows the first rows of the table with the first row selected.  Nothing is
+//         drawn until refresh_rows() is called.
+//--------------------------------------------------------------------------------------------------
+Table::Table (Window& window_input, const std::vector<unsigned int>& column_widths_input,
+              const unsigned long int& row_count_input, const CellSource& cell_source_input)
+    : window (window_input), column_widths (column_widths_input), cell_source (cell_source_input),
+      row_count (row_count_input), top_row (0), selected_row (0),
+      line_buffer ((std::size_t) window_input.get_width() * max_bytes_per_column)
+{
+
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Changes how many rows the table has, keeping the selection inside the table
+//--------------------------------------------------------------------------------------------------
+void Table::set_row_count (const unsigned long int& row_count_input)
+{
+    row_count = row_count_input;
+
+    if (row_count == 0)
+        selected_row = 0;
+    else if (selected_row >= row_count)
+        selected_row = row_count - 1;
+
+    keep_selection_visible();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Selects a row and scrolls it to the top of the window, or as near the top as it can go
+//         while the window stays full.  Rows past the end select the last row.
+//--------------------------------------------------------------------------------------------------
+void Table::jump_to_row (const unsigned long int& row)
+{
+    if (row_count == 0)
+        return;
+
+    selected_row = row < row_count ? row : row_count - 1;
+    top_row = selected_row < get_max_top_row() ? selected_row : get_max_top_row();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves the selection up (negative) or down (positive) by a number of rows, stopping at the
+//         first and last rows, and scrolls just enough to keep it on screen
+//--------------------------------------------------------------------------------------------------
+void Table::move_selection (const long int& rows)
+{
+    if (row_count == 0)
+        return;
+
+    if (rows < 0)
+    {
+        unsigned long int distance = (unsigned long int) (-(rows + 1)) + 1;
+        selected_row = distance < selected_row ? selected_row - distance : 0;
+    }
+    else
+    {
+        unsigned long int distance = (unsigned long int) rows;
+        unsigned long int last_row = row_count - 1;
+        selected_row = distance < last_row - selected_row ? selected_row + distance : last_row;
+    }
+
+    keep_selection_visible();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws the visible rows, highlighting the selected one, and blanks any rows past the end
+//         of the table.  The cell source is only called for the rows on screen.
+//--------------------------------------------------------------------------------------------------
+void Table::refresh_rows()
+{
+    // The window may have been resized since the rows were last drawn
+    std::size_t buffer_size = (std::size_t) window.get_width() * max_bytes_per_column;
+
+    if (line_buffer.size() != buffer_size)
+        line_buffer.resize (buffer_size);
+
+    keep_selection_visible();
+
+    unsigned int height = window.get_height();
+
+    for (unsigned int line = 0; line < height; line++)
+    {
+        unsigned long int row = top_row + line;
+
+        if (row < row_count)
+            window.draw_line (line, line_buffer.data(), build_line (row), row == selected_row);
+        else
+            window.draw_line (line, line_buffer.data(), 0, false);
+    }
+
+    window.refresh_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of rows in the table
+//--------------------------------------------------------------------------------------------------
+unsigned long int Table::get_row_count()
+{
+    return row_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the row shown on the window's first line
+//--------------------------------------------------------------------------------------------------
+unsigned long int Table::get_top_row()
+{
+    return top_row;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the selected row
+//--------------------------------------------------------------------------------------------------
+unsigned long int Table::get_selected_row()
+{
+    return selected_row;
+}
@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Table.hpp
+// Description: A virtualized list/table view that draws a Window's rows on demand from a callback,
+//              so data sets of millions of rows can be browsed without ever being stored.
+// Notes:       Only the rows currently visible in the window are requested from the cell source
+//              and drawn.  Jumping to any row is constant time, and one line buffer is reused for
+//              every row drawn.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Table_hpp
+#define Table_hpp
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Window.hpp"
+
+// Returns the text of one cell.  Text longer than the column's width is cut off.
+typedef std::function<std::string (const unsigned long int& row, const unsigned int& column)>
+    CellSource;
+
+class Table
+{
+private:
+    Window& window;
+    std::vector<unsigned int> column_widths;
+    CellSource cell_source;
+    unsigned long int row_count;
+    unsigned long int top_row;
+    unsigned long int selected_row;
+    std::vector<char> line_buffer;
+
+    // Private methods
+    unsigned long int get_max_top_row();
+    void keep_selection_visible();
+    std::size_t build_line (const unsigned long int& row);
+
+public:
+    Table (Window& window_input, const std::vector<unsigned int>& column_widths_input,
+           const unsigned long int& row_count_input, const CellSource& cell_source_input);
+
+    void set_row_count (const unsigned long int& row_count_input);
+    void jump_to_row (const unsigned long int& row);
+    void move_selection (const long int& rows);
+    void refresh_rows();
+
+    unsigned long int get_row_count();
+    unsigned long int get_top_row();
+    unsigned long int get_selected_row();
+};
+
+#endif /* Table_hpp */
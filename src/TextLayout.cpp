@@ -0,0 +1,545 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        TextLayout.cpp
+// Description: The pieces of text layout shared by every window: measuring text in display
+//              columns, the line pieces that wrapping breaks text into, and a cache of those line
+//              pieces so text that is laid out again at the same width isn't measured again.
+// Notes:       Widths are counted in display columns, not bytes.  Text is UTF-8: most characters
+//              take one column, East Asian wide characters and emoji take two, and combining marks
+//              take none.  Pure ASCII text is measured eight bytes at a time.  Control characters
+//              other than '\n' have no width of their own; text holding them is expanded the way
+//              nCurses would draw it before it is measured.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include "TextLayout.hpp"
+
+// An inclusive range of code points
+struct CodePointRange
+{
+    char32_t first;
+    char32_t last;
+};
+
+// Characters that take no columns of their own: the common combining marks, zero width spaces and
+// joiners, and variation selectors.  Sorted, so they can be binary searched.
+static const CodePointRange zero_width_ranges[] =
+{
+    { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF },
+    { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0610, 0x061A },
+    { 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 },
+    { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED }, { 0x0711, 0x0711 }, { 0x0730, 0x074A },
+    { 0x07A6, 0x07B0 }, { 0x0900, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+    { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 }, { 0x0962, 0x0963 },
+    { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E }, { 0x1AB0, 0x1AFF },
+    { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F }, { 0x202A, 0x202E }, { 0x2060, 0x2064 },
+    { 0x20D0, 0x20FF }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF },
+    { 0xE0100, 0xE01EF }
+};
+
+// Characters that take two columns: East Asian wide and fullwidth characters, and emoji
+static const CodePointRange wide_ranges[] =
+{
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC },
+    { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 },
+    { 0x2648, 0x2653 }, { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+    { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 }, { 0x26CE, 0x26CE },
+    { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+    { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+    { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 },
+    { 0x2757, 0x2757 }, { 0x2795, 0x2797 }, { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF },
+    { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x303E },
+    { 0x3041, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF },
+    { 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 },
+    { 0xFE30, 0xFE6F }, { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+    { 0x17000, 0x18AFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF },
+    { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F202 }, { 0x1F210, 0x1F23B },
+    { 0x1F240, 0x1F248 }, { 0x1F250, 0x1F251 }, { 0x1F260, 0x1F265 }, { 0x1F300, 0x1F320 },
+    { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C }, { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA },
+    { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E },
+    { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E },
+    { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 },
+    { 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 },
+    { 0x1F6D5, 0x1F6D7 }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC }, { 0x1F7E0, 0x1F7EB },
+    { 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 }, { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAFF },
+    { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD }
+};
+
+// The high bit of every byte in a 64 bit word; a word of ASCII has none of them set
+static const std::uint64_t high_bits = 0x8080808080808080ULL;
+
+// Every byte of a 64 bit word set to one, to spread a byte value across the word
+static const std::uint64_t low_bits = 0x0101010101010101ULL;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the code point falls in one of the sorted ranges
+//--------------------------------------------------------------------------------------------------
+template <std::size_t count>
+static bool is_in_ranges (const char32_t& code_point, const CodePointRange (&ranges)[count])
+{
+    if (code_point < ranges[0].first || code_point > ranges[count - 1].last)
+        return false;
+
+    std::size_t low = 0;
+    std::size_t high = count;
+
+    while (low < high)
+    {
+        std::size_t middle = (low + high) / 2;
+
+        if (code_point > ranges[middle].last)
+            low = middle + 1;
+        else if (code_point < ranges[middle].first)
+            high = middle;
+        else
+            return true;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the eight bytes at text are all ASCII
+//--------------------------------------------------------------------------------------------------
+static bool is_ascii_word (const char* text)
+{
+    std::uint64_t word;
+    std::memcpy (&word, text, sizeof (word));
+
+    return (word & high_bits) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether any of the eight bytes at text is below ' ' or is DEL.  A byte below
+//          n sets its high bit in (word - n * low_bits) & ~word, and a borrow only ever reaches
+//          the bytes above one that does, so the test is exact.
+//--------------------------------------------------------------------------------------------------
+static bool has_control_word (const char* text)
+{
+    std::uint64_t word;
+    std::memcpy (&word, text, sizeof (word));
+
+    std::uint64_t delete_bytes = word ^ (0x7F * low_bits);
+
+    return (((word - ' ' * low_bits) & ~word) | ((delete_bytes - low_bits) & ~delete_bytes)) &
+           high_bits;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the byte is a control character other than '\n'
+//--------------------------------------------------------------------------------------------------
+static bool is_control_byte (const char& byte)
+{
+    return ((unsigned char) byte < ' ' && byte != '\n') || byte == 0x7F;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Decodes the UTF-8 character at the start of the text into code_point and returns how
+//         many bytes it took.  A byte that doesn't start a valid character decodes on its own
+//         as the replacement character, so decoding always moves forward.
+//--------------------------------------------------------------------------------------------------
+std::size_t decode_utf8 (const char* text, const std::size_t& length, char32_t& code_point)
+{
+    const unsigned char* bytes = (const unsigned char*) text;
+
+    if (bytes[0] < 0x80)
+    {
+        code_point = bytes[0];
+        return 1;
+    }
+
+    std::size_t size;
+    char32_t minimum;
+
+    if ((bytes[0] & 0xE0) == 0xC0)
+    {
+        size = 2;
+        minimum = 0x80;
+        code_point = bytes[0] & 0x1F;
+    }
+    else if ((bytes[0] & 0xF0) == 0xE0)
+    {
+        size = 3;
+        minimum = 0x800;
+        code_point = bytes[0] & 0x0F;
+    }
+    else if ((bytes[0] & 0xF8) == 0xF0)
+    {
+        size = 4;
+        minimum = 0x10000;
+        code_point = bytes[0] & 0x07;
+    }
+    else
+    {
+        code_point = replacement_character;
+        return 1;
+    }
+
+    if (size > length)
+    {
+        code_point = replacement_character;
+        return 1;
+    }
+
+    for (std::size_t i = 1; i < size; i++)
+    {
+        if ((bytes[i] & 0xC0) != 0x80)
+        {
+            code_point = replacement_character;
+            return 1;
+        }
+
+        code_point = (code_point << 6) | (bytes[i] & 0x3F);
+    }
+
+    // Overlong encodings, surrogates and code points past the end of Unicode aren't characters
+    if (code_point < minimum || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF))
+    {
+        code_point = replacement_character;
+        return 1;
+    }
+
+    return size;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Encodes the code point as UTF-8 into text, which must have room for four bytes, and
+//         returns how many bytes it took
+//--------------------------------------------------------------------------------------------------
+std::size_t encode_utf8 (const char32_t& code_point, char* text)
+{
+    if (code_point < 0x80)
+    {
+        text[0] = (char) code_point;
+        return 1;
+    }
+
+    if (code_point < 0x800)
+    {
+        text[0] = (char) (0xC0 | (code_point >> 6));
+        text[1] = (char) (0x80 | (code_point & 0x3F));
+        return 2;
+    }
+
+    if (code_point < 0x10000)
+    {
+        text[0] = (char) (0xE0 | (code_point >> 12));
+        text[1] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        text[2] = (char) (0x80 | (code_point & 0x3F));
+        return 3;
+    }
+
+    text[0] = (char) (0xF0 | (code_point >> 18));
+    text[1] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+    text[2] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+    text[3] = (char) (0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of columns a character takes on the screen: 0, 1 or 2
+// Notes:  Everything before the first combining mark takes one column, so Latin, Greek and
+//         Cyrillic text never reaches the range tables
+//--------------------------------------------------------------------------------------------------
+unsigned int get_character_width (const char32_t& code_point)
+{
+    if (code_point < zero_width_ranges[0].first)
+        return 1;
+
+    if (is_in_ranges (code_point, zero_width_ranges))
+        return 0;
+
+    if (is_in_ranges (code_point, wide_ranges))
+        return 2;
+
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the text is pure ASCII, checking eight bytes at a time
+//--------------------------------------------------------------------------------------------------
+bool is_ascii (const char* text, const std::size_t& length)
+{
+    std::size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        if (! is_ascii_word (text + i))
+            return false;
+    }
+
+    for (; i < length; i++)
+    {
+        if ((unsigned char) text[i] >= 0x80)
+            return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of columns the text takes up on the screen
+// Notes:  Runs of ASCII are counted eight bytes at a time, so ASCII text costs little more than
+//         taking its length
+//--------------------------------------------------------------------------------------------------
+unsigned int get_display_width (const char* text, const std::size_t& length)
+{
+    unsigned int columns = 0;
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        if (i + 8 <= length && is_ascii_word (text + i))
+        {
+            columns += 8;
+            i += 8;
+            continue;
+        }
+
+        if ((unsigned char) text[i] < 0x80)
+        {
+            columns++;
+            i++;
+            continue;
+        }
+
+        char32_t code_point;
+        i += decode_utf8 (text + i, length - i, code_point);
+        columns += get_character_width (code_point);
+    }
+
+    return columns;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many bytes from the start of the text fit in the given number of columns,
+//         never splitting a character.  Combining marks right after the last character that fits
+//         are kept with it.
+//--------------------------------------------------------------------------------------------------
+std::size_t get_fitting_length (const char* text, const std::size_t& length,
+                                const unsigned int& columns)
+{
+    unsigned int used = 0;
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        if (i + 8 <= length && used + 8 <= columns && is_ascii_word (text + i))
+        {
+            used += 8;
+            i += 8;
+            continue;
+        }
+
+        char32_t code_point;
+        std::size_t size = decode_utf8 (text + i, length - i, code_point);
+        unsigned int width = get_character_width (code_point);
+
+        if (used + width > columns)
+            return i;
+
+        used += width;
+        i += size;
+    }
+
+    return length;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the text holds a control character other than '\n', checking eight
+//         bytes at a time so that text without any costs little to check
+//--------------------------------------------------------------------------------------------------
+bool has_control_characters (const char* text, const std::size_t& length)
+{
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        if (i + 8 <= length && ! has_control_word (text + i))
+        {
+            i += 8;
+            continue;
+        }
+
+        std::size_t end = i + 8 <= length ? i + 8 : length;
+
+        for (; i < end; i++)
+        {
+            if (is_control_byte (text[i]))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies the text into expanded the way nCurses draws it, starting at column of a line
+//         width columns wide: a tab becomes the spaces up to the next tab stop, and any other
+//         control character but '\n' becomes a caret and a letter, such as ^M for '\r' and ^?
+//         for DEL.  positions is filled with where each byte of the text, and its end, landed in
+//         expanded, so spans over the text can be moved to match.
+//--------------------------------------------------------------------------------------------------
+void expand_control_characters (const char* text, const std::size_t& length,
+                                unsigned int column, const unsigned int& width,
+                                std::string& expanded, std::vector<std::size_t>& positions)
+{
+    expanded.clear();
+    positions.resize (length + 1);
+
+    std::size_t i = 0;
+
+    while (i < length)
+    {
+        positions[i] = expanded.size();
+
+        if (text[i] == '\n')
+        {
+            expanded.push_back ('\n');
+            column = 0;
+            i++;
+        }
+        else if (text[i] == '\t')
+        {
+            unsigned int stop = (column / tab_width + 1) * tab_width;
+
+            if (width > 0 && stop > width)
+                stop = width;
+
+            expanded.append (stop - column, ' ');
+            column = width > 0 ? stop % width : stop;
+            i++;
+        }
+        else if (is_control_byte (text[i]))
+        {
+            expanded.push_back ('^');
+            expanded.push_back (text[i] == 0x7F ? '?' : text[i] + '@');
+            column = width > 0 ? (column + 2) % width : column + 2;
+            i++;
+        }
+        else
+        {
+            char32_t code_point;
+            std::size_t size = decode_utf8 (text + i, length - i, code_point);
+
+            for (std::size_t j = 1; j < size; j++)
+                positions[i + j] = expanded.size() + j;
+
+            expanded.append (text + i, size);
+            column += get_character_width (code_point);
+
+            if (width > 0)
+                column %= width;
+
+            i += size;
+        }
+    }
+
+    positions[length] = expanded.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the entry that text laid out from column at width belongs in.  Each piece of
+//          text has exactly one entry it can be kept in, so a lookup is a single comparison.
+//--------------------------------------------------------------------------------------------------
+LineBreakCache::Entry& LineBreakCache::get_entry (const char* text, const std::size_t& length,
+                                                  const unsigned int& column,
+                                                  const unsigned int& width)
+{
+    std::size_t hash = std::hash<std::string_view>() (std::string_view (text, length));
+
+    // Width and column are each mixed into the low bits the entry is picked by, so the same text
+    // laid out at two widths, as it is on a resize, doesn't keep evicting itself
+    hash ^= width + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+    hash ^= column + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+
+    return entries[hash % entries.size()];
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Makes room for entry_count laid out pieces of text; the text and line
+//         pieces of each entry are allocated as they are first needed and then reused
+//--------------------------------------------------------------------------------------------------
+LineBreakCache::LineBreakCache (const unsigned int& entry_count)
+    : entries (entry_count > 0 ? entry_count : 1), hit_count (0), miss_count (0)
+{
+    clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the line pieces the text was broken into the last time it was laid out from the
+//         same column at the same width with the same wrapping, or NULL if they aren't kept
+//--------------------------------------------------------------------------------------------------
+std::vector<LinePiece>* LineBreakCache::find (const char* text, const std::size_t& length,
+                                              const unsigned int& column,
+                                              const unsigned int& width, const TextWrap& wrap)
+{
+    if (length > max_cached_text_length)
+        return NULL;
+
+    Entry& entry = get_entry (text, length, column, width);
+
+    if (entry.is_used && entry.column == column && entry.width == width && entry.wrap == wrap &&
+        entry.text.size() == length && std::memcmp (entry.text.data(), text, length) == 0)
+    {
+        hit_count++;
+        return &entry.pieces;
+    }
+
+    miss_count++;
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Takes over the entry for the text, replacing whatever it held, and returns its empty
+//         list of line pieces for the caller to fill in.  Returns NULL for text too long to keep.
+//--------------------------------------------------------------------------------------------------
+std::vector<LinePiece>* LineBreakCache::insert (const char* text, const std::size_t& length,
+                                                const unsigned int& column,
+                                                const unsigned int& width, const TextWrap& wrap)
+{
+    if (length > max_cached_text_length)
+        return NULL;
+
+    Entry& entry = get_entry (text, length, column, width);
+
+    entry.is_used = true;
+    entry.text.assign (text, length);
+    entry.column = column;
+    entry.width = width;
+    entry.wrap = wrap;
+    entry.pieces.clear();
+
+    return &entry.pieces;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Forgets every entry, keeping their memory for reuse
+//--------------------------------------------------------------------------------------------------
+void LineBreakCache::clear()
+{
+    for (Entry& entry : entries)
+        entry.is_used = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many lookups found their line pieces in the cache
+//--------------------------------------------------------------------------------------------------
+unsigned long int LineBreakCache::get_hit_count()
+{
+    return hit_count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many lookups had to lay their text out again
+//--------------------------------------------------------------------------------------------------
+unsigned long int LineBreakCache::get_miss_count()
+{
+    return miss_count;
+}
@@ -0,0 +1,107 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        TextLayout.hpp
+// Description: The pieces of text layout shared by every window: measuring text in display
+//              columns, the line pieces that wrapping breaks text into, and a cache of those line
+//              pieces so text that is laid out again at the same width isn't measured again.
+// Notes:       Widths are counted in display columns, not bytes.  Text is UTF-8: most characters
+//              take one column, East Asian wide characters and emoji take two, and combining marks
+//              take none.  Pure ASCII text is measured eight bytes at a time.  Control characters
+//              other than '\n' have no width of their own; text holding them is expanded the way
+//              nCurses would draw it before it is measured.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef TextLayout_hpp
+#define TextLayout_hpp
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum class TextAlignment { left, center, right };
+enum class TextWrap { character, word, truncate };
+
+// What ends a line piece: nothing (the text ran out or the piece filled its line), a wrap onto the
+// next line, or a '\n' in the text itself
+enum class LineBreak { none, soft, hard };
+
+// Shown at the end of a line that was cut short
+const char ellipsis[] = "...";
+const std::size_t ellipsis_length = sizeof (ellipsis) - 1;
+const unsigned int ellipsis_columns = 3;
+
+// One line's worth of text, by byte offset into the text it was cut from.  skip is the number of
+// bytes after the piece that are passed over without being shown: the spaces at a word wrap, the
+// part of a line that was cut off, and the '\n' of a hard break.
+struct LinePiece
+{
+    std::size_t start;
+    std::size_t length;
+    unsigned int columns;
+    std::size_t skip;
+    LineBreak line_break;
+    bool has_ellipsis;
+};
+
+// The most bytes UTF-8 text can take per column it fills, for buffers sized by width
+const unsigned int max_bytes_per_column = 4;
+
+// Shown in place of bytes that aren't valid UTF-8
+const char32_t replacement_character = 0xFFFD;
+
+// Columns between tab stops, as nCurses places them
+const unsigned int tab_width = 8;
+
+std::size_t decode_utf8 (const char* text, const std::size_t& length, char32_t& code_point);
+std::size_t encode_utf8 (const char32_t& code_point, char* text);
+unsigned int get_character_width (const char32_t& code_point);
+bool is_ascii (const char* text, const std::size_t& length);
+unsigned int get_display_width (const char* text, const std::size_t& length);
+std::size_t get_fitting_length (const char* text, const std::size_t& length,
+                                const unsigned int& columns);
+bool has_control_characters (const char* text, const std::size_t& length);
+void expand_control_characters (const char* text, const std::size_t& length,
+                                unsigned int column, const unsigned int& width,
+                                std::string& expanded, std::vector<std::size_t>& positions);
+
+// Text longer than this is laid out every time rather than copied into the cache
+const std::size_t max_cached_text_length = 256;
+
+class LineBreakCache
+{
+private:
+    struct Entry
+    {
+        bool is_used;
+        std::string text;
+        unsigned int column;
+        unsigned int width;
+        TextWrap wrap;
+        std::vector<LinePiece> pieces;
+    };
+
+    std::vector<Entry> entries;
+    unsigned long int hit_count;
+    unsigned long int miss_count;
+
+    // Private methods
+    Entry& get_entry (const char* text, const std::size_t& length, const unsigned int& column,
+                      const unsigned int& width);
+
+public:
+    LineBreakCache (const unsigned int& entry_count);
+
+    std::vector<LinePiece>* find (const char* text, const std::size_t& length,
+                                  const unsigned int& column, const unsigned int& width,
+                                  const TextWrap& wrap);
+    std::vector<LinePiece>* insert (const char* text, const std::size_t& length,
+                                    const unsigned int& column, const unsigned int& width,
+                                    const TextWrap& wrap);
+    void clear();
+
+    unsigned long int get_hit_count();
+    unsigned long int get_miss_count();
+};
+
+#endif /* TextLayout_hpp */
@@ -0,0 +1,201 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        TextPolicy.hpp
+// Description: The alignment, wrapping and refresh policies a BasicWindow is built from.
+// Notes:       Every policy is a stateless struct of constants and static inline functions, so the
+//              choice between them is made by the compiler and costs nothing per write.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef TextPolicy_hpp
+#define TextPolicy_hpp
+
+#include <cstddef>
+#include <cstring>
+#include "TextLayout.hpp"
+
+enum class RefreshMode { configured, immediate, deferred };
+
+//--------------------------------------------------------------------------------------------------
+// Alignment policies: get_offset() returns how many columns a line piece that is columns wide is
+// moved right when it is written at column of a window width columns wide.  Text that doesn't fit
+// where it would be moved to is left where it is.
+//--------------------------------------------------------------------------------------------------
+struct LeftAlign
+{
+    static constexpr TextAlignment alignment = TextAlignment::left;
+
+    static unsigned int get_offset (const unsigned int&, const unsigned int&, const unsigned int&)
+    {
+        return 0;
+    }
+};
+
+struct CenterAlign
+{
+    static constexpr TextAlignment alignment = TextAlignment::center;
+
+    static unsigned int get_offset (const unsigned int& columns, const unsigned int& column,
+                                    const unsigned int& width)
+    {
+        if (columns >= width)
+            return 0;
+
+        unsigned int offset = (width - columns) / 2;
+
+        return column + offset < width ? offset : 0;
+    }
+};
+
+struct RightAlign
+{
+    static constexpr TextAlignment alignment = TextAlignment::right;
+
+    static unsigned int get_offset (const unsigned int& columns, const unsigned int& column,
+                                    const unsigned int& width)
+    {
+        if (column + columns >= width)
+            return 0;
+
+        return width - column - columns;
+    }
+};
+
+//--------------------------------------------------------------------------------------------------
+// Wrap policies: get_piece() fills in the piece of the text that goes on the current line, starting
+// at column of a window width columns wide.  The piece's start is left to the caller.
+//--------------------------------------------------------------------------------------------------
+
+// Lines wrap wherever they reach the edge of the window, exactly as the backend lays them out
+struct CharacterWrap
+{
+    static constexpr TextWrap wrap = TextWrap::character;
+
+    static void get_piece (const char* text, const std::size_t& length, const unsigned int&,
+                           const unsigned int&, LinePiece& piece)
+    {
+        const char* end = (const char*) std::memchr (text, '\n', length);
+
+        piece.length = end != NULL ? end - text : length;
+        piece.columns = get_display_width (text, piece.length);
+        piece.skip = end != NULL ? 1 : 0;
+        piece.line_break = end != NULL ? LineBreak::hard : LineBreak::none;
+        piece.has_ellipsis = false;
+    }
+};
+
+// Lines wrap at the last space that fits, and the spaces at a wrap are dropped.  A word too long
+// for a whole line is split where the line ends.
+struct WordWrap
+{
+    static constexpr TextWrap wrap = TextWrap::word;
+
+    static void get_piece (const char* text, const std::size_t& length,
+                           const unsigned int& column, const unsigned int& width,
+                           LinePiece& piece)
+    {
+        CharacterWrap::get_piece (text, length, column, width, piece);
+
+        unsigned int room = width - column;
+
+        if (piece.columns <= room)
+            return;
+
+        // A space right after what fits still lets the line be filled exactly
+        std::size_t segment = piece.length;
+        std::size_t fit = get_fitting_length (text, segment, room);
+        std::size_t space = fit;
+
+        while (space > 0 && text[space] != ' ')
+            space--;
+
+        std::size_t end = space;
+
+        while (end > 0 && text[end - 1] == ' ')
+            end--;
+
+        // A character wider than a whole line can never be shown, so it is dropped the way History
+        // drops it, rather than carried over to one fresh line after another
+        if (end == 0 && fit == 0 && column == 0)
+        {
+            char32_t code_point;
+
+            piece.length = 0;
+            piece.columns = 0;
+            piece.skip = decode_utf8 (text, segment, code_point);
+            piece.line_break = LineBreak::none;
+
+            return;
+        }
+
+        if (end == 0)
+        {
+            // Carry the word over to a fresh line, unless it already has one to itself
+            piece.length = column > 0 ? 0 : fit;
+            piece.columns = get_display_width (text, piece.length);
+            piece.skip = 0;
+            piece.line_break = piece.columns < room ? LineBreak::soft : LineBreak::none;
+
+            return;
+        }
+
+        while (space < segment && text[space] == ' ')
+            space++;
+
+        piece.length = end;
+        piece.columns = get_display_width (text, end);
+        piece.skip = space - end;
+        piece.line_break = LineBreak::soft;
+    }
+};
+
+// Lines never wrap; whatever doesn't fit before the edge of the window is dropped, and an ellipsis
+// shows where it was cut
+struct Truncate
+{
+    static constexpr TextWrap wrap = TextWrap::truncate;
+
+    static void get_piece (const char* text, const std::size_t& length,
+                           const unsigned int& column, const unsigned int& width,
+                           LinePiece& piece)
+    {
+        CharacterWrap::get_piece (text, length, column, width, piece);
+
+        unsigned int room = width - column;
+
+        if (piece.columns <= room)
+            return;
+
+        // Too little room for an ellipsis and some text just shows what fits
+        piece.has_ellipsis = room > ellipsis_columns;
+
+        std::size_t segment = piece.length;
+        std::size_t fit = get_fitting_length (text, segment,
+                                              piece.has_ellipsis ? room - ellipsis_columns : room);
+
+        piece.length = fit;
+        piece.columns = get_display_width (text, fit);
+        piece.skip += segment - fit;
+    }
+};
+
+//--------------------------------------------------------------------------------------------------
+// Refresh policies: whether a write refreshes the window straight away, only marks it dirty for
+// the next frame, or does whichever set_deferred_refresh() last asked for (as the UI's windows do)
+//--------------------------------------------------------------------------------------------------
+struct ConfiguredRefresh
+{
+    static constexpr RefreshMode mode = RefreshMode::configured;
+};
+
+struct ImmediateRefresh
+{
+    static constexpr RefreshMode mode = RefreshMode::immediate;
+};
+
+struct DeferredRefresh
+{
+    static constexpr RefreshMode mode = RefreshMode::deferred;
+};
+
+#endif /* TextPolicy_hpp */
@@ -7,79 +7,1690 @@
 // Author:      Joseph Lyons
 //--------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cstdarg>
+#include <chrono>
+#include <cstdio>
+#include <vector>
 #include "UI.hpp"
 
+//--------------------------------------------------------------------------------------------------
+// Private: Writes a duration in nanoseconds to text in whichever unit keeps it short
+//--------------------------------------------------------------------------------------------------
+static void format_duration (const unsigned long int& nanoseconds, char* text,
+                             const std::size_t& size)
+{
+    if (nanoseconds < 1000)
+        std::snprintf (text, size, "%luns", nanoseconds);
+    else if (nanoseconds < 1000000)
+        std::snprintf (text, size, "%.1fus", nanoseconds / 1e3);
+    else if (nanoseconds < 1000000000)
+        std::snprintf (text, size, "%.1fms", nanoseconds / 1e6);
+    else
+        std::snprintf (text, size, "%.1fs", nanoseconds / 1e9);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the slot a window handle refers to
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_slot_index (const unsigned int& window_number)
+{
+    return window_number & window_slot_mask;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the generation the slot had when the window handle was given out
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_slot_generation (const unsigned int& window_number)
+{
+    return window_number >> window_generation_shift;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the window a handle refers to, or NULL if the handle was never given out or its
+//          window has since been destroyed.  Constant time.
+//--------------------------------------------------------------------------------------------------
+Window* UI::get_window (const unsigned int& window_number)
+{
+    unsigned int slot_index = get_slot_index (window_number);
+
+    if (slot_index >= window_slots.size())
+        return NULL;
+
+    WindowSlot& slot = window_slots[slot_index];
+
+    if (slot.generation != get_slot_generation (window_number))
+        return NULL;
+
+    return slot.window.get();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the table attached to the window a handle refers to, or NULL if the handle is
+//          not valid or the window has no table
+//--------------------------------------------------------------------------------------------------
+Table* UI::get_table (const unsigned int& window_number)
+{
+    if (get_window (window_number) == NULL)
+        return NULL;
+
+    return window_slots[get_slot_index (window_number)].table.get();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Private: Ensures window is a valid choice
 //--------------------------------------------------------------------------------------------------
-bool UI::window_is_valid (const unsigned int& window_number)
+bool UI::window_is_valid (const unsigned int& window_number)
+{
+    return get_window (window_number) != NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Prints an error stating the window is invalid
+//--------------------------------------------------------------------------------------------------
+void UI::print_error()
+{
+    write_to_all_windows ("Invalid Window Requested", true);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Flushes any pending batched refreshes.  Called automatically at the points where a frame
+//          naturally ends, such as right before blocking for keyboard input.
+//--------------------------------------------------------------------------------------------------
+void UI::end_frame()
+{
+    if (is_batched_refresh)
+        flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how long until the next frame is due at the target frame rate.  Without a
+//          target frame rate, frames are drawn as often as the event loop wakes up, which is at
+//          least every 100 milliseconds.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_milliseconds_until_frame()
+{
+    const unsigned int idle_wait_milliseconds = 100;
+
+    unsigned int fps = target_fps.load (std::memory_order_relaxed);
+
+    if (fps == 0)
+        return idle_wait_milliseconds;
+
+    std::chrono::steady_clock::duration frame_period = std::chrono::seconds (1);
+    frame_period /= fps;
+
+    std::chrono::steady_clock::duration remaining =
+        last_flush_time + frame_period - std::chrono::steady_clock::now();
+
+    if (remaining <= std::chrono::steady_clock::duration::zero())
+        return 0;
+
+    return std::chrono::duration_cast<std::chrono::milliseconds> (remaining).count();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Turns a key code into an event and hands it to the callbacks that should get it.  The
+//          callback is copied before it is called, so it may safely replace itself or destroy its
+//          window.
+//--------------------------------------------------------------------------------------------------
+void UI::dispatch_input (const int& key)
+{
+    InputEvent event;
+    event.key = key;
+
+    if (key == key_resize)
+    {
+        handle_resize();
+        event.type = InputEventType::resize;
+
+        for (unsigned int i = 0; i < window_slots.size(); i++)
+        {
+            if (window_slots[i].window != NULL && window_slots[i].input_callback)
+            {
+                InputCallback callback = window_slots[i].input_callback;
+                callback (event);
+            }
+        }
+
+        return;
+    }
+
+    event.type = key <= 255 ? InputEventType::character : InputEventType::key;
+
+    if (! window_is_valid (focused_window))
+        return;
+
+    WindowSlot& slot = window_slots[get_slot_index (focused_window)];
+
+    if (slot.line_callback)
+    {
+        std::string line;
+        LineEditAction action = slot.window->edit_line (key, line);
+
+        if (action == LineEditAction::submitted)
+        {
+            LineCallback line_callback = slot.line_callback;
+            line_callback (line);
+        }
+
+        if (action != LineEditAction::ignored)
+            return;
+    }
+
+    InputCallback callback = slot.input_callback;
+
+    if (callback)
+        callback (event);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the window a handle refers to, or NULL if it isn't valid, after making sure the
+//          window is part of the batch write in progress.  The first time a window joins a batch,
+//          its refreshes are deferred so that its writes don't reach the terminal one by one.
+//--------------------------------------------------------------------------------------------------
+Window* UI::add_to_batch (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+        return NULL;
+
+    unsigned int slot_index = get_slot_index (window_number);
+
+    if (! window_slots[slot_index].is_in_batch)
+    {
+        window_slots[slot_index].is_in_batch = true;
+        batch_slots.push_back (slot_index);
+
+        window->set_deferred_refresh (true);
+    }
+
+    return window;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Ends a batch write.  In batched refresh mode the windows simply stay dirty until the
+//          next flush; otherwise every window in the batch is staged and the terminal is updated
+//          once.
+//--------------------------------------------------------------------------------------------------
+void UI::finish_batch()
+{
+    bool is_update_needed = false;
+
+    for (unsigned int i = 0; i < batch_slots.size(); i++)
+    {
+        WindowSlot& slot = window_slots[batch_slots[i]];
+        slot.is_in_batch = false;
+
+        if (is_batched_refresh)
+            continue;
+
+        slot.window->set_deferred_refresh (false);
+        slot.window->take_deferred_refresh_count();
+
+        if (slot.window->stage_refresh())
+            is_update_needed = true;
+    }
+
+    batch_slots.clear();
+
+    if (is_update_needed)
+        update_screen();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Sends everything staged to the screen with one doupdate(), timing how long that takes
+//--------------------------------------------------------------------------------------------------
+void UI::update_screen()
+{
+    StatClock::time_point start = StatClock::now();
+
+    backend->update();
+    frame_update_time.record_since (start);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Gives a window a stream to read, replacing any stream it already had.  Returns false,
+//          and deletes the stream, if the window shows a table or the stream couldn't be made.
+//--------------------------------------------------------------------------------------------------
+bool UI::attach_stream_reader (const unsigned int& window_number, StreamReader* stream)
+{
+    WindowSlot& slot = window_slots[get_slot_index (window_number)];
+
+    if (stream == NULL || slot.table != NULL)
+    {
+        delete stream;
+        return false;
+    }
+
+    if (slot.stream == NULL)
+        stream_count++;
+
+    slot.stream.reset (stream);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Waits at most timeout_milliseconds for a key.  With streams attached, the wait is a
+//          poll() on the keyboard and the streams together that also wakes when a followed file is
+//          due to be checked; whatever the streams had is written to their windows, and no_key is
+//          returned if no key came.
+//--------------------------------------------------------------------------------------------------
+int UI::wait_for_key (const unsigned int& timeout_milliseconds)
+{
+    if (stream_count == 0)
+        return backend->poll_key (timeout_milliseconds);
+
+    // nCurses may already hold keys that poll() would never see
+    int key = backend->poll_key (0);
+
+    if (key != no_key)
+        return key;
+
+    unsigned int wait_milliseconds = timeout_milliseconds;
+
+    stream_polls.clear();
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        StreamReader* stream = window_slots[i].stream.get();
+
+        if (stream == NULL || stream->get_finished())
+            continue;
+
+        int descriptor = stream->get_poll_descriptor();
+
+        if (descriptor >= 0)
+            stream_polls.push_back ({ descriptor, POLLIN, 0 });
+        else if (stream->get_milliseconds_until_check() < wait_milliseconds)
+            wait_milliseconds = stream->get_milliseconds_until_check();
+    }
+
+    int input_descriptor = backend->get_input_descriptor();
+
+    if (input_descriptor >= 0)
+        stream_polls.push_back ({ input_descriptor, POLLIN, 0 });
+
+    poll (stream_polls.data(), stream_polls.size(), (int) wait_milliseconds);
+    read_streams();
+
+    return backend->poll_key (0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Makes the stats overlay in the top right corner of the screen, or moves it back there
+//          once the screen has been resized.  The overlay is left NULL if the screen is too small
+//          for it.
+//--------------------------------------------------------------------------------------------------
+void UI::place_stats_overlay()
+{
+    const unsigned int overlay_height = stats_overlay_lines + 3;
+
+    unsigned int screen_width = backend->get_screen_width();
+    unsigned int screen_height = backend->get_screen_height();
+    unsigned int width = stats_overlay_width < screen_width ? stats_overlay_width : screen_width;
+    unsigned int height = overlay_height < screen_height ? overlay_height : screen_height;
+
+    if (stats_overlay != NULL)
+    {
+        stats_overlay->set_geometry (screen_width - width, 0, width, height);
+        return;
+    }
+
+    stats_overlay.reset (make_window (screen_width - width, 0, width, height, "Stats",
+                                      TextAlignment::left, TextWrap::truncate,
+                                      stats_overlay_lines, *backend));
+
+    if (stats_overlay != NULL)
+        stats_overlay->set_deferred_refresh (is_batched_refresh);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Draws the latest stats into the overlay, if it is showing and it has been long enough
+//          since it was last drawn.  Returns whether it drew anything.
+//--------------------------------------------------------------------------------------------------
+bool UI::draw_stats_overlay (const bool& is_forced)
+{
+    if (stats_overlay == NULL)
+        return false;
+
+    StatClock::time_point now = StatClock::now();
+    double seconds = std::chrono::duration<double> (now - last_overlay_time).count();
+
+    if (! is_forced && seconds * 1000 < stats_overlay_interval_milliseconds)
+        return false;
+
+    UIStats stats = get_stats();
+    double write_rate = seconds > 0 ? (stats.writes - last_overlay_writes) / seconds : 0;
+    double update_rate = seconds > 0 ? (stats.update_time.count - last_overlay_updates) / seconds
+                                     : 0;
+
+    last_overlay_time = now;
+    last_overlay_writes = stats.writes;
+    last_overlay_updates = stats.update_time.count;
+
+    const HistogramSnapshot* histograms[] = { &stats.refresh_time, &stats.update_time,
+                                              &stats.input_latency };
+    const char* histogram_names[] = { "refresh", "update", "input" };
+    char lines[stats_overlay_lines][128];
+    char median[16], tail[16], longest[16];
+    unsigned int line_count = 0;
+
+    std::snprintf (lines[line_count++], sizeof (lines[0]), "writes  %12lu %10.0f/s",
+                   stats.writes, write_rate);
+    std::snprintf (lines[line_count++], sizeof (lines[0]), "bytes   %12lu", stats.bytes_written);
+    std::snprintf (lines[line_count++], sizeof (lines[0]), "updates %12lu %10.0f/s",
+                   stats.update_time.count, update_rate);
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        format_duration (histograms[i]->get_percentile (0.5), median, sizeof (median));
+        format_duration (histograms[i]->get_percentile (0.99), tail, sizeof (tail));
+        format_duration (histograms[i]->max_nanoseconds, longest, sizeof (longest));
+        std::snprintf (lines[line_count++], sizeof (lines[0]), "%-7s p50 %-7s p99 %-7s max %s",
+                       histogram_names[i], median, tail, longest);
+    }
+
+    std::snprintf (lines[line_count++], sizeof (lines[0]), "queue   %zu now, %zu max, %lu dropped",
+                   stats.queued_writes, stats.max_queued_writes, stats.dropped_writes);
+
+    // The busiest windows fill whatever lines are left
+    std::sort (stats.windows.begin(), stats.windows.end(),
+               [] (const WindowStats& left, const WindowStats& right)
+               {
+                   return left.writes > right.writes;
+               });
+
+    for (unsigned int i = 0; line_count < stats_overlay_lines && i < stats.windows.size(); i++)
+    {
+        format_duration (stats.windows[i].refresh_time.get_percentile (0.99), tail,
+                         sizeof (tail));
+        std::snprintf (lines[line_count++], sizeof (lines[0]), "#%-4u %9lu writes, p99 %s",
+                       stats.windows[i].window_number, stats.windows[i].writes, tail);
+    }
+
+    // The last line has no newline, so it doesn't scroll the first one away
+    stats_overlay->begin_frame();
+
+    for (unsigned int i = 0; i < line_count; i++)
+        stats_overlay->write (lines[i], i + 1 < line_count);
+
+    stats_overlay->end_frame();
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Body of the render thread.  Queued writes are applied as soon as they arrive so the
+//          queue stays empty, but the screen is only flushed once per frame at the target frame
+//          rate, so every write to a window between two frames costs a single repaint.  The thread
+//          naps whenever it has nothing to do, and drains and flushes once more on the way out so
+//          no posted write is lost.
+//--------------------------------------------------------------------------------------------------
+void UI::render_loop()
+{
+    while (is_render_thread_running.load (std::memory_order_acquire))
+    {
+        bool wrote_anything = apply_queued_writes() > 0;
+
+        if (read_streams() > 0)
+            wrote_anything = true;
+
+        if (is_frame_due())
+            flush();
+        else if (! wrote_anything)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+
+    // However many batches are left, every posted write is drawn before the thread ends
+    while (apply_queued_writes() > 0)
+        continue;
+
+    flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes a posted record to its window, if the window is still there
+//--------------------------------------------------------------------------------------------------
+void UI::apply_write (const WriteRecord& record)
+{
+    Window* window = get_window (record.window_number);
+
+    if (window != NULL)
+        window->write (record.text, record.style, record.newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Takes a write that has left the queue off its window's count of queued writes
+//--------------------------------------------------------------------------------------------------
+void UI::uncount_queued_write (const unsigned int& window_number)
+{
+    unsigned int slot_index = get_slot_index (window_number);
+
+    if (slot_index < coalesced_write_slots)
+        queued_write_counts[slot_index].fetch_sub (1, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes the coalesced write held back for a slot to its window and lets it go
+//--------------------------------------------------------------------------------------------------
+void UI::apply_held_write (const unsigned int& slot_index)
+{
+    apply_write (*held_writes[slot_index]);
+
+    coalesced_write_pool->release (held_writes[slot_index]);
+    held_writes[slot_index] = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Applies one batch of queued writes (at most one queue's worth, so producers can't keep
+//          the render thread from ever reaching the screen), with the coalesced writes put back
+//          in the order they were posted.  Windows are only marked dirty; nothing is sent to the
+//          terminal.  Returns the number of writes applied.
+// Notes:   The coalesced writes are taken before the queue is read.  Every write posted to the
+//          same window before one of them is counted in the queue by then, so a coalesced write is
+//          held until a newer queued write for its window turns up, or until none of its window's
+//          writes are left in the queue.
+//--------------------------------------------------------------------------------------------------
+std::size_t UI::apply_queued_writes()
+{
+    std::size_t writes_applied = 0;
+    bool is_queue_empty = false;
+
+    max_queued_writes.raise_to (write_queue->get_approximate_size());
+
+    for (unsigned int i = 0; i < coalesced_write_slots; i++)
+    {
+        WriteRecord* coalesced_write = coalesced_writes[i].exchange (NULL,
+                                                                     std::memory_order_acq_rel);
+
+        if (coalesced_write == NULL)
+            continue;
+
+        // A newer coalesced write replaces one still held, as it would have in the slot
+        if (held_writes[i] != NULL)
+        {
+            Window* window = get_window (held_writes[i]->window_number);
+
+            if (window == NULL || ! window->get_latest_value_only())
+                dropped_write_count.fetch_add (1, std::memory_order_relaxed);
+
+            coalesced_write_pool->release (held_writes[i]);
+        }
+
+        held_writes[i] = coalesced_write;
+    }
+
+    while (writes_applied < write_queue->get_capacity())
+    {
+        if (! write_queue->try_pop (popped_write))
+        {
+            is_queue_empty = true;
+            break;
+        }
+
+        unsigned int slot_index = get_slot_index (popped_write.window_number);
+
+        if (slot_index < coalesced_write_slots && held_writes[slot_index] != NULL
+            && held_writes[slot_index]->sequence < popped_write.sequence)
+        {
+            apply_held_write (slot_index);
+            writes_applied++;
+        }
+
+        apply_write (popped_write);
+        uncount_queued_write (popped_write.window_number);
+        writes_applied++;
+    }
+
+    for (unsigned int i = 0; i < coalesced_write_slots; i++)
+    {
+        if (held_writes[i] == NULL)
+            continue;
+
+        if (! is_queue_empty && queued_write_counts[i].load (std::memory_order_relaxed) > 0)
+            continue;
+
+        apply_held_write (i);
+        writes_applied++;
+    }
+
+    return writes_applied;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether enough time has passed since the last flush to draw another frame.
+//          Always true when there is no frame rate cap.
+//--------------------------------------------------------------------------------------------------
+bool UI::is_frame_due()
+{
+    unsigned int fps = target_fps.load (std::memory_order_relaxed);
+
+    if (fps == 0)
+        return true;
+
+    std::chrono::steady_clock::duration frame_period = std::chrono::seconds (1);
+    frame_period /= fps;
+
+    return std::chrono::steady_clock::now() - last_flush_time >= frame_period;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Puts the UI's bookkeeping into its starting state.  Shared by both constructors.
+//--------------------------------------------------------------------------------------------------
+void UI::initialize()
+{
+    number_of_windows = 0;
+    is_batched_refresh = false;
+    is_stack_changed = false;
+    last_frame_stats = FrameStats();
+    total_frame_stats = FrameStats();
+
+    target_fps = 0;
+    last_flush_time = std::chrono::steady_clock::now();
+
+    coalesced_write_slots = 0;
+    is_render_thread_running = false;
+    backpressure_policy = BackpressurePolicy::block;
+    dropped_write_count = 0;
+    was_batched_before_render_thread = false;
+
+    focused_window = invalid_window;
+    is_event_loop_running = false;
+
+    stream_count = 0;
+
+    retired_window_stats = WindowStats();
+    last_overlay_time = StatClock::now();
+    last_overlay_writes = 0;
+    last_overlay_updates = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Gives a newly made window a slot at the given place on the screen, on top of every
+//          other window but the stats overlay, and returns its handle.  Returns invalid_window if
+//          the window is NULL because it couldn't be made.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::add_window (Window* new_window, const unsigned int& x, const unsigned int& y,
+                             const unsigned int& width, const unsigned int& height)
+{
+    if (new_window == NULL)
+        return invalid_window;
+
+    new_window->set_deferred_refresh (is_batched_refresh);
+
+    if (stats_overlay != NULL)
+        stats_overlay->raise_window();
+
+    unsigned int slot_index;
+
+    if (free_slots.empty())
+    {
+        slot_index = window_slots.size();
+        window_slots.push_back (WindowSlot());
+        window_slots[slot_index].generation = 0;
+        window_slots[slot_index].is_in_batch = false;
+    }
+    else
+    {
+        slot_index = free_slots.back();
+        free_slots.pop_back();
+    }
+
+    WindowSlot& slot = window_slots[slot_index];
+
+    slot.window.reset (new_window);
+    slot.layout = make_fixed_layout (x, y, width, height);
+    slot.x = x;
+    slot.y = y;
+    slot.width = width;
+    slot.height = height;
+
+    number_of_windows++;
+
+    return (window_slots[slot_index].generation << window_generation_shift) | slot_index;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Sets up nCurses by creating the default NcursesBackend
+//--------------------------------------------------------------------------------------------------
+UI::UI()
+    : owned_backend (new NcursesBackend()), backend (owned_backend.get())
+{
+    initialize();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Draws through the given backend instead of nCurses, for example a
+//         MemoryBackend to run headless.  The backend must outlive the UI.
+//--------------------------------------------------------------------------------------------------
+UI::UI (Backend& backend_input)
+    : backend (&backend_input)
+{
+    initialize();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destructor - Closes down nCurses if the UI created the backend
+//--------------------------------------------------------------------------------------------------
+UI::~UI()
+{
+    stop_render_thread();
+    end_frame();
+
+    // Delete windows
+    stats_overlay.reset();
+    window_slots.clear();
+
+    // End nCurses
+    owned_backend.reset();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates new window and returns its handle, or invalid_window if it couldn't be
+//         created.  The window remembers up to history_lines lines of text so that it can be
+//         scrolled back through, and never fewer than it can show, so what is on screen survives
+//         a resize; its history memory is allocated once, right here.
+//         Text is placed on each line by alignment and broken into lines by wrap.
+// Notes:  Slots freed by destroy_window() are reused before the slot storage grows.  Until the
+//         first window is destroyed, handles are simply 0, 1, 2, ... in creation order.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_window (const unsigned int& x, const unsigned int& y,
+                                  const unsigned int& width, const unsigned int& height,
+                                  const std::string& window_title,
+                                  const TextAlignment& alignment, const TextWrap& wrap,
+                                  const unsigned int& history_lines)
+{
+    if (free_slots.empty() && window_slots.size() >= window_slot_mask)
+        return invalid_window;
+
+    return add_window (make_window (x, y, width, height, window_title, alignment, wrap,
+                                    history_lines, *backend),
+                       x, y, width, height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates a new window wherever the layout puts it on the screen as it is now, and
+//         keeps the layout so the window follows the terminal when it is resized
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_window (const Layout& layout, const std::string& window_title,
+                                  const TextAlignment& alignment, const TextWrap& wrap,
+                                  const unsigned int& history_lines)
+{
+    unsigned int x, y, width, height;
+    resolve_layout (layout, backend->get_screen_width(), backend->get_screen_height(),
+                    x, y, width, height);
+
+    unsigned int window_number = make_new_window (x, y, width, height, window_title, alignment,
+                                                  wrap, history_lines);
+
+    if (window_number != invalid_window)
+        window_slots[get_slot_index (window_number)].layout = layout;
+
+    return window_number;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates a new window whose text is either centered or left aligned, and wraps at
+//         the edge of the window
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_window (const unsigned int& x, const unsigned int& y,
+                                  const unsigned int& width, const unsigned int& height,
+                                  const std::string& window_title,
+                                  const bool& is_center_print_window,
+                                  const unsigned int& history_lines)
+{
+    return make_new_window (x, y, width, height, window_title,
+                            is_center_print_window ? TextAlignment::center : TextAlignment::left,
+                            TextWrap::character, history_lines);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates a new window from a layout whose text is either centered or left aligned,
+//         and wraps at the edge of the window
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_window (const Layout& layout, const std::string& window_title,
+                                  const bool& is_center_print_window,
+                                  const unsigned int& history_lines)
+{
+    return make_new_window (layout, window_title,
+                            is_center_print_window ? TextAlignment::center : TextAlignment::left,
+                            TextWrap::character, history_lines);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates a new window whose text is drawn on a pad of pad_width by pad_height, of
+//         which the window shows a part, and returns its handle, or invalid_window if it couldn't
+//         be created.  The pad is never smaller than the window.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_pad_window (const unsigned int& x, const unsigned int& y,
+                                      const unsigned int& width, const unsigned int& height,
+                                      const unsigned int& pad_width,
+                                      const unsigned int& pad_height,
+                                      const std::string& window_title,
+                                      const TextAlignment& alignment, const TextWrap& wrap,
+                                      const unsigned int& history_lines)
+{
+    if (free_slots.empty() && window_slots.size() >= window_slot_mask)
+        return invalid_window;
+
+    return add_window (make_window (x, y, width, height, window_title, alignment, wrap,
+                                    history_lines, *backend, pad_width, pad_height),
+                       x, y, width, height);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Instantiates a new pad window wherever the layout puts it on the screen as it is now,
+//         and keeps the layout so the window follows the terminal when it is resized.  The pad
+//         keeps its size as the window moves, unless the window outgrows it.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::make_new_pad_window (const Layout& layout, const unsigned int& pad_width,
+                                      const unsigned int& pad_height,
+                                      const std::string& window_title,
+                                      const TextAlignment& alignment, const TextWrap& wrap,
+                                      const unsigned int& history_lines)
+{
+    unsigned int x, y, width, height;
+    resolve_layout (layout, backend->get_screen_width(), backend->get_screen_height(),
+                    x, y, width, height);
+
+    unsigned int window_number = make_new_pad_window (x, y, width, height, pad_width, pad_height,
+                                                      window_title, alignment, wrap,
+                                                      history_lines);
+
+    if (window_number != invalid_window)
+        window_slots[get_slot_index (window_number)].layout = layout;
+
+    return window_number;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls the specified pad window so that the pad's cell at (row, column) is in its top
+//         left corner, or as close as the pad's size allows
+//--------------------------------------------------------------------------------------------------
+void UI::set_pad_view_origin (const unsigned int& window_number, const unsigned int& row,
+                              const unsigned int& column)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+    {
+        print_error();
+        return;
+    }
+
+    window->set_view_origin (row, column);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the row of the pad shown at the top of the specified pad window, or 0 for any
+//         other window
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_pad_view_row (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_view_row();
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column of the pad shown at the left of the specified pad window, or 0 for
+//         any other window
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_pad_view_column (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_view_column();
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Gives the specified window a new layout and moves it there right away
+//--------------------------------------------------------------------------------------------------
+void UI::set_window_layout (const unsigned int& window_number, const Layout& layout)
+{
+    if (! window_is_valid (window_number))
+    {
+        print_error();
+        return;
+    }
+
+    window_slots[get_slot_index (window_number)].layout = layout;
+    handle_resize();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Lays every window out again for the current screen size.  Only the windows whose layout
+//         gives them a new position or size are moved and refilled from their history; the others
+//         are just drawn again, as a resized terminal may have lost what it showed.
+// Notes:  The windows are laid out as one batched frame, so the terminal is updated once for all
+//         of them, with the stack of overlapping windows worked out once, rather than once for
+//         every window moved.
+//--------------------------------------------------------------------------------------------------
+void UI::handle_resize()
+{
+    unsigned int screen_width = backend->get_screen_width();
+    unsigned int screen_height = backend->get_screen_height();
+    bool was_batched_refresh = is_batched_refresh;
+
+    set_batched_refresh (true);
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        WindowSlot& slot = window_slots[i];
+
+        if (slot.window == NULL)
+            continue;
+
+        unsigned int x, y, width, height;
+        resolve_layout (slot.layout, screen_width, screen_height, x, y, width, height);
+
+        if (x == slot.x && y == slot.y && width == slot.width && height == slot.height)
+        {
+            slot.window->redraw();
+            continue;
+        }
+
+        slot.window->set_geometry (x, y, width, height);
+
+        if (slot.table != NULL)
+            slot.table->refresh_rows();
+
+        slot.x = x;
+        slot.y = y;
+        slot.width = width;
+        slot.height = height;
+    }
+
+    if (stats_overlay != NULL)
+    {
+        place_stats_overlay();
+        draw_stats_overlay (true);
+    }
+
+    // Flushes the frame, whichever mode it leaves the UI in
+    set_batched_refresh (was_batched_refresh);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Destroys the specified window, painting back only what it covered of the windows that
+//         remain.  Its handle, and any copies of it, become invalid; the slot is recycled for a
+//         future window under a new generation, or retired for good once its generations run out.
+//         Must not be called while the render thread is running.
+//--------------------------------------------------------------------------------------------------
+void UI::destroy_window (const unsigned int& window_number)
+{
+    if (! window_is_valid (window_number))
+    {
+        print_error();
+        return;
+    }
+
+    unsigned int slot_index = get_slot_index (window_number);
+    WindowSlot& slot = window_slots[slot_index];
+
+    // What the window did still counts toward the UI's totals
+    WindowStats window_stats = slot.window->get_stats();
+
+    retired_window_stats.writes += window_stats.writes;
+    retired_window_stats.bytes_written += window_stats.bytes_written;
+    retired_window_stats.refresh_time.merge (window_stats.refresh_time);
+    retired_window_stats.update_time.merge (window_stats.update_time);
+
+    if (slot.stream != NULL)
+        stream_count--;
+
+    // The table refers to the window, so it has to go first
+    slot.table.reset();
+    slot.stream.reset();
+    slot.window.reset();
+    slot.input_callback = InputCallback();
+    slot.line_callback = LineCallback();
+    number_of_windows--;
+
+    // Once a slot has used up every generation, reusing it would bring its oldest handles back to
+    // life, so it is retired instead.  Its last generation still matches, but finds no window.
+    if (slot.generation < window_generation_mask)
+    {
+        slot.generation++;
+        free_slots.push_back (slot_index);
+    }
+
+    // In batched mode, what the window uncovered waits for the next flush()
+    is_stack_changed = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Hides or shows the specified window.  A hidden window keeps its contents and is still
+//         written to, and showing it again puts it on top of the other windows.
+//--------------------------------------------------------------------------------------------------
+void UI::set_window_visible (const unsigned int& window_number, const bool& visible)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+    {
+        print_error();
+        return;
+    }
+
+    window->set_visible (visible);
+
+    if (visible && stats_overlay != NULL)
+        stats_overlay->raise_window();
+
+    is_stack_changed = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the specified window is showing
+//--------------------------------------------------------------------------------------------------
+bool UI::get_window_visible (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_visible();
+
+    print_error();
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the specified window on top of every other window, under the stats overlay
+//--------------------------------------------------------------------------------------------------
+void UI::raise_window (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+    {
+        print_error();
+        return;
+    }
+
+    window->raise_window();
+
+    if (stats_overlay != NULL)
+        stats_overlay->raise_window();
+
+    is_stack_changed = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the specified window beneath every other window
+//--------------------------------------------------------------------------------------------------
+void UI::lower_window (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+    {
+        print_error();
+        return;
+    }
+
+    window->lower_window();
+    is_stack_changed = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Allows the user to write the screen via keyboard in real-time.  The char that is written
+//         is returned so that the calling function may use it for whatever it may need.
+//--------------------------------------------------------------------------------------------------
+char UI::live_input (const unsigned int& window_number, const bool& newline)
+{
+    end_frame();
+
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+    {
+        char input = window->live_input (newline);
+
+        // Keystrokes are echoed right away rather than waiting for the next frame
+        end_frame();
+
+        return input;
+    }
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Reads one key into the line being edited in the specified window, which enter writes
+//         into the window.  The char is returned so that the calling function may use it for
+//         whatever it may need, or 0 if the key isn't a character or the window isn't valid.
+//--------------------------------------------------------------------------------------------------
+char UI::live_edit_input (const unsigned int& window_number)
+{
+    end_frame();
+
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+    {
+        char input = window->live_edit_input();
+
+        // The edited line is drawn right away rather than waiting for the next frame
+        end_frame();
+
+        return input;
+    }
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Lets the user type and edit a line in the specified window, then writes it there and
+//         returns it once enter is pressed.  It returns an empty string if the user didn't specify
+//         a window that is valid.
+//--------------------------------------------------------------------------------------------------
+std::string UI::read_line (const unsigned int& window_number)
+{
+    end_frame();
+
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+    {
+        std::string line = window->read_line();
+        end_frame();
+
+        return line;
+    }
+
+    print_error();
+
+    return std::string();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Prints a line to a window as long as the window is wide using the divider_symbol
+//--------------------------------------------------------------------------------------------------
+void UI::print_window_divider (const unsigned int& window_number, const char& divider_symbol)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->print_divider (divider_symbol);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes length characters of text to specified window at default location.  The text does
+//         not need to be null terminated and is never copied.
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const char* text,
+                          const std::size_t& length, const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (text, length, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a null terminated string to specified window at default location.
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const char* text,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (text, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a string_view to specified window at default location.
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const std::string_view& text,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (text, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes to specified window at default location.
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const std::string& text,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (text, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write an integer within window
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const int& int_number,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (int_number, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a float within window
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const float& float_number,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (float_number, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a double within window
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const double& double_number,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (double_number, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a char within window
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const char& character,
+                          const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (character, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes text to specified window in style, such as a log line colored by its level
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_window (const unsigned int& window_number, const std::string_view& text,
+                          const Style& style, const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write (text, style, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes text to specified window with each span of it in its own style.  Spans are byte
+//         ranges of the text, in order and not overlapping; text outside them is plain.
+//--------------------------------------------------------------------------------------------------
+void UI::write_spans (const unsigned int& window_number, const std::string_view& text,
+                      const StyleSpan* spans, const std::size_t& span_count, const bool& newline)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->write_spans (text.data(), text.length(), spans, span_count, newline);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes text to specified window with the spans held in a vector
+//--------------------------------------------------------------------------------------------------
+void UI::write_spans (const unsigned int& window_number, const std::string_view& text,
+                      const std::vector<StyleSpan>& spans, const bool& newline)
+{
+    write_spans (window_number, text, spans.data(), spans.size(), newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Formats the arguments printf-style and writes the result to the specified window.  Text
+//         that fits is formatted into a buffer on the stack; only longer text needs the heap.
+//--------------------------------------------------------------------------------------------------
+void UI::write_formatted (const unsigned int& window_number, const bool& newline,
+                          const char* format, ...)
+{
+    Window* window = get_window (window_number);
+
+    if (window == NULL)
+    {
+        print_error();
+        return;
+    }
+
+    char buffer[1024];
+    va_list arguments;
+    va_list arguments_copy;
+
+    va_start (arguments, format);
+    va_copy (arguments_copy, arguments);
+
+    int length = vsnprintf (buffer, sizeof (buffer), format, arguments);
+
+    if (length >= (int) sizeof (buffer))
+    {
+        std::vector<char> large_buffer (length + 1);
+        vsnprintf (large_buffer.data(), large_buffer.size(), format, arguments_copy);
+        window->write (large_buffer.data(), length, newline);
+    }
+    else if (length >= 0)
+        window->write (buffer, length, newline);
+
+    va_end (arguments_copy);
+    va_end (arguments);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: allows printing to all windows in the UI object.  Every window is refreshed once, and the
+//         terminal is updated once for all of them.
+//--------------------------------------------------------------------------------------------------
+void UI::write_to_all_windows (const std::string_view& text, const bool& newline)
+{
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].window == NULL)
+            continue;
+
+        unsigned int window_number = (window_slots[i].generation << window_generation_shift) | i;
+        add_to_batch (window_number)->write (text, newline);
+    }
+
+    finish_batch();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Applies a batch of writes, in order, to any number of windows.  Each handle is checked
+//         once, each window touched is refreshed once after all of its writes, and the terminal is
+//         updated once at the end, so hundreds of updates cost a single flush.  Writes to windows
+//         that aren't valid are skipped and reported once.
+//--------------------------------------------------------------------------------------------------
+void UI::write_batch (const WriteOp* ops, const std::size_t& count)
+{
+    bool has_invalid_window = false;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        Window* window = add_to_batch (ops[i].window_number);
+
+        if (window != NULL)
+            window->write (ops[i].text, ops[i].style, ops[i].newline);
+        else
+            has_invalid_window = true;
+    }
+
+    finish_batch();
+
+    if (has_invalid_window)
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Applies a batch of writes held in a vector
+//--------------------------------------------------------------------------------------------------
+void UI::write_batch (const std::vector<WriteOp>& ops)
+{
+    write_batch (ops.data(), ops.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Empty specified window
+//--------------------------------------------------------------------------------------------------
+void UI::clear_window (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->clear_window();
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Empty all windows
+//--------------------------------------------------------------------------------------------------
+void UI::clear_all_windows()
+{
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].window != NULL)
+            window_slots[i].window->clear_window();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls the specified window back through its history by the given number of lines
+//--------------------------------------------------------------------------------------------------
+void UI::scroll_window_up (const unsigned int& window_number, const unsigned int& lines)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->scroll_up (lines);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls the specified window forward through its history by the given number of lines
+//--------------------------------------------------------------------------------------------------
+void UI::scroll_window_down (const unsigned int& window_number, const unsigned int& lines)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->scroll_down (lines);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Jumps the specified window so that the given history line (0 being the oldest line still
+//         remembered) is shown at the top of the window
+//--------------------------------------------------------------------------------------------------
+void UI::scroll_window_to_line (const unsigned int& window_number, const unsigned int& line)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->scroll_to_line (line);
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of lines stored in the specified window's history.  It returns 0 if
+//         the user didn't specify a window that is valid.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_window_history_line_count (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_history_line_count();
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Starts a retained-mode frame on the specified window.  Writes to the window are drawn
+//         into a back buffer until end_window_frame() is called.
+//--------------------------------------------------------------------------------------------------
+void UI::begin_window_frame (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->begin_frame();
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Ends the specified window's frame and sends only the cells that changed since its last
+//         frame.  Returns the number of bytes of text sent, or 0 if the window isn't valid.
+//--------------------------------------------------------------------------------------------------
+unsigned long int UI::end_window_frame (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->end_frame();
+
+    print_error();
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sets the function that receives the specified window's input events.  An empty callback
+//         stops the window from receiving them.
+//--------------------------------------------------------------------------------------------------
+void UI::set_input_callback (const unsigned int& window_number, const InputCallback& callback)
+{
+    if (window_is_valid (window_number))
+        window_slots[get_slot_index (window_number)].input_callback = callback;
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sets the function that receives each line typed into the specified window.  While it is
+//         set, the window's keys are edited into a line that is drawn in place.  An empty callback
+//         turns line editing back off.
+//--------------------------------------------------------------------------------------------------
+void UI::set_line_callback (const unsigned int& window_number, const LineCallback& callback)
+{
+    if (window_is_valid (window_number))
+        window_slots[get_slot_index (window_number)].line_callback = callback;
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Makes the specified window the one that receives keys
+//--------------------------------------------------------------------------------------------------
+void UI::set_focused_window (const unsigned int& window_number)
+{
+    if (window_is_valid (window_number))
+        focused_window = window_number;
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the window that receives keys, or invalid_window if there isn't one
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_focused_window()
 {
-    return window_number < window_vector.size();
+    if (! window_is_valid (focused_window))
+        return invalid_window;
+
+    return focused_window;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Private: Prints an error stating the window is invalid
+// Public: Waits at most timeout_milliseconds for a key, then delivers it and every other key that
+//         is already waiting, so a paste arrives as one burst of events without any being dropped.
+//         Pending batched refreshes are flushed first so the user sees what they are answering.
+//         Text arriving on attached streams while waiting is written to their windows, and keeps
+//         the wait from going past the next time a followed file is due to be checked.
 //--------------------------------------------------------------------------------------------------
-void UI::print_error()
+unsigned long int UI::poll_input (const unsigned int& timeout_milliseconds)
 {
-    write_to_all_windows ("Invalid Window Requested", true);
+    end_frame();
+
+    unsigned long int event_count = 0;
+    int key = wait_for_key (timeout_milliseconds);
+    StatClock::time_point key_time = StatClock::now();
+
+    while (key != no_key)
+    {
+        dispatch_input (key);
+        event_count++;
+
+        key = backend->poll_key (0);
+    }
+
+    // Lines being edited are redrawn once for the whole burst of keys
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].window != NULL && window_slots[i].line_callback)
+            window_slots[i].window->draw_line_edit();
+    }
+
+    end_frame();
+
+    if (event_count > 0)
+        input_latency.record_since (key_time);
+
+    return event_count;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Constructor - Sets up nCurses
+// Public: Delivers input events and draws frames until a callback calls stop_event_loop().  While
+//         no keys arrive, it sleeps in the keyboard wait until the next frame is due.
 //--------------------------------------------------------------------------------------------------
-UI::UI()
+void UI::run_event_loop()
 {
-    // start nCurses
-    initscr();
-    refresh();
+    is_event_loop_running = true;
 
-    // Set noecho so that input isn't automatically inserted into a window by nCurses when wgetch()
-    // is called from within a Window.  We have our own custom input method, live_input(), that
-    // inserts the text received from wgetch() into the correct window.
-    noecho();
+    while (is_event_loop_running)
+    {
+        poll_input (get_milliseconds_until_frame());
+        tick();
+    }
+}
 
-    new_window = NULL;
+//--------------------------------------------------------------------------------------------------
+// Public: Makes run_event_loop() return once the events already read have been delivered
+//--------------------------------------------------------------------------------------------------
+void UI::stop_event_loop()
+{
+    is_event_loop_running = false;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Destructor - Closes down nCurses
+// Public: Attaches a virtualized table to the specified window, replacing any table or stream it
+//         already had, and draws its first rows.  Returns false if the window isn't valid or the
+//         table couldn't be allocated.
 //--------------------------------------------------------------------------------------------------
-UI::~UI()
+bool UI::attach_table (const unsigned int& window_number,
+                       const std::vector<unsigned int>& column_widths,
+                       const unsigned long int& row_count, const CellSource& cell_source)
 {
-    // Delete windows
-    for (int i = 0; i < window_vector.size(); i++)
-        delete window_vector[i];
+    Window* window = get_window (window_number);
 
-    // End nCurses
-    endwin();
+    if (window == NULL)
+    {
+        print_error();
+        return false;
+    }
+
+    Table* new_table = new (std::nothrow) Table (*window, column_widths, row_count, cell_source);
+
+    if (new_table == NULL)
+        return false;
+
+    WindowSlot& slot = window_slots[get_slot_index (window_number)];
+
+    if (slot.stream != NULL)
+    {
+        slot.stream.reset();
+        stream_count--;
+    }
+
+    slot.table.reset (new_table);
+    new_table->refresh_rows();
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Instantiates new window
+// Public: Changes how many rows the specified window's table has and redraws it
 //--------------------------------------------------------------------------------------------------
-void UI::make_new_window (const unsigned int& x, const unsigned int& y,
-                          const unsigned int& width, const unsigned int& height,
-                          const std::string& window_title, const bool& is_center_print_window)
+void UI::set_table_row_count (const unsigned int& window_number,
+                              const unsigned long int& row_count)
 {
-    new_window = new (std::nothrow) Window (x, y, width, height, window_title,
-                                            is_center_print_window);
+    Table* table = get_table (window_number);
 
-    if (new_window == NULL)
-        exit (0);
+    if (table != NULL)
+    {
+        table->set_row_count (row_count);
+        table->refresh_rows();
+    }
+    else
+        print_error();
+}
 
-    window_vector.push_back (new_window);
-    new_window = NULL;
+//--------------------------------------------------------------------------------------------------
+// Public: Selects a row of the specified window's table, scrolls it into view and redraws the
+//         table.  Only the rows that end up on screen are fetched, wherever the row is.
+//--------------------------------------------------------------------------------------------------
+void UI::jump_table_to_row (const unsigned int& window_number, const unsigned long int& row)
+{
+    Table* table = get_table (window_number);
+
+    if (table != NULL)
+    {
+        table->jump_to_row (row);
+        table->refresh_rows();
+    }
+    else
+        print_error();
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Allows the user to write the screen via keyboard in real-time.  The char that is written
-//         is returned so that the calling function may use it for whatever it may need.
+// Public: Moves the selection of the specified window's table up (negative) or down (positive) by
+//         a number of rows and redraws the table
 //--------------------------------------------------------------------------------------------------
-char UI::live_input (const unsigned int& window_number, const bool& newline)
+void UI::move_table_selection (const unsigned int& window_number, const long int& rows)
 {
-    if (window_is_valid (window_number))
-        return window_vector[window_number]->live_input (newline);
+    Table* table = get_table (window_number);
+
+    if (table != NULL)
+    {
+        table->move_selection (rows);
+        table->refresh_rows();
+    }
+    else
+        print_error();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the selected row of the specified window's table.  It returns 0 if the user
+//         didn't specify a window that has a table.
+//--------------------------------------------------------------------------------------------------
+unsigned long int UI::get_table_selected_row (const unsigned int& window_number)
+{
+    Table* table = get_table (window_number);
+
+    if (table != NULL)
+        return table->get_selected_row();
 
     print_error();
 
@@ -87,132 +1698,589 @@ char UI::live_input (const unsigned int& window_number, const bool& newline)
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Prints a line to a window as long as the window is wide using the divider_symbol
+// Public: Fetches and redraws the visible rows of the specified window's table, for when the data
+//         behind them has changed
 //--------------------------------------------------------------------------------------------------
-void UI::print_window_divider (const unsigned int& window_number, const char& divider_symbol)
+void UI::refresh_table (const unsigned int& window_number)
 {
-    if (window_is_valid (window_number))
-        window_vector[window_number]->print_divider (divider_symbol);
+    Table* table = get_table (window_number);
+
+    if (table != NULL)
+        table->refresh_rows();
     else
         print_error();
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Writes to specified window at default location.
+// Public: returns the number of windows that the UI is managing.
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_window (const unsigned int& window_number, const std::string& text,
-                          const bool& newline)
+unsigned long int UI::get_number_of_windows()
 {
-    if (window_is_valid (window_number))
-        window_vector[window_number]->write (text, newline);
+    return number_of_windows;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: returns the width (columns) of the internal window specified.  It returns -1 if the user
+//         didn't specify a window that is valid.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_window_width (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_width();
+
+    print_error();
+
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: returns the height (columns) of the internal window specified.  It returns -1 if the user
+//         didn't specify a window that is valid.
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_window_height (const unsigned int& window_number)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        return window->get_height();
+
+    print_error();
+
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: This method simply uses the getch() method to "pause" the screen.  This method of
+//         pausing the screen is fairly typical when working with nCurses, so it is included in this
+//         libary as well.
+//--------------------------------------------------------------------------------------------------
+void UI::pause_until_input()
+{
+    end_frame();
+    backend->read_key();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Turns batched refresh mode on or off.  While batched, writes and clears only mark their
+//         window as changed and nothing reaches the terminal until flush() is called (or until the
+//         UI pauses for input).  Turning batching off flushes anything still pending.
+//--------------------------------------------------------------------------------------------------
+void UI::set_batched_refresh (const bool& batched)
+{
+    end_frame();
+
+    is_batched_refresh = batched;
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].window != NULL)
+            window_slots[i].window->set_deferred_refresh (batched);
+    }
+
+    if (stats_overlay != NULL)
+        stats_overlay->set_deferred_refresh (batched);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether batched refresh mode is on
+//--------------------------------------------------------------------------------------------------
+bool UI::get_batched_refresh()
+{
+    return is_batched_refresh;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Sends every pending window change to the terminal with a single doupdate() and records
+//         how many physical refreshes that saved.  Does nothing if no window changed.
+//--------------------------------------------------------------------------------------------------
+void UI::flush()
+{
+    FrameStats frame_stats = FrameStats();
+
+    draw_stats_overlay (false);
+
+    // Only windows that changed since the last frame are copied to the virtual screen, once each
+    // no matter how many times they were written to
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        Window* window = window_slots[i].window.get();
+
+        if (window == NULL)
+            continue;
+
+        frame_stats.window_refreshes += window->take_deferred_refresh_count();
+        frame_stats.bytes_written += window->take_bytes_written();
+
+        if (window->stage_refresh())
+            frame_stats.windows_repainted++;
+    }
+
+    // The overlay, and windows destroyed, hidden or restacked since the last frame, reach the
+    // terminal outside of the frame's counts
+    bool is_overlay_staged = stats_overlay != NULL && stats_overlay->stage_refresh();
+
+    if (frame_stats.windows_repainted > 0)
+    {
+        update_screen();
+        frame_stats.physical_refreshes = 1;
+    }
+    else if (is_overlay_staged || is_stack_changed)
+        backend->update();
+
+    // A window can be repainted without any deferred refresh having been counted for it since the
+    // last frame, so the difference must never be allowed to wrap around
+    if (frame_stats.window_refreshes > frame_stats.physical_refreshes)
+    {
+        frame_stats.refreshes_saved = frame_stats.window_refreshes
+                                      - frame_stats.physical_refreshes;
+    }
+
+    is_stack_changed = false;
+
+    last_flush_time = std::chrono::steady_clock::now();
+    last_frame_stats = frame_stats;
+
+    total_frame_stats.window_refreshes += frame_stats.window_refreshes;
+    total_frame_stats.windows_repainted += frame_stats.windows_repainted;
+    total_frame_stats.physical_refreshes += frame_stats.physical_refreshes;
+    total_frame_stats.refreshes_saved += frame_stats.refreshes_saved;
+    total_frame_stats.bytes_written += frame_stats.bytes_written;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Frame-paced flush for single-threaded programs.  Call it as often as convenient, for
+//         example after every batch of writes; it only flushes once a frame is due at the target
+//         frame rate, so bursts of writes are coalesced into one repaint per window per frame.
+//--------------------------------------------------------------------------------------------------
+void UI::tick()
+{
+    if (! is_batched_refresh)
+        draw_stats_overlay (false);
+    else if (is_frame_due())
+        flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Caps how many frames per second the render thread and tick() draw.  0 removes the cap,
+//         flushing as soon as there is something to show.
+//--------------------------------------------------------------------------------------------------
+void UI::set_target_fps (const unsigned int& fps)
+{
+    target_fps.store (fps, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the frame rate cap, 0 meaning uncapped
+//--------------------------------------------------------------------------------------------------
+unsigned int UI::get_target_fps()
+{
+    return target_fps.load (std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Turns the specified window into a status window that only shows its latest value: each
+//         write replaces the window's contents, and while the render thread is running, posts to
+//         it skip the queue so that only the newest value waiting for a frame is ever drawn.  Must
+//         not be called while the render thread is running.
+//--------------------------------------------------------------------------------------------------
+void UI::set_window_latest_value_only (const unsigned int& window_number,
+                                       const bool& latest_value_only)
+{
+    Window* window = get_window (window_number);
+
+    if (window != NULL)
+        window->set_latest_value_only (latest_value_only);
     else
         print_error();
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Write an integer within window
+// Public: Returns the refresh counters of the most recent flush()
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_window (const unsigned int& window_number, const int& int_number,
-                          const bool& newline)
+FrameStats UI::get_last_frame_stats()
 {
-    window_vector[window_number]->write (int_number, newline);
+    return last_frame_stats;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Write a float within window
+// Public: Returns the refresh counters accumulated over every flush() since the UI was created
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_window (const unsigned int& window_number, const float& float_number,
-                          const bool& newline)
+FrameStats UI::get_total_frame_stats()
 {
-    window_vector[window_number]->write (float_number, newline);
+    return total_frame_stats;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Write a double within window
+// Public: Returns a snapshot of every counter and timing the UI keeps, in total and for each window
+//         that is still open.  The totals include the windows that have been destroyed.
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_window (const unsigned int& window_number, const double& double_number,
-                          const bool& newline)
+UIStats UI::get_stats()
 {
-    window_vector[window_number]->write (double_number, newline);
+    UIStats stats = UIStats();
+
+    stats.writes = retired_window_stats.writes;
+    stats.bytes_written = retired_window_stats.bytes_written;
+    stats.refresh_time = retired_window_stats.refresh_time;
+    stats.update_time = retired_window_stats.update_time;
+    stats.update_time.merge (frame_update_time.get_snapshot());
+    stats.input_latency = input_latency.get_snapshot();
+    stats.queued_writes = get_queued_write_count();
+    stats.max_queued_writes = max_queued_writes.get();
+    stats.dropped_writes = get_dropped_write_count();
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].window == NULL)
+            continue;
+
+        WindowStats window_stats = window_slots[i].window->get_stats();
+        window_stats.window_number = (window_slots[i].generation << window_generation_shift) | i;
+
+        stats.writes += window_stats.writes;
+        stats.bytes_written += window_stats.bytes_written;
+        stats.refresh_time.merge (window_stats.refresh_time);
+        stats.update_time.merge (window_stats.update_time);
+        stats.windows.push_back (window_stats);
+    }
+
+    return stats;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Write a char within window
+// Public: Shows or hides the stats overlay.  Must not be called while the render thread is running.
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_window (const unsigned int& window_number, const char& character,
-                          const bool& newline)
+void UI::set_stats_overlay_visible (const bool& visible)
 {
-    window_vector[window_number]->write (character, newline);
+    if (visible == (stats_overlay != NULL))
+        return;
+
+    if (visible)
+    {
+        place_stats_overlay();
+        draw_stats_overlay (true);
+        return;
+    }
+
+    // Only what the overlay covered is painted back
+    stats_overlay.reset();
+    is_stack_changed = true;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: allows printing to all windows in the UI object
+// Public: Hides the stats overlay if it is showing and shows it if it isn't, for binding to a key
 //--------------------------------------------------------------------------------------------------
-void UI::write_to_all_windows (const std::string& text, const bool& newline)
+void UI::toggle_stats_overlay()
 {
-    for (int i = 0; i < window_vector.size(); i++)
-        write_to_window (i, text, true);
+    set_stats_overlay_visible (stats_overlay == NULL);
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Empty specified window
+// Public: Returns whether the stats overlay is showing
 //--------------------------------------------------------------------------------------------------
-void UI::clear_window (const unsigned int& window_number)
+bool UI::get_stats_overlay_visible()
 {
-    window_vector[window_number]->clear_window();
+    return stats_overlay != NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Empty all windows
+// Public: Starts concurrent mode.  From now on, any thread may call post_to_window(); the writes
+//         are queued and a render thread owned by the UI applies them in batches, so nCurses is
+//         only ever touched from that one thread.  policy decides what a producer does when it
+//         finds the queue (queue_capacity writes, rounded up to a power of two) full.
 //--------------------------------------------------------------------------------------------------
-void UI::clear_all_windows()
+void UI::start_render_thread (const std::size_t& queue_capacity, const BackpressurePolicy& policy)
 {
-    for (int i = 0; i < window_vector.size(); i++)
-        clear_window (i);
+    if (is_render_thread_running)
+        return;
+
+    write_queue.reset (new WriteQueue (queue_capacity));
+
+    coalesced_write_slots = window_slots.size();
+    coalesced_writes.reset (new std::atomic<WriteRecord*>[coalesced_write_slots]);
+    coalesced_write_pool.reset (new WriteRecordPool (2 * coalesced_write_slots
+                                                     + spare_coalesced_writes));
+    write_sequences.reset (new std::atomic<unsigned long int>[coalesced_write_slots]);
+    queued_write_counts.reset (new std::atomic<unsigned long int>[coalesced_write_slots]);
+    held_writes.assign (coalesced_write_slots, NULL);
+    popped_write.text.reserve (reserved_write_length);
+
+    for (unsigned int i = 0; i < coalesced_write_slots; i++)
+    {
+        coalesced_writes[i] = NULL;
+        write_sequences[i] = 0;
+        queued_write_counts[i] = 0;
+    }
+
+    backpressure_policy = policy;
+
+    was_batched_before_render_thread = is_batched_refresh;
+    set_batched_refresh (true);
+
+    is_render_thread_running.store (true, std::memory_order_release);
+    render_thread = std::thread (&UI::render_loop, this);
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: returns the height number of windows that the UI is managing.
+// Public: Stops concurrent mode once every write posted so far has been drawn.  Producers must
+//         have stopped posting before this is called.
 //--------------------------------------------------------------------------------------------------
-unsigned long int UI::get_number_of_windows()
+void UI::stop_render_thread()
+{
+    if (! is_render_thread_running)
+        return;
+
+    is_render_thread_running.store (false, std::memory_order_release);
+    render_thread.join();
+
+    coalesced_writes.reset();
+    coalesced_write_pool.reset();
+    write_sequences.reset();
+    queued_write_counts.reset();
+    held_writes.clear();
+    coalesced_write_slots = 0;
+
+    set_batched_refresh (was_batched_before_render_thread);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Thread-safe write.  While the render thread is running, the write is queued without
+//         taking any lock; when the queue is full, the backpressure policy chosen in
+//         start_render_thread() decides whether to wait, drop the oldest queued write, or keep
+//         only the newest overflowing write for this window.  Without a render thread, this is
+//         just write_to_window().
+//--------------------------------------------------------------------------------------------------
+void UI::post_to_window (const unsigned int& window_number, const std::string_view& text,
+                         const bool& newline)
 {
-    return window_vector.size();
+    post_to_window (window_number, text, plain_style, newline);
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: returns the width (columns) of the internal window specified.  It returns -1 if the user
-//         didn't specify a window that is valid.
+// Public: Thread-safe styled write, queued and applied the same way as any other post
 //--------------------------------------------------------------------------------------------------
-unsigned int UI::get_window_width (const unsigned int& window_number)
+void UI::post_to_window (const unsigned int& window_number, const std::string_view& text,
+                         const Style& style, const bool& newline)
 {
-    if (window_is_valid (window_number))
-        return window_vector[window_number]->get_width();
+    if (! is_render_thread_running.load (std::memory_order_acquire))
+    {
+        write_to_window (window_number, text, style, newline);
+        return;
+    }
 
-    print_error();
+    WritePost post = { window_number, text, newline, style, 0 };
 
-    return -1;
+    // Latest value windows only ever need the newest write, so it replaces any still waiting
+    unsigned int slot_index = get_slot_index (window_number);
+    Window* window = get_window (window_number);
+    bool is_latest_value_window = slot_index < coalesced_write_slots && window != NULL
+                                  && window->get_latest_value_only();
+
+    bool is_counted = slot_index < coalesced_write_slots;
+
+    if (is_counted)
+        post.sequence = write_sequences[slot_index].fetch_add (1, std::memory_order_relaxed);
+
+    // A write is counted before it is pushed, so the render thread never finds it in the queue
+    // without it being counted
+    if (! is_latest_value_window)
+    {
+        if (is_counted)
+            queued_write_counts[slot_index].fetch_add (1, std::memory_order_relaxed);
+
+        if (write_queue->try_push (post))
+            return;
+    }
+
+    BackpressurePolicy policy = is_latest_value_window ? BackpressurePolicy::coalesce
+                                                       : backpressure_policy;
+
+    switch (policy)
+    {
+        case BackpressurePolicy::block:
+            while (! write_queue->try_push (post))
+                std::this_thread::yield();
+            break;
+
+        case BackpressurePolicy::drop_oldest:
+        {
+            unsigned int oldest_window_number;
+
+            while (! write_queue->try_push (post))
+            {
+                if (write_queue->try_discard (oldest_window_number))
+                {
+                    uncount_queued_write (oldest_window_number);
+                    dropped_write_count.fetch_add (1, std::memory_order_relaxed);
+                }
+            }
+
+            break;
+        }
+
+        case BackpressurePolicy::coalesce:
+        {
+            if (is_counted && ! is_latest_value_window)
+                queued_write_counts[slot_index].fetch_sub (1, std::memory_order_relaxed);
+
+            // The pool only runs dry if more producers are mid-post than it has spare records
+            WriteRecord* latest_write = is_counted ? coalesced_write_pool->acquire() : NULL;
+
+            if (latest_write == NULL)
+            {
+                dropped_write_count.fetch_add (1, std::memory_order_relaxed);
+                break;
+            }
+
+            copy_write_post (post, *latest_write);
+
+            WriteRecord* replaced_write = coalesced_writes[slot_index].exchange (
+                latest_write, std::memory_order_acq_rel);
+
+            if (replaced_write != NULL)
+            {
+                coalesced_write_pool->release (replaced_write);
+
+                if (! is_latest_value_window)
+                    dropped_write_count.fetch_add (1, std::memory_order_relaxed);
+            }
+
+            break;
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: returns the height (columns) of the internal window specified.  It returns -1 if the user
-//         didn't specify a window that is valid.
+// Public: Returns how many posted writes were thrown away by the drop_oldest or coalesce policies
 //--------------------------------------------------------------------------------------------------
-unsigned int UI::get_window_height (const unsigned int& window_number)
+unsigned long int UI::get_dropped_write_count()
 {
-    if (window_is_valid (window_number))
-        return window_vector[window_number]->get_height();
+    return dropped_write_count.load (std::memory_order_relaxed);
+}
 
-    print_error();
+//--------------------------------------------------------------------------------------------------
+// Public: Writes whatever has arrived on a file descriptor into the specified window from now on,
+//         as if each read were passed to write_to_window().  The descriptor stays the caller's to
+//         close, after the stream is detached or the window destroyed.  Returns false if the
+//         window isn't valid or shows a table.  Must not be called while the render thread is
+//         running.
+//--------------------------------------------------------------------------------------------------
+bool UI::attach_stream (const unsigned int& window_number, const int& descriptor)
+{
+    if (! window_is_valid (window_number))
+    {
+        print_error();
+        return false;
+    }
 
-    return -1;
+    if (descriptor < 0)
+        return false;
+
+    return attach_stream_reader (window_number, new (std::nothrow) StreamReader (descriptor));
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: This method simply uses the getch() method to "pause" the screen.  This method of
-//         pausing the screen is fairly typical when working with nCurses, so it is included in this
-//         libary as well.
+// Public: Follows the file at path into the specified window, starting from its last lines.  Like
+//         tail -F, the file is reopened by name when it is rotated, read again from its start when
+//         it is truncated, and waited for if it doesn't exist yet.  Returns false if the window
+//         isn't valid or shows a table.  Must not be called while the render thread is running.
 //--------------------------------------------------------------------------------------------------
-void UI::pause_until_input()
+bool UI::attach_stream (const unsigned int& window_number, const std::string& path)
+{
+    if (! window_is_valid (window_number))
+    {
+        print_error();
+        return false;
+    }
+
+    return attach_stream_reader (window_number, new (std::nothrow) StreamReader (path));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Stops writing the specified window's stream into it.  Text already read stays in the
+//         window.  Must not be called while the render thread is running.
+//--------------------------------------------------------------------------------------------------
+void UI::detach_stream (const unsigned int& window_number)
+{
+    if (! window_is_valid (window_number))
+    {
+        print_error();
+        return;
+    }
+
+    WindowSlot& slot = window_slots[get_slot_index (window_number)];
+
+    if (slot.stream == NULL)
+        return;
+
+    slot.stream.reset();
+    stream_count--;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Reads whatever has arrived on every attached stream, without waiting, and writes it into
+//         the streams' windows, one write per read.  Pipes and sockets are read when poll() finds
+//         them readable; files are read to their end, at most every
+//         stream_check_interval_milliseconds once they have been.  Returns the bytes read.
+//--------------------------------------------------------------------------------------------------
+unsigned long int UI::read_streams()
+{
+    if (stream_count == 0)
+        return 0;
+
+    stream_polls.clear();
+    stream_poll_slots.clear();
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        if (window_slots[i].stream == NULL)
+            continue;
+
+        int descriptor = window_slots[i].stream->get_poll_descriptor();
+
+        if (descriptor >= 0)
+        {
+            stream_polls.push_back ({ descriptor, POLLIN, 0 });
+            stream_poll_slots.push_back (i);
+        }
+    }
+
+    if (! stream_polls.empty())
+        poll (stream_polls.data(), stream_polls.size(), 0);
+
+    unsigned long int bytes_read = 0;
+    unsigned int poll_index = 0;
+
+    for (unsigned int i = 0; i < window_slots.size(); i++)
+    {
+        WindowSlot& slot = window_slots[i];
+
+        if (slot.stream == NULL)
+            continue;
+
+        bool is_readable = false;
+
+        if (poll_index < stream_poll_slots.size() && stream_poll_slots[poll_index] == i)
+        {
+            is_readable = stream_polls[poll_index].revents != 0;
+            poll_index++;
+        }
+
+        bytes_read += slot.stream->read_into (*slot.window, slot.window->get_history_capacity(),
+                                              is_readable);
+    }
+
+    return bytes_read;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns roughly how many posted writes are waiting for the render thread
+//--------------------------------------------------------------------------------------------------
+std::size_t UI::get_queued_write_count()
 {
-    getch();
+    if (write_queue == NULL)
+        return 0;
+
+    return write_queue->get_approximate_size();
 }
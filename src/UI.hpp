@@ -10,32 +10,254 @@
 #ifndef UI_hpp
 #define UI_hpp
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <poll.h>
+#include <thread>
 #include <vector>
+#include "Backend.hpp"
+#include "BasicWindow.hpp"
+#include "Layout.hpp"
+#include "NcursesBackend.hpp"
+#include "Stats.hpp"
+#include "StreamReader.hpp"
+#include "Table.hpp"
 #include "Window.hpp"
+#include "WriteQueue.hpp"
+
+// Refresh bookkeeping for one frame of batched refresh mode.  window_refreshes counts the refreshes
+// the windows asked for, windows_repainted counts the dirty windows copied to the virtual screen,
+// physical_refreshes counts the doupdate() calls that actually went out to the terminal, and
+// refreshes_saved is the difference between the first and the last.  bytes_written counts the
+// bytes of text the windows sent to the backend, so the savings of retained-mode frames
+// (begin_window_frame() and end_window_frame()) can be measured.
+struct FrameStats
+{
+    unsigned long int window_refreshes;
+    unsigned long int windows_repainted;
+    unsigned long int physical_refreshes;
+    unsigned long int refreshes_saved;
+    unsigned long int bytes_written;
+};
+
+// A decoded keystroke or terminal event delivered by the input event loop.  For characters, key is
+// the character itself; for other keys it is one of the key_ codes in Backend.hpp.
+enum class InputEventType { character, key, resize };
+
+struct InputEvent
+{
+    InputEventType type;
+    int key;
+};
+
+typedef std::function<void (const InputEvent& event)> InputCallback;
+typedef std::function<void (const std::string& line)> LineCallback;
+
+// One write in a batch handed to write_batch().  The text only needs to stay alive for the call.
+struct WriteOp
+{
+    unsigned int window_number;
+    std::string_view text;
+    bool newline;
+    Style style = plain_style;
+};
+
+// Window handles returned by make_new_window().  The low 16 bits select the window's slot and the
+// high 16 bits hold the slot's generation, which changes every time a window in that slot is
+// destroyed, so a handle to a destroyed window is always rejected even after its slot is reused.
+// A slot whose generation reaches window_generation_mask is never reused again.
+const unsigned int invalid_window = 0xFFFFFFFF;
+const unsigned int window_slot_mask = 0xFFFF;
+const unsigned int window_generation_shift = 16;
+const unsigned int window_generation_mask = 0xFFFF;
+
+// The stats overlay sits in the top right corner of the screen and is redrawn at most this often
+const unsigned int stats_overlay_width = 48;
+const unsigned int stats_overlay_lines = 10;
+const unsigned int stats_overlay_interval_milliseconds = 500;
+
+// Coalesced writes come from a pool with one record per window waiting in its slot, one per window
+// held back by the render thread, and this many for producers part way through a post
+const unsigned int spare_coalesced_writes = 64;
 
 class UI
 {
 private:
-    Window* new_window;
-    std::vector<Window*> window_vector;
+    struct WindowSlot
+    {
+        std::unique_ptr<Window> window;
+        std::unique_ptr<Table> table;
+        std::unique_ptr<StreamReader> stream;
+        InputCallback input_callback;
+        LineCallback line_callback;
+        unsigned int generation;
+        bool is_in_batch;
+
+        // Where the window goes, and where that put it on the screen the last time it was laid out
+        Layout layout;
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+        unsigned int height;
+    };
+
+    std::unique_ptr<Backend> owned_backend;
+    Backend* backend;
+
+    std::vector<WindowSlot> window_slots;
+    std::vector<unsigned int> free_slots;
+    unsigned long int number_of_windows;
+    bool is_batched_refresh;
+    bool is_stack_changed;
+    FrameStats last_frame_stats;
+    FrameStats total_frame_stats;
+    std::atomic<unsigned int> target_fps;
+    std::chrono::steady_clock::time_point last_flush_time;
+
+    // Concurrent mode: producers post into write_queue, render_thread does all nCurses calls
+    std::unique_ptr<WriteQueue> write_queue;
+    std::unique_ptr<std::atomic<WriteRecord*>[]> coalesced_writes;
+    std::unique_ptr<WriteRecordPool> coalesced_write_pool;
+    std::unique_ptr<std::atomic<unsigned long int>[]> write_sequences;
+    std::unique_ptr<std::atomic<unsigned long int>[]> queued_write_counts;
+    std::vector<WriteRecord*> held_writes;
+    WriteRecord popped_write;
+    unsigned int coalesced_write_slots;
+    std::thread render_thread;
+    std::atomic<bool> is_render_thread_running;
+    BackpressurePolicy backpressure_policy;
+    std::atomic<unsigned long int> dropped_write_count;
+    bool was_batched_before_render_thread;
+
+    // Input event loop
+    unsigned int focused_window;
+    bool is_event_loop_running;
+
+    // Windows written to by the batch write in progress
+    std::vector<unsigned int> batch_slots;
+
+    // Streams attached to windows, and room to poll() them without allocating
+    unsigned int stream_count;
+    std::vector<pollfd> stream_polls;
+    std::vector<unsigned int> stream_poll_slots;
+
+    // Stats: what destroyed windows did, the doupdate() of every frame and batch, and how long
+    // keys take to show.  Only the thread that draws adds to them.
+    WindowStats retired_window_stats;
+    LatencyHistogram frame_update_time;
+    LatencyHistogram input_latency;
+    StatCounter max_queued_writes;
+
+    // Stats overlay, drawn over every other window and not counted in the stats it shows
+    std::unique_ptr<Window> stats_overlay;
+    StatClock::time_point last_overlay_time;
+    unsigned long int last_overlay_writes;
+    unsigned long int last_overlay_updates;
 
     // Private methods
+    void initialize();
+    unsigned int add_window (Window* new_window, const unsigned int& x, const unsigned int& y,
+                             const unsigned int& width, const unsigned int& height);
+    unsigned int get_slot_index (const unsigned int& window_number);
+    unsigned int get_slot_generation (const unsigned int& window_number);
+    Window* get_window (const unsigned int& window_number);
+    Table* get_table (const unsigned int& window_number);
     bool window_is_valid (const unsigned int& window_number);
     void print_error();
+    void end_frame();
+    void render_loop();
+    void apply_write (const WriteRecord& record);
+    void uncount_queued_write (const unsigned int& window_number);
+    void apply_held_write (const unsigned int& slot_index);
+    std::size_t apply_queued_writes();
+    bool is_frame_due();
+    unsigned int get_milliseconds_until_frame();
+    void dispatch_input (const int& key);
+    Window* add_to_batch (const unsigned int& window_number);
+    void finish_batch();
+    void update_screen();
+    bool attach_stream_reader (const unsigned int& window_number, StreamReader* stream);
+    int wait_for_key (const unsigned int& timeout_milliseconds);
+    void place_stats_overlay();
+    bool draw_stats_overlay (const bool& is_forced);
 
 public:
     UI();
+    UI (Backend& backend_input);
     ~UI();
 
-    void make_new_window (const unsigned int& x, const unsigned int& y,
-                          const unsigned int& width, const unsigned int& height,
-                          const std::string& window_title, const bool& is_center_print_window);
+    unsigned int make_new_window (const unsigned int& x, const unsigned int& y,
+                                  const unsigned int& width, const unsigned int& height,
+                                  const std::string& window_title,
+                                  const bool& is_center_print_window,
+                                  const unsigned int& history_lines = 1000);
+    unsigned int make_new_window (const Layout& layout, const std::string& window_title,
+                                  const bool& is_center_print_window,
+                                  const unsigned int& history_lines = 1000);
+
+    // Text in a window is aligned to the left, center or right of each line, and lines either
+    // wrap at the edge of the window, wrap at the last space that fits, or are cut off at the edge
+    unsigned int make_new_window (const unsigned int& x, const unsigned int& y,
+                                  const unsigned int& width, const unsigned int& height,
+                                  const std::string& window_title,
+                                  const TextAlignment& alignment, const TextWrap& wrap,
+                                  const unsigned int& history_lines = 1000);
+    unsigned int make_new_window (const Layout& layout, const std::string& window_title,
+                                  const TextAlignment& alignment, const TextWrap& wrap,
+                                  const unsigned int& history_lines = 1000);
+    void destroy_window (const unsigned int& window_number);
+
+    // Pad windows draw their text on a pad of pad_width by pad_height, larger than the window, and
+    // show the part of it whose top left corner is set with set_pad_view_origin().  Their history
+    // is laid out at the width of the pad.
+    unsigned int make_new_pad_window (const unsigned int& x, const unsigned int& y,
+                                      const unsigned int& width, const unsigned int& height,
+                                      const unsigned int& pad_width,
+                                      const unsigned int& pad_height,
+                                      const std::string& window_title,
+                                      const TextAlignment& alignment, const TextWrap& wrap,
+                                      const unsigned int& history_lines = 1000);
+    unsigned int make_new_pad_window (const Layout& layout, const unsigned int& pad_width,
+                                      const unsigned int& pad_height,
+                                      const std::string& window_title,
+                                      const TextAlignment& alignment, const TextWrap& wrap,
+                                      const unsigned int& history_lines = 1000);
+    void set_pad_view_origin (const unsigned int& window_number, const unsigned int& row,
+                              const unsigned int& column);
+    unsigned int get_pad_view_row (const unsigned int& window_number);
+    unsigned int get_pad_view_column (const unsigned int& window_number);
+
+    // Windows overlap in the order they were made, each new one on top, with the stats overlay
+    // above them all.  Hiding, raising, lowering or destroying a window only repaints the part of
+    // the screen it uncovers.  A popup is a window made over the others, for example from
+    // make_percent_layout (25, 25, 50, 50), and hidden or destroyed once it is done with.
+    void set_window_visible (const unsigned int& window_number, const bool& visible);
+    bool get_window_visible (const unsigned int& window_number);
+    void raise_window (const unsigned int& window_number);
+    void lower_window (const unsigned int& window_number);
+
+    // Windows made from a Layout follow the terminal as it is resized.  Windows made at a fixed
+    // position only move if they would otherwise hang off the screen.  The event loop calls
+    // handle_resize() by itself; programs that read keys any other way call it when the terminal
+    // is resized.
+    void set_window_layout (const unsigned int& window_number, const Layout& layout);
+    void handle_resize();
 
     char live_input (const unsigned int& window_number, const bool& newline);
+    char live_edit_input (const unsigned int& window_number);
+    std::string read_line (const unsigned int& window_number);
 
     void print_window_divider (const unsigned int& window_number, const char& divider_symbol);
 
+    void write_to_window (const unsigned int& window_number, const char* text,
+                          const std::size_t& length, const bool& newline);
+    void write_to_window (const unsigned int& window_number, const char* text,
+                          const bool& newline);
+    void write_to_window (const unsigned int& window_number, const std::string_view& text,
+                          const bool& newline);
     void write_to_window (const unsigned int& window_number, const std::string& text,
                           const bool& newline);
     void write_to_window (const unsigned int& window_number, const int& int_number,
@@ -47,17 +269,118 @@ public:
     void write_to_window (const unsigned int& window_number, const char& character,
                           const bool& newline);
 
-    void write_to_all_windows (const std::string& text, const bool& newline);
+    // Styled writes: the whole text in one style, or each span of it in its own style
+    void write_to_window (const unsigned int& window_number, const std::string_view& text,
+                          const Style& style, const bool& newline);
+    void write_spans (const unsigned int& window_number, const std::string_view& text,
+                      const StyleSpan* spans, const std::size_t& span_count,
+                      const bool& newline);
+    void write_spans (const unsigned int& window_number, const std::string_view& text,
+                      const std::vector<StyleSpan>& spans, const bool& newline);
+
+    // printf-style formatted write.  The format string is checked against the arguments at compile
+    // time by GCC and Clang.
+    void write_formatted (const unsigned int& window_number, const bool& newline,
+                          const char* format, ...) __attribute__ ((format (printf, 4, 5)));
+
+    // Bulk writes: every window written to is refreshed once, after all of its writes, and the
+    // terminal is updated once for the whole batch
+    void write_batch (const WriteOp* ops, const std::size_t& count);
+    void write_batch (const std::vector<WriteOp>& ops);
+    void write_to_all_windows (const std::string_view& text, const bool& newline);
 
     void clear_window (const unsigned int& window_number);
     void clear_all_windows();
 
+    // Retained-mode redraw: everything written to the window between these two calls replaces
+    // its contents, and only the cells that changed since the window's previous frame are sent
+    void begin_window_frame (const unsigned int& window_number);
+    unsigned long int end_window_frame (const unsigned int& window_number);
+
+    void scroll_window_up (const unsigned int& window_number, const unsigned int& lines);
+    void scroll_window_down (const unsigned int& window_number, const unsigned int& lines);
+    void scroll_window_to_line (const unsigned int& window_number, const unsigned int& line);
+    unsigned int get_window_history_line_count (const unsigned int& window_number);
+
+    // Turns a window into a virtualized table whose rows are fetched from cell_source as they
+    // scroll into view.  The window's history is not used while it shows a table.
+    bool attach_table (const unsigned int& window_number,
+                       const std::vector<unsigned int>& column_widths,
+                       const unsigned long int& row_count, const CellSource& cell_source);
+    void set_table_row_count (const unsigned int& window_number,
+                              const unsigned long int& row_count);
+    void jump_table_to_row (const unsigned int& window_number, const unsigned long int& row);
+    void move_table_selection (const unsigned int& window_number, const long int& rows);
+    unsigned long int get_table_selected_row (const unsigned int& window_number);
+    void refresh_table (const unsigned int& window_number);
+
     unsigned long int get_number_of_windows();
 
     unsigned int get_window_width (const unsigned int& window_number);
     unsigned int get_window_height (const unsigned int& window_number);
 
     void pause_until_input();
+
+    // Non-blocking input.  Keys go to the callback of the focused window; resize events go to
+    // every window that has a callback.  poll_input() waits at most timeout_milliseconds for the
+    // first key, then delivers every key already typed, and returns how many events it delivered.
+    // run_event_loop() polls for input and calls tick() until stop_event_loop() is called, never
+    // waiting on the keyboard past the next frame.  Neither may be used while the render thread is
+    // running.
+    // With a line callback, the window's keys edit a line first and the callback gets each line
+    // as enter is pressed; keys the line editor doesn't use still go to the input callback.
+    void set_input_callback (const unsigned int& window_number, const InputCallback& callback);
+    void set_line_callback (const unsigned int& window_number, const LineCallback& callback);
+    void set_focused_window (const unsigned int& window_number);
+    unsigned int get_focused_window();
+    unsigned long int poll_input (const unsigned int& timeout_milliseconds);
+    void run_event_loop();
+    void stop_event_loop();
+
+    void set_batched_refresh (const bool& batched);
+    bool get_batched_refresh();
+    void flush();
+    void tick();
+
+    void set_target_fps (const unsigned int& fps);
+    unsigned int get_target_fps();
+    void set_window_latest_value_only (const unsigned int& window_number,
+                                       const bool& latest_value_only);
+
+    FrameStats get_last_frame_stats();
+    FrameStats get_total_frame_stats();
+
+    // Counters and timings of everything the UI has done, in total and for each window.  Collecting
+    // them takes no locks.  While the render thread is running, get_stats() may be called from any
+    // thread; otherwise only from the thread using the UI.  The overlay shows the same numbers in
+    // a window of its own in the top right corner, redrawn twice a second by flush() and tick().
+    UIStats get_stats();
+    void set_stats_overlay_visible (const bool& visible);
+    void toggle_stats_overlay();
+    bool get_stats_overlay_visible();
+
+    // While the render thread is running, post_to_window() is the only method that may be called
+    // from other threads, and windows must not be created.  Call stop_render_thread() before
+    // using the rest of the UI directly again.
+    void start_render_thread (const std::size_t& queue_capacity = 4096,
+                              const BackpressurePolicy& policy = BackpressurePolicy::block);
+    void stop_render_thread();
+    void post_to_window (const unsigned int& window_number, const std::string_view& text,
+                         const bool& newline);
+    void post_to_window (const unsigned int& window_number, const std::string_view& text,
+                         const Style& style, const bool& newline);
+
+    unsigned long int get_dropped_write_count();
+    std::size_t get_queued_write_count();
+
+    // Streams: text read from a file descriptor, or from a file followed by name the way tail -F
+    // follows it, is written into a window as it arrives.  poll_input() and run_event_loop() wait
+    // for streams and keys together, and the render thread reads streams attached before it was
+    // started.  Other programs call read_streams() to read whatever has arrived without waiting.
+    bool attach_stream (const unsigned int& window_number, const int& descriptor);
+    bool attach_stream (const unsigned int& window_number, const std::string& path);
+    void detach_stream (const unsigned int& window_number);
+    unsigned long int read_streams();
 };
 
 #endif /* UI_hpp */
@@ -3,14 +3,15 @@
 // File:        Window.cpp
 // Description: A Window class that uses the power of nCurses to build windows, while purposely
 //              avoiding all of nCurses major downfalls.
-// Notes:       This class should only be called from within the UI class, as the UI constructor
-//              contains the initscr() and endwin() ncurses functions that need to be called before
-//              and after the lifetime of these Window objects.  The UI constructor also calls n
-//              noecho(), a function that keeps wgetch() from inserting values into the screen for
-//              us during the Window class' live_input() method.
+// Notes:       This class should only be called from within the UI class, as the UI owns the
+//              Backend that needs to exist before and after the lifetime of these Window objects.
+//              The default NcursesBackend calls initscr() and endwin(), as well as noecho(), a
+//              function that keeps wgetch() from inserting values into the screen for us during
+//              the Window class' live_input() method.
 //
-//              Window = an instance of this Window wrapper class
-//              WINDOW = an instance of an nCurses window
+//              Window  = an instance of this Window wrapper class
+//              Surface = a rectangular drawing area provided by the Backend (an nCurses WINDOW
+//                        when using the default NcursesBackend)
 //
 // Author:      Joseph Lyons
 //--------------------------------------------------------------------------------------------------
@@ -19,53 +20,544 @@
 #include "Window.hpp"
 
 //--------------------------------------------------------------------------------------------------
-// Private: Write definition provides the required definition for the private virtual pure function
-//          of the Write base class that this Window class inherits.  The Write base class then has
-//          public write methods that utilize this definition of how to write.  These public write
-//          functions of the Write class are what are actually called on the Window objects in order
-//          to write to them.
+// Private: Returns how many lines a window's history holds: the capacity asked for, but never
+//          fewer lines than the window can show, as scrolling, resizing and redrawing all draw the
+//          window back from its history and would otherwise blank lines that are on the screen
 //--------------------------------------------------------------------------------------------------
-void Window::write_definition (const std::string& text, const bool& newline)
+static unsigned int get_history_lines (const unsigned int& history_capacity,
+                                       const unsigned int& height, const unsigned int& pad_height)
 {
-    if (is_center_print_window)
-        wprintw (ncurse_text_ptr, get_centered_text (text).c_str());
+    unsigned int lines_shown = pad_height > height ? pad_height : height;
+
+    return history_capacity > lines_shown ? history_capacity : lines_shown;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the surface that writes draw on: the frame's back buffer between begin_frame()
+//          and end_frame(), and the text window otherwise
+//--------------------------------------------------------------------------------------------------
+Surface& Window::get_drawing_surface()
+{
+    if (is_in_frame)
+        return *frame_surface;
+
+    return *text_surface;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Ends the line being laid out into target, and drawn on surface unless it is NULL.  If
+//          the text before it filled the line to the edge, the cursor has already moved on to the
+//          next line, so the break is only recorded rather than leaving an empty line behind.
+//--------------------------------------------------------------------------------------------------
+void Window::put_line_break (History& target, Surface* surface, const LineEnd& line_end,
+                             const bool& is_line_full)
+{
+    if (is_line_full)
+    {
+        target.end_line_at_wrap (line_end);
+        return;
+    }
+
+    target.end_line (line_end);
+
+    if (surface != NULL)
+    {
+        surface->put_text ("\n", 1);
+        bytes_written++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Appends the bytes of text from start to start + length to target, each part in the style
+//          of the span it falls in, and draws them on surface too unless it is NULL.  Neighbouring
+//          bytes in the same style go in one run, so the surface switches style once per span
+//          rather than once per piece.  Returns the style of the last run.
+// Notes:   Plain writes have no spans and never touch the surface's style, which is always left
+//          plain after a styled write.
+//--------------------------------------------------------------------------------------------------
+Style Window::put_styled_text (History& target, Surface* surface, const char* text,
+                               const std::size_t& start, const std::size_t& length,
+                               const StyleSpan* spans, const std::size_t& span_count)
+{
+    std::size_t position = start;
+    std::size_t end = start + length;
+    std::size_t span = 0;
+    Style style = plain_style;
+
+    while (span < span_count && spans[span].start + spans[span].length <= position)
+        span++;
+
+    while (position < end)
+    {
+        std::size_t run_end = end;
+
+        if (span < span_count && spans[span].start <= position)
+        {
+            style = spans[span].style;
+
+            if (spans[span].start + spans[span].length < end)
+                run_end = spans[span].start + spans[span].length;
+
+            span++;
+        }
+        else
+        {
+            style = plain_style;
+
+            if (span < span_count && spans[span].start < end)
+                run_end = spans[span].start;
+        }
+
+        target.append (text + position, run_end - position, style);
+
+        if (surface != NULL)
+        {
+            if (span_count > 0)
+                surface->set_style (style);
+
+            surface->put_text (text + position, run_end - position);
+        }
+
+        position = run_end;
+    }
+
+    return style;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how many columns text the given number of columns wide must be shifted right to
+//          be centered within this window.
+// Notes:   If a string is wider than the window, centering will be skipped and 0 will be returned.
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_centering_offset (const std::size_t& length)
+{
+    if (length >= get_width())
+        return 0;
+
+    return (get_width() - length) / 2;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Refreshes the text window.  In deferred mode, the window is only marked dirty; it is
+//          staged onto the virtual screen by stage_refresh() and the physical update happens when
+//          the owner updates the backend, so every write between two frames shares one repaint.
+//--------------------------------------------------------------------------------------------------
+void Window::refresh_text_window()
+{
+    if (is_deferred_refresh)
+    {
+        is_dirty = true;
+        deferred_refresh_count++;
+    }
     else
-        wprintw (ncurse_text_ptr, text.c_str());
+        refresh_text_surface();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Sends the text window to the screen now, timing how long that takes
+//--------------------------------------------------------------------------------------------------
+void Window::refresh_text_surface()
+{
+    StatClock::time_point start = StatClock::now();
+
+    text_surface->refresh_surface();
+    counters.refresh_time.record_since (start);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Sends everything staged to the screen, timing how long that takes
+//--------------------------------------------------------------------------------------------------
+void Window::update_screen()
+{
+    StatClock::time_point start = StatClock::now();
+
+    backend.update();
+    counters.update_time.record_since (start);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Shows the window having been shown, hidden, raised or lowered, which the surfaces have
+//          already staged.  In deferred mode it waits for the owner's next update.
+//--------------------------------------------------------------------------------------------------
+void Window::show_stack_change()
+{
+    if (! is_deferred_refresh)
+        update_screen();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how far back the window can be scrolled before the oldest stored line reaches
+//          the top of the window
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_max_scroll_offset()
+{
+    unsigned int line_count = history.get_line_count();
+
+    if (line_count <= get_height())
+        return 0;
+
+    return line_count - get_height();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Redraws only the slice of the history that is visible at the current scroll offset.
+//          When the window is not scrolled back, the cursor is left at the end of the newest line
+//          so that later writes continue where they should.
+//--------------------------------------------------------------------------------------------------
+void Window::render_history()
+{
+    unsigned int line_count = history.get_line_count();
+    unsigned int visible_lines = line_count < get_height() ? line_count : get_height();
+    unsigned int top_line = line_count - visible_lines - scroll_offset;
+    unsigned int length = 0;
+    bool is_styled = history.has_styles();
+
+    text_surface->erase_surface();
+
+    for (unsigned int row = 0; row < visible_lines; row++)
+    {
+        const char* line = history.get_line (top_line + row, length);
+        const unsigned char* style_ids = history.get_line_style_ids (top_line + row);
+
+        text_surface->move_cursor (row, 0);
+
+        if (! is_styled)
+        {
+            text_surface->put_text (line, length);
+            bytes_written += length;
+            continue;
+        }
+
+        // Draw each run of bytes in one style with a single style switch
+        for (unsigned int start = 0; start < length;)
+        {
+            unsigned int end = start + 1;
+
+            while (end < length && style_ids[end] == style_ids[start])
+                end++;
+
+            text_surface->set_style (history.get_style (style_ids[start]));
+            text_surface->put_text (line + start, end - start);
+
+            start = end;
+        }
+
+        bytes_written += length;
+    }
+
+    if (is_styled)
+        text_surface->set_style (plain_style);
+
+    is_previous_frame_valid = false;
+
+    if (scroll_offset == 0 && visible_lines > 0)
+        text_surface->move_cursor (visible_lines - 1, history.get_current_line_columns());
+
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Draws the border, and the title centered on the first line inside it if there is one
+//--------------------------------------------------------------------------------------------------
+void Window::draw_border_and_title()
+{
+    border_surface->draw_border();
+
+    if (title.length() > 0)
+    {
+        // Centered within the border rather than the text window, which may be a wider pad
+        unsigned int title_columns = get_display_width (title.data(), title.length());
+        unsigned int inner_width = border_surface->get_width() - 2;
+        unsigned int offset = title_columns < inner_width ? (inner_width - title_columns) / 2 : 0;
+
+        border_surface->put_text_at (1, 1 + offset, title.data(), title.length());
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes a run of frame glyphs at the text window's cursor, encoding them back to UTF-8 a
+//          stack buffer at a time.  The second halves of wide characters are drawn by the first
+//          halves, so they are skipped.  Returns the number of bytes written.
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::put_glyphs (const char32_t* glyphs, const std::size_t& count)
+{
+    char text[256];
+    std::size_t length = 0;
+    unsigned long int bytes_sent = 0;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (glyphs[i] == continuation_glyph)
+            continue;
+
+        if (length + max_bytes_per_column > sizeof (text))
+        {
+            text_surface->put_text (text, length);
+            bytes_sent += length;
+            length = 0;
+        }
 
-    if (newline)
-        wprintw (ncurse_text_ptr, "\n");
+        length += encode_utf8 (glyphs[i], text + length);
+    }
 
-    wrefresh (ncurse_text_ptr); // Refresh the text window
+    text_surface->put_text (text, length);
+
+    return bytes_sent + length;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Private: Pads a string with the correct amount of spaces to center it within this window.
-// Notes:   If a string has more characters than the width of the window, centering will be skipped
-//          and the original string will be returned.
+// Private: Sends the cells of the frame that differ from the previous frame to the text window, one
+//          run of neighbouring changed cells at a time, and makes the frame the previous frame.
+//          If the text window was drawn on outside of a frame since then, every cell is sent.
+//          Returns the number of bytes sent.
 //--------------------------------------------------------------------------------------------------
-std::string Window::get_centered_text (const std::string& text)
+unsigned long int Window::put_changed_cells()
 {
-    int spaces_left = getmaxx (ncurse_text_ptr) - (int) text.length();
+    CellGrid& frame = frame_surface->get_cells();
+    unsigned long int bytes_sent = 0;
+
+    // Without scrolling, a run that ends in the bottom right cell won't scroll the window up
+    text_surface->set_scrolling (false);
+
+    for (unsigned int row = 0; row < frame.height; row++)
+    {
+        std::size_t row_start = (std::size_t) row * frame.width;
+        unsigned int column = 0;
+
+        while (column < frame.width)
+        {
+            std::size_t cell = row_start + column;
+
+            if (is_previous_frame_valid &&
+                frame.glyphs[cell] == previous_frame.glyphs[cell] &&
+                frame.attributes[cell] == previous_frame.attributes[cell])
+            {
+                column++;
+                continue;
+            }
+
+            // Extend the run over the following changed cells that share its attributes
+            unsigned int run_end = column + 1;
+
+            while (run_end < frame.width)
+            {
+                std::size_t next = row_start + run_end;
+
+                if (frame.attributes[next] != frame.attributes[cell] ||
+                    (is_previous_frame_valid &&
+                     frame.glyphs[next] == previous_frame.glyphs[next] &&
+                     frame.attributes[next] == previous_frame.attributes[next]))
+                    break;
+
+                run_end++;
+            }
+
+            // A run can't start on the second half of a wide character; redraw the whole character
+            if (column > 0 && frame.glyphs[cell] == continuation_glyph)
+            {
+                column--;
+                cell--;
+            }
+
+            text_surface->set_style (unpack_style (frame.attributes[cell]));
+            text_surface->move_cursor (row, column);
+            bytes_sent += put_glyphs (&frame.glyphs[cell], run_end - column);
+
+            column = run_end;
+        }
+    }
+
+    text_surface->set_style (plain_style);
+    text_surface->set_scrolling (true);
 
-    if (spaces_left <= 0)
-        return text;
+    // Later writes outside of a frame carry on from where the frame left off
+    text_surface->move_cursor (frame_surface->get_cursor_row(),
+                               frame_surface->get_cursor_column());
 
-    return std::string (spaces_left / 2, ' ') + text;
+    previous_frame.glyphs.swap (frame.glyphs);
+    previous_frame.attributes.swap (frame.attributes);
+    is_previous_frame_valid = true;
+
+    return bytes_sent;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Starts editing a new line at the cursor, first scrolling back down if the user had
+//          scrolled back through the history.  The rest of the row after the cursor is taken to be
+//          blank, as it is after any write.
+//--------------------------------------------------------------------------------------------------
+void Window::start_line_edit()
+{
+    if (scroll_offset > 0)
+    {
+        scroll_offset = 0;
+        render_history();
+    }
+
+    edit_row = text_surface->get_cursor_row();
+    edit_column = text_surface->get_cursor_column();
+    edit_scroll = 0;
+    edit_cells.assign (get_width() - edit_column, " ");
+    edit_layout.resize (edit_cells.size());
+
+    is_line_edit_active = true;
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Constructor - Intializes and draws both the text window and the border window.  Based on
-//         the user's settings, the constructor will either display the window title or not and give
-//         the user the option to have text centered or left aligned text.  If a title isn't used,
-//         the text window takes this space and uses it as a printable region.
+// Private: Draws the line being edited over the cells that differ from what the row shows, and
+//          puts the cursor where the next character will be typed.  The line is laid out by
+//          display column, so wide characters take two cells and combining marks none.  A line
+//          too long for the row scrolls sideways to keep the cursor in view, and a wide character
+//          cut in half by either edge of the row is shown as blanks.  In a center print window, a
+//          line that fits is centered exactly as it will be once it is submitted.
+//--------------------------------------------------------------------------------------------------
+void Window::put_line_edit_cells()
+{
+    const std::string& text = line_editor.get_text();
+    std::size_t cursor = line_editor.get_cursor();
+    std::size_t region = edit_cells.size();
+
+    is_line_edit_dirty = false;
+
+    if (region == 0)
+        return;
+
+    std::size_t text_columns = get_display_width (text.c_str(), text.size());
+    std::size_t cursor_column = get_display_width (text.c_str(), cursor);
+
+    // Leave room for the cursor after the last character
+    if (text_columns < region)
+        edit_scroll = 0;
+    else if (cursor_column < edit_scroll)
+        edit_scroll = cursor_column;
+    else if (cursor_column >= edit_scroll + region)
+        edit_scroll = cursor_column - region + 1;
+
+    std::size_t shown = text_columns - edit_scroll < region ? text_columns - edit_scroll : region;
+    std::size_t padding = 0;
+
+    if (alignment == TextAlignment::center && shown == text_columns)
+    {
+        padding = get_centering_offset (shown);
+
+        if (edit_column + padding >= get_width() || padding + shown >= region)
+            padding = 0;
+    }
+
+    for (std::string& cell : edit_layout)
+        cell.assign (1, ' ');
+
+    // Lay the line out one character at a time, from the column it starts in
+    std::size_t position = 0;
+    std::size_t column = 0;
+    std::size_t last_cell = region;
+
+    while (position < text.size() && column < edit_scroll + shown)
+    {
+        char32_t code_point;
+        std::size_t size = decode_utf8 (text.c_str() + position, text.size() - position,
+                                        code_point);
+        std::size_t width = get_character_width (code_point);
+
+        if (width == 0)
+        {
+            if (last_cell < region)
+                edit_layout[last_cell].append (text, position, size);
+        }
+        else if (column >= edit_scroll && column + width <= edit_scroll + shown)
+        {
+            last_cell = padding + column - edit_scroll;
+
+            if (code_point == replacement_character)
+            {
+                char character[4];
+
+                edit_layout[last_cell].assign (character, encode_utf8 (code_point, character));
+            }
+            else
+                edit_layout[last_cell].assign (text, position, size);
+
+            if (width == 2)
+                edit_layout[last_cell + 1].clear();
+        }
+        else
+            last_cell = region;
+
+        position += size;
+        column += width;
+    }
+
+    // Without scrolling, a change in the bottom right cell won't scroll the window up
+    text_surface->set_scrolling (false);
+
+    std::size_t cell = 0;
+
+    while (cell < region)
+    {
+        std::size_t run_start = cell;
+
+        edit_run.clear();
+
+        while (cell < region && edit_layout[cell] != edit_cells[cell])
+        {
+            edit_cells[cell] = edit_layout[cell];
+            edit_run += edit_cells[cell++];
+        }
+
+        if (cell > run_start)
+        {
+            text_surface->put_text_at (edit_row, edit_column + run_start, edit_run.c_str(),
+                                       edit_run.size());
+            bytes_written += edit_run.size();
+        }
+        else
+            cell++;
+    }
+
+    text_surface->set_scrolling (true);
+    text_surface->move_cursor (edit_row, edit_column + padding + cursor_column - edit_scroll);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Ends editing: the edited line is taken out of the editor and rubbed out, then written
+//          into the window like any other write so it is aligned and kept in the history
+//--------------------------------------------------------------------------------------------------
+void Window::commit_line_edit (std::string& line)
+{
+    line = line_editor.take_line();
+    put_line_edit_cells();
+
+    text_surface->move_cursor (edit_row, edit_column);
+    is_line_edit_active = false;
+
+    write (line, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Protected: Constructor - Intializes and draws both the text window and the border window.  Based
+//            on the user's settings, the constructor will either display the window title or not.
+//            If a title isn't used, the text window takes this space and uses it as a printable
+//            region.  How text is aligned and wrapped is up to the BasicWindow being constructed.
+//            A pad_width or pad_height above 0 draws the text on a pad of that size instead, of
+//            which the window shows the part set by set_view_origin().  The window is put on top
+//            of every window already on the screen.  The history holds history_capacity lines,
+//            or as many as the window is tall if that is more.
 //--------------------------------------------------------------------------------------------------
 Window::Window (const unsigned int& x, const unsigned int& y,
                 const unsigned int& width, const unsigned int& height,
-                const std::string& window_title, const bool& is_center_print_window_input)
-    : is_center_print_window (is_center_print_window_input)
+                const std::string& window_title, const TextAlignment& alignment_input,
+                const unsigned int& history_capacity, Backend& backend_input,
+                const unsigned int& pad_width, const unsigned int& pad_height)
+    : backend (backend_input), title (window_title), alignment (alignment_input),
+      is_deferred_refresh (false), is_dirty (false), is_latest_value_only (false),
+      deferred_refresh_count (0),
+      history (get_history_lines (history_capacity, height, pad_height),
+               pad_width > width - 2 ? pad_width : width - 2),
+      scroll_offset (0), bytes_written (0), previous_frame (0, 0), is_in_frame (false),
+      is_previous_frame_valid (false), line_editor (100), is_line_edit_active (false),
+      is_line_edit_dirty (false), edit_row (0), edit_column (0), edit_scroll (0),
+      line_breaks (64)
 {
-    // Create inner invisible window for the text
-
     // If a window title is wanted, we need to adjust the inner text window down a line to allow
     // for it, if we don't want a title, go ahead and use the space where the title would be as
     // printable space for the text window
@@ -76,47 +568,177 @@ Window::Window (const unsigned int& x, const unsigned int& y,
     if (has_window_title)
         adjustment = 1;
 
-    ncurse_text_ptr = newwin (height - adjustment - 2, width - 2, y + adjustment + 1, x + 1);
-
-    scrollok (ncurse_text_ptr, TRUE);
+    // Create outer border of window, with the centered window title if requested.  It is made
+    // first so that the text window is stacked on top of it.
+    border_surface = backend.make_surface (x, y, width, height);
+    draw_border_and_title();
 
-    // Create outer border of window
-    ncurse_border_ptr = newwin (height, width, y, x);
-    box (ncurse_border_ptr, 0, 0);
+    // Create inner invisible window for the text, on a pad if one was asked for
+    if (pad_width > 0 || pad_height > 0)
+        text_surface = backend.make_pad_surface (x + 1, y + adjustment + 1, width - 2,
+                                                 height - adjustment - 2, pad_width, pad_height);
+    else
+        text_surface = backend.make_surface (x + 1, y + adjustment + 1, width - 2,
+                                             height - adjustment - 2);
 
-    // Print centered window title if requested
-    if (has_window_title)
-        mvwprintw (ncurse_border_ptr, 1, 1, get_centered_text (window_title).c_str());
+    text_surface->set_scrolling (true);
 
-    wrefresh (ncurse_border_ptr);
+    border_surface->refresh_surface();
 }
 
 //--------------------------------------------------------------------------------------------------
-// Public: Destructor
+// Public: Destructor - Frees the surfaces, which stages whatever the window covered, and shows
+//         that unless refreshes are deferred
 //--------------------------------------------------------------------------------------------------
 Window::~Window()
 {
+    text_surface.reset();
+    border_surface.reset();
 
+    if (! is_deferred_refresh)
+        backend.update();
 }
 
 //--------------------------------------------------------------------------------------------------
 // Public: Allows the user to write the screen via keyboard in real-time.  The char that is written
 //         is returned so that the calling function may use it for whatever it may need.
-// Note:   Live input does not currently support center-aligned text.  Please use left-aligned until
-//         this is implemented.  Currently, the application will terminate if you try to call
-//         live_input() on a center print window.  This will be removed if this feature is added in
-//         the future.
+// Notes:  Keys that aren't characters, such as the arrow keys, aren't written and come back as 0.
+//         Typeahead is kept, so nothing typed or pasted while the program was busy is lost.
 //--------------------------------------------------------------------------------------------------
 char Window::live_input (const bool& newline)
 {
-    assert(! is_center_print_window);
+    int key = text_surface->read_key();
+
+    if (key < 0 || key > 255)
+        return 0;
 
-    char input = wgetch (ncurse_text_ptr);
-    flushinp(); // Does this need to be here for this library?
+    char input = (char) key;
     write (input, newline);
     return input;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Public: Like live_input(), but the key goes through the line editor instead of straight into
+//         the window, so the line can be corrected with backspace and the arrow keys before enter
+//         writes it, and it is centered as it is typed in a center print window.  The char is
+//         returned, or 0 for keys that aren't characters.
+//--------------------------------------------------------------------------------------------------
+char Window::live_edit_input()
+{
+    int key = text_surface->read_key();
+    std::string line;
+
+    edit_line (key, line);
+    draw_line_edit();
+
+    if (key < 0 || key > 255)
+        return 0;
+
+    return (char) key;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Lets the user type and edit a line, then writes it into the window and returns it once
+//         enter is pressed.  Every key that has already arrived is applied before the line is
+//         redrawn, so a paste of thousands of characters costs a single repaint.  Returns an
+//         empty string early if the backend runs out of keys, leaving the line to be finished by
+//         the next call.
+//--------------------------------------------------------------------------------------------------
+std::string Window::read_line()
+{
+    std::string line;
+    int key = text_surface->read_key();
+
+    while (key != no_key)
+    {
+        while (key != no_key)
+        {
+            if (edit_line (key, line) == LineEditAction::submitted)
+                return line;
+
+            key = backend.poll_key (0);
+        }
+
+        // The line has to be seen while it is typed, even when refreshes are deferred
+        draw_line_edit();
+
+        if (stage_refresh())
+            update_screen();
+
+        key = text_surface->read_key();
+    }
+
+    return line;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Applies one key to the line being edited, starting a new line at the cursor if none is
+//         being edited.  Nothing is drawn until draw_line_edit(), except when enter submits the
+//         line: it is then written into the window and returned through line.
+//--------------------------------------------------------------------------------------------------
+LineEditAction Window::edit_line (const int& key, std::string& line)
+{
+    if (! is_line_edit_active)
+        start_line_edit();
+
+    LineEditAction action = line_editor.handle_key (key);
+
+    if (action == LineEditAction::edited)
+        is_line_edit_dirty = true;
+    else if (action == LineEditAction::submitted)
+        commit_line_edit (line);
+
+    return action;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Redraws the changed cells of the line being edited and refreshes the window, if the line
+//         changed since it was last drawn
+//--------------------------------------------------------------------------------------------------
+void Window::draw_line_edit()
+{
+    if (! is_line_edit_dirty)
+        return;
+
+    put_line_edit_cells();
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes length bytes of text in style.  Plain text goes the same way as any other write.
+//--------------------------------------------------------------------------------------------------
+void Window::write (const char* text, const std::size_t& length, const Style& style,
+                    const bool& newline)
+{
+    if (style == plain_style)
+    {
+        write (text, length, newline);
+        return;
+    }
+
+    StyleSpan span = { 0, length, style };
+    write_spans_definition (text, length, &span, 1, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes a string_view in style
+//--------------------------------------------------------------------------------------------------
+void Window::write (const std::string_view& text, const Style& style, const bool& newline)
+{
+    write (text.data(), text.length(), style, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Writes length bytes of text with each span of it drawn in that span's style, for
+//         example a log line whose level alone is colored.  Spans must be in order and must not
+//         overlap; text outside every span is plain.
+//--------------------------------------------------------------------------------------------------
+void Window::write_spans (const char* text, const std::size_t& length, const StyleSpan* spans,
+                          const std::size_t& span_count, const bool& newline)
+{
+    write_spans_definition (text, length, spans, span_count, newline);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Public: Prints a line as long as the window is wide using the divider_symbol
 //--------------------------------------------------------------------------------------------------
@@ -127,11 +749,414 @@ void Window::print_divider (const char& divider_symbol)
 
 //--------------------------------------------------------------------------------------------------
 // Public: Empty all text from within window
+// Notes:  The window is erased rather than cleared, so only the cells that held text are sent to
+//         the terminal again instead of the whole window
 //--------------------------------------------------------------------------------------------------
 void Window::clear_window()
 {
-    wclear (ncurse_text_ptr);
-    wrefresh (ncurse_text_ptr);
+    history.clear();
+    scroll_offset = 0;
+
+    text_surface->erase_surface();
+    is_previous_frame_valid = false;
+
+    // A line being edited moves to the top of the emptied window
+    if (is_line_edit_active)
+    {
+        start_line_edit();
+        put_line_edit_cells();
+    }
+
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Draws the border and text again in full, for example after another window that covered
+//         part of this one has gone away
+//--------------------------------------------------------------------------------------------------
+void Window::redraw()
+{
+    border_surface->touch_surface();
+    text_surface->touch_surface();
+
+    border_surface->stage_surface();
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Moves and resizes the window in place, keeping its contents.  The history is laid out
+//         again at the new width, each line aligned and wrapped as it was written, and the visible
+//         part of it is drawn back into the window, so nothing written to the window is lost
+//         unless it no longer fits in the history or was cut off by truncation.
+//--------------------------------------------------------------------------------------------------
+void Window::set_geometry (const unsigned int& x, const unsigned int& y,
+                           const unsigned int& width, const unsigned int& height)
+{
+    unsigned int adjustment = title.length() > 0 ? 1 : 0;
+
+    border_surface->move_and_resize (x, y, width, height);
+    text_surface->move_and_resize (x + 1, y + adjustment + 1, width - 2, height - adjustment - 2);
+
+    draw_border_and_title();
+    border_surface->stage_surface();
+
+    // The next frame is drawn in full at the new size
+    if (frame_surface != NULL)
+        frame_surface->move_and_resize (0, 0, get_width(), get_height());
+
+    previous_frame = CellGrid (get_width(), get_height());
+    is_previous_frame_valid = false;
+
+    rewrap_history();
+
+    if (scroll_offset > get_max_scroll_offset())
+        scroll_offset = get_max_scroll_offset();
+
+    render_history();
+
+    // A line being edited carries on after the refilled text
+    if (is_line_edit_active)
+    {
+        start_line_edit();
+        put_line_edit_cells();
+        refresh_text_window();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Hides or shows the window.  Showing it puts it on top of every other window.
+//--------------------------------------------------------------------------------------------------
+void Window::set_visible (const bool& visible)
+{
+    if (visible == get_visible())
+        return;
+
+    border_surface->set_visible (visible);
+    text_surface->set_visible (visible);
+
+    show_stack_change();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether the window is showing
+//--------------------------------------------------------------------------------------------------
+bool Window::get_visible()
+{
+    return text_surface->get_visible();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the window on top of every other window.  Does nothing while it is hidden.
+//--------------------------------------------------------------------------------------------------
+void Window::raise_window()
+{
+    if (! get_visible())
+        return;
+
+    border_surface->raise_surface();
+    text_surface->raise_surface();
+
+    show_stack_change();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts the window beneath every other window.  Does nothing while it is hidden.
+//--------------------------------------------------------------------------------------------------
+void Window::lower_window()
+{
+    if (! get_visible())
+        return;
+
+    text_surface->lower_surface();
+    border_surface->lower_surface();
+
+    show_stack_change();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls a pad window so that the pad's cell at (row, column) is in its top left corner,
+//         or as close as the pad's size allows.  Does nothing for a window without a pad.
+//--------------------------------------------------------------------------------------------------
+void Window::set_view_origin (const unsigned int& row, const unsigned int& column)
+{
+    text_surface->set_view_origin (row, column);
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the row of the pad shown at the top of the window
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_view_row()
+{
+    return text_surface->get_view_row();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the column of the pad shown at the left of the window
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_view_column()
+{
+    return text_surface->get_view_column();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Starts a frame: the window's contents will be replaced by whatever is written until
+//         end_frame(), which then sends only the cells that changed since the previous frame to
+//         the screen.  The history is cleared, as it is for clear_window().  Returns false if the
+//         frame's back buffer couldn't be allocated, in which case writes draw directly as usual.
+//--------------------------------------------------------------------------------------------------
+bool Window::begin_frame()
+{
+    if (frame_surface == NULL)
+    {
+        frame_surface.reset (new (std::nothrow) MemorySurface (get_width(), get_height()));
+
+        if (frame_surface == NULL)
+            return false;
+
+        frame_surface->set_scrolling (true);
+        previous_frame = CellGrid (get_width(), get_height());
+    }
+
+    history.clear();
+    scroll_offset = 0;
+
+    frame_surface->erase_surface();
+    is_in_frame = true;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Ends a frame started with begin_frame(), sending only the changed cells to the screen.
+//         Returns the number of bytes of text sent, 0 when the frame is identical to the last one.
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::end_frame()
+{
+    if (! is_in_frame)
+        return 0;
+
+    is_in_frame = false;
+
+    unsigned long int bytes_sent = put_changed_cells();
+
+    if (bytes_sent > 0)
+    {
+        bytes_written += bytes_sent;
+        refresh_text_window();
+    }
+
+    return bytes_sent;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Overwrites one whole row of the text window, padding with spaces to the window's width,
+//         without touching the history or the rest of the window.  Used by widgets that manage the
+//         window's contents themselves; call refresh_window() once all rows are drawn.  Tabs and
+//         other control characters are expanded as they are in a write.
+//--------------------------------------------------------------------------------------------------
+void Window::draw_line (const unsigned int& row, const char* text, const std::size_t& length,
+                        const bool& highlighted)
+{
+    static const char spaces[] = "                                ";
+    const std::size_t spaces_length = sizeof (spaces) - 1;
+
+    unsigned int width = get_width();
+    std::size_t line_length = length;
+
+    if (has_control_characters (text, length))
+    {
+        expand_control_characters (text, length, 0, width, expanded_text, expanded_positions);
+        text = expanded_text.data();
+        line_length = expanded_text.size();
+    }
+
+    std::size_t text_length = get_fitting_length (text, line_length, width);
+    unsigned int text_columns = get_display_width (text, text_length);
+
+    // Without scrolling, filling the bottom right cell won't scroll the whole window up
+    text_surface->set_scrolling (false);
+    text_surface->set_style (highlighted ? highlighted_style : plain_style);
+
+    text_surface->put_text_at (row, 0, text, text_length);
+    bytes_written += width;
+    is_previous_frame_valid = false;
+
+    for (std::size_t column = text_columns; column < width; column += spaces_length)
+    {
+        std::size_t padding = width - column < spaces_length ? width - column : spaces_length;
+        text_surface->put_text (spaces, padding);
+    }
+
+    text_surface->set_style (plain_style);
+    text_surface->set_scrolling (true);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Refreshes the text window, or marks it dirty in deferred mode
+//--------------------------------------------------------------------------------------------------
+void Window::refresh_window()
+{
+    refresh_text_window();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls the view back towards older lines of the history
+//--------------------------------------------------------------------------------------------------
+void Window::scroll_up (const unsigned int& lines)
+{
+    unsigned int max_scroll_offset = get_max_scroll_offset();
+
+    if (lines >= max_scroll_offset - scroll_offset)
+        scroll_offset = max_scroll_offset;
+    else
+        scroll_offset += lines;
+
+    render_history();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls the view forward towards the newest lines of the history.  Once the bottom is
+//         reached, new writes are displayed as they arrive again.
+//--------------------------------------------------------------------------------------------------
+void Window::scroll_down (const unsigned int& lines)
+{
+    if (lines >= scroll_offset)
+        scroll_offset = 0;
+    else
+        scroll_offset -= lines;
+
+    render_history();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Scrolls so that the requested history line (0 being the oldest stored line) is at the top
+//         of the window, or as close to the top as the amount of history allows
+//--------------------------------------------------------------------------------------------------
+void Window::scroll_to_line (const unsigned int& line)
+{
+    unsigned int max_scroll_offset = get_max_scroll_offset();
+
+    if (line >= max_scroll_offset)
+        scroll_offset = 0;
+    else
+        scroll_offset = max_scroll_offset - line;
+
+    render_history();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of lines currently stored in the window's history
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_history_line_count()
+{
+    return history.get_line_count();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the most lines the window's history can hold
+//--------------------------------------------------------------------------------------------------
+unsigned int Window::get_history_capacity()
+{
+    return history.get_capacity();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Stages the window onto the backend's virtual screen if it changed since it was last
+//         staged.  Returns whether it did, so the caller knows a Backend::update() is needed.
+//--------------------------------------------------------------------------------------------------
+bool Window::stage_refresh()
+{
+    if (! is_dirty)
+        return false;
+
+    StatClock::time_point start = StatClock::now();
+
+    text_surface->stage_surface();
+    counters.refresh_time.record_since (start);
+    is_dirty = false;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Makes every write replace the window's contents instead of adding to them, for status
+//         windows that should only show the newest value
+//--------------------------------------------------------------------------------------------------
+void Window::set_latest_value_only (const bool& latest_value_only)
+{
+    is_latest_value_only = latest_value_only;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns whether every write replaces the window's contents
+//--------------------------------------------------------------------------------------------------
+bool Window::get_latest_value_only()
+{
+    return is_latest_value_only;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Switches between refreshing the terminal on every write (the default) and only marking
+//         the window as dirty, leaving stage_refresh() and Backend::update() to the caller
+//--------------------------------------------------------------------------------------------------
+void Window::set_deferred_refresh (const bool& deferred)
+{
+    is_deferred_refresh = deferred;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many refreshes were deferred since the last call and resets the count
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::take_deferred_refresh_count()
+{
+    unsigned long int count = deferred_refresh_count;
+    deferred_refresh_count = 0;
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many bytes of text were sent to the screen since the last call and resets
+//         the count
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::take_bytes_written()
+{
+    unsigned long int count = bytes_written;
+    bytes_written = 0;
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns a snapshot of what the window has done since it was made.  Safe from any thread,
+//         but the window number is left for the UI to fill in.
+//--------------------------------------------------------------------------------------------------
+WindowStats Window::get_stats()
+{
+    WindowStats stats;
+
+    stats.window_number = 0;
+    stats.writes = counters.writes.get();
+    stats.bytes_written = counters.bytes_written.get();
+    stats.refresh_time = counters.refresh_time.get_snapshot();
+    stats.update_time = counters.update_time.get_snapshot();
+
+    return stats;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many writes and relayouts found their line breaks already worked out
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::get_line_break_cache_hits()
+{
+    return line_breaks.get_hit_count();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns how many writes and relayouts had to measure their text to break it into lines
+//--------------------------------------------------------------------------------------------------
+unsigned long int Window::get_line_break_cache_misses()
+{
+    return line_breaks.get_miss_count();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -139,7 +1164,7 @@ void Window::clear_window()
 //--------------------------------------------------------------------------------------------------
 unsigned int Window::get_width()
 {
-    return getmaxx (ncurse_text_ptr);
+    return text_surface->get_width();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -147,5 +1172,5 @@ unsigned int Window::get_width()
 //--------------------------------------------------------------------------------------------------
 unsigned int Window::get_height()
 {
-    return getmaxy (ncurse_text_ptr);
+    return text_surface->get_height();
 }
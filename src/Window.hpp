@@ -3,14 +3,15 @@
 // File:        Window.hpp
 // Description: A Window class that uses the power of nCurses to build windows, while purposely
 //              avoiding all of nCurses major downfalls.
-// Notes:       This class should only be called from within the UI class, as the UI constructor
-//              contains the initscr() and endwin() ncurses functions that need to be called before
-//              and after the lifetime of these Window objects.  The UI constructor also calls n
-//              noecho(), a function that keeps wgetch() from inserting values into the screen for
-//              us during the Window class' live_input() method.
+// Notes:       This class should only be called from within the UI class, as the UI owns the
+//              Backend that needs to exist before and after the lifetime of these Window objects.
+//              The default NcursesBackend calls initscr() and endwin(), as well as noecho(), a
+//              function that keeps wgetch() from inserting values into the screen for us during
+//              the Window class' live_input() method.
 //
-//              Window = an instance of this Window wrapper class
-//              WINDOW = an instance of an nCurses window
+//              Window  = an instance of this Window wrapper class
+//              Surface = a rectangular drawing area provided by the Backend (an nCurses WINDOW
+//                        when using the default NcursesBackend)
 //
 // Author:      Joseph Lyons
 //--------------------------------------------------------------------------------------------------
@@ -19,31 +20,175 @@
 #define Window_hpp
 
 #include <iostream>
-#include <ncurses.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Backend.hpp"
+#include "History.hpp"
+#include "LineEditor.hpp"
+#include "MemoryBackend.hpp"
+#include "Stats.hpp"
+#include "Style.hpp"
+#include "TextLayout.hpp"
 #include "Write.hpp"
 
 class Window : public Write
 {
 private:
-    WINDOW* ncurse_border_ptr;
-    WINDOW* ncurse_text_ptr;
-    const bool is_center_print_window;
+    Backend& backend;
+    std::unique_ptr<Surface> border_surface;
+    std::unique_ptr<Surface> text_surface;
+    const std::string title;
+    const TextAlignment alignment;
+    bool is_deferred_refresh;
+    bool is_dirty;
+    bool is_latest_value_only;
+    unsigned long int deferred_refresh_count;
+    History history;
+    unsigned int scroll_offset;
+    unsigned long int bytes_written;
+    WindowCounters counters;
+
+    // Retained mode: a frame is drawn into frame_surface and only the cells that differ from
+    // previous_frame are sent to text_surface
+    std::unique_ptr<MemorySurface> frame_surface;
+    CellGrid previous_frame;
+    bool is_in_frame;
+    bool is_previous_frame_valid;
+
+    // Line editing: the line is drawn from edit_column to the end of edit_row, and edit_cells
+    // holds the UTF-8 each column of that stretch currently shows so only changed cells are
+    // redrawn.  The right half of a wide character is an empty cell.  edit_layout and edit_run
+    // are kept between repaints so drawing the line doesn't allocate.
+    LineEditor line_editor;
+    bool is_line_edit_active;
+    bool is_line_edit_dirty;
+    unsigned int edit_row;
+    unsigned int edit_column;
+    std::size_t edit_scroll;
+    std::vector<std::string> edit_cells;
+    std::vector<std::string> edit_layout;
+    std::string edit_run;
+
+    // Text layout: the line pieces of recently written text, and room to lay out text too long
+    // to be kept.  Text holding tabs or other control characters is expanded into expanded_text
+    // first, with its spans moved into expanded_spans.
+    LineBreakCache line_breaks;
+    std::vector<LinePiece> long_text_pieces;
+    std::string expanded_text;
+    std::vector<std::size_t> expanded_positions;
+    std::vector<StyleSpan> expanded_spans;
 
     // Private methods
-    void write_definition (const std::string& text, const bool& newline) override;
-    std::string get_centered_text (const std::string& text);
+    Surface& get_drawing_surface();
+    void put_line_break (History& target, Surface* surface, const LineEnd& line_end,
+                         const bool& is_line_full);
+    Style put_styled_text (History& target, Surface* surface, const char* text,
+                           const std::size_t& start, const std::size_t& length,
+                           const StyleSpan* spans, const std::size_t& span_count);
+    unsigned int get_centering_offset (const std::size_t& length);
+    void refresh_text_window();
+    void refresh_text_surface();
+    void update_screen();
+    void show_stack_change();
+    unsigned int get_max_scroll_offset();
+    void render_history();
+    void draw_border_and_title();
+    unsigned long int put_glyphs (const char32_t* glyphs, const std::size_t& count);
+    unsigned long int put_changed_cells();
+    void start_line_edit();
+    void put_line_edit_cells();
+    void commit_line_edit (std::string& line);
 
-public:
+    // Lays the history out again at the window's current width, with the window's policies
+    virtual void rewrap_history() = 0;
+
+    // Writes text with parts of it drawn in the styles of spans, with the window's policies
+    virtual void write_spans_definition (const char* text, const std::size_t& length,
+                                         const StyleSpan* spans, const std::size_t& span_count,
+                                         const bool& newline) = 0;
+
+    template <typename WrapPolicy>
+    const std::vector<LinePiece>& get_line_pieces (const char* text, const std::size_t& length,
+                                                   unsigned int column,
+                                                   const unsigned int& width);
+    template <typename AlignPolicy>
+    bool put_line_pieces (History& target, Surface* surface, const char* text,
+                          const StyleSpan* spans, const std::size_t& span_count,
+                          const std::vector<LinePiece>& pieces, unsigned int column,
+                          const unsigned int& width);
+
+protected:
+    // Windows are made as a BasicWindow, which picks the policies this write path is built with
     Window (const unsigned int& x, const unsigned int& y,
             const unsigned int& width, const unsigned int& height,
-            const std::string& window_title, const bool& is_center_print_window_input);
+            const std::string& window_title, const TextAlignment& alignment_input,
+            const unsigned int& history_capacity, Backend& backend_input,
+            const unsigned int& pad_width, const unsigned int& pad_height);
+
+    template <typename AlignPolicy, typename WrapPolicy, typename RefreshPolicy>
+    void write_with_policies (const char* text, const std::size_t& length,
+                              const StyleSpan* spans, const std::size_t& span_count,
+                              const bool& newline);
+    template <typename AlignPolicy, typename WrapPolicy>
+    void rewrap_with_policies();
+
+public:
+    virtual ~Window();
 
-    ~Window();
+    // Styled writes sit beside the plain ones from Write
+    using Write::write;
+    void write (const char* text, const std::size_t& length, const Style& style,
+                const bool& newline);
+    void write (const std::string_view& text, const Style& style, const bool& newline);
+    void write_spans (const char* text, const std::size_t& length, const StyleSpan* spans,
+                      const std::size_t& span_count, const bool& newline);
 
     char live_input (const bool& newline);
+    char live_edit_input();
+    std::string read_line();
+    LineEditAction edit_line (const int& key, std::string& line);
+    void draw_line_edit();
     void print_divider (const char& divider_symbol);
 
     void clear_window();
+    void redraw();
+    void set_geometry (const unsigned int& x, const unsigned int& y,
+                       const unsigned int& width, const unsigned int& height);
+
+    void set_visible (const bool& visible);
+    bool get_visible();
+    void raise_window();
+    void lower_window();
+
+    void set_view_origin (const unsigned int& row, const unsigned int& column);
+    unsigned int get_view_row();
+    unsigned int get_view_column();
+
+    bool begin_frame();
+    unsigned long int end_frame();
+
+    void draw_line (const unsigned int& row, const char* text, const std::size_t& length,
+                    const bool& highlighted);
+    void refresh_window();
+
+    void scroll_up (const unsigned int& lines);
+    void scroll_down (const unsigned int& lines);
+    void scroll_to_line (const unsigned int& line);
+    unsigned int get_history_line_count();
+    unsigned int get_history_capacity();
+
+    void set_deferred_refresh (const bool& deferred);
+    unsigned long int take_deferred_refresh_count();
+    unsigned long int take_bytes_written();
+    bool stage_refresh();
+
+    void set_latest_value_only (const bool& latest_value_only);
+    bool get_latest_value_only();
+
+    WindowStats get_stats();
+    unsigned long int get_line_break_cache_hits();
+    unsigned long int get_line_break_cache_misses();
 
     unsigned int get_width();
     unsigned int get_height();
@@ -6,14 +6,44 @@
 // Author:      Joseph Lyons
 //--------------------------------------------------------------------------------------------------
 
+#include <charconv>
+#include <cstring>
 #include "Write.hpp"
 
+// Large enough for any double in fixed notation with six decimals (the std::to_string format)
+static const std::size_t number_buffer_size = 320;
+
 //--------------------------------------------------------------------------------------------------
 // Public: Calls the write_definition that the derived class must implement
 //--------------------------------------------------------------------------------------------------
+void Write::write (const char* text, const std::size_t& length, const bool& newline)
+{
+    write_definition (text, length, newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a null terminated string calling the write_definition that the derived class must
+//         implement
+//--------------------------------------------------------------------------------------------------
+void Write::write (const char* text, const bool& newline)
+{
+    write_definition (text, std::strlen (text), newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a string_view calling the write_definition that the derived class must implement
+//--------------------------------------------------------------------------------------------------
+void Write::write (const std::string_view& text, const bool& newline)
+{
+    write_definition (text.data(), text.length(), newline);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Write a string calling the write_definition that the derived class must implement
+//--------------------------------------------------------------------------------------------------
 void Write::write (const std::string& text, const bool& newline)
 {
-    write_definition (text, newline);
+    write_definition (text.data(), text.length(), newline);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -21,7 +51,9 @@ void Write::write (const std::string& text, const bool& newline)
 //--------------------------------------------------------------------------------------------------
 void Write::write (const int& int_number, const bool& newline)
 {
-    write_definition (std::to_string (int_number), newline);
+    char buffer[number_buffer_size];
+    std::to_chars_result result = std::to_chars (buffer, buffer + number_buffer_size, int_number);
+    write_definition (buffer, result.ptr - buffer, newline);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -29,7 +61,10 @@ void Write::write (const int& int_number, const bool& newline)
 //--------------------------------------------------------------------------------------------------
 void Write::write (const float& float_number, const bool& newline)
 {
-    write_definition (std::to_string (float_number), newline);
+    char buffer[number_buffer_size];
+    std::to_chars_result result = std::to_chars (buffer, buffer + number_buffer_size, float_number,
+                                                 std::chars_format::fixed, 6);
+    write_definition (buffer, result.ptr - buffer, newline);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -37,7 +72,10 @@ void Write::write (const float& float_number, const bool& newline)
 //--------------------------------------------------------------------------------------------------
 void Write::write (const double& double_number, const bool& newline)
 {
-    write_definition (std::to_string (double_number), newline);
+    char buffer[number_buffer_size];
+    std::to_chars_result result = std::to_chars (buffer, buffer + number_buffer_size,
+                                                 double_number, std::chars_format::fixed, 6);
+    write_definition (buffer, result.ptr - buffer, newline);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -45,5 +83,5 @@ void Write::write (const double& double_number, const bool& newline)
 //--------------------------------------------------------------------------------------------------
 void Write::write (const char& character, const bool& newline)
 {
-    write_definition (std::string (1, character), newline);
+    write_definition (&character, 1, newline);
 }
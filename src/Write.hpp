@@ -9,17 +9,25 @@
 #ifndef Write_hpp
 #define Write_hpp
 
+#include <cstddef>
 #include <iostream>
+#include <string_view>
 
 class Write
 {
 private:
-    // Must be implemented by any derived class, all the public write functions depend on it
-    virtual void write_definition (const std::string& text, const bool& newline) = 0;
+    // Must be implemented by any derived class, all the public write functions depend on it.  The
+    // text is not null terminated; exactly length characters should be written.
+    virtual void write_definition (const char* text, const std::size_t& length,
+                                   const bool& newline) = 0;
 
 public:
     // All public overloaded write() methods should either directly call write_definition()
-    // or call other overloaded versions of write() that directly call write_definition()
+    // or call other overloaded versions of write() that directly call write_definition().  None of
+    // them allocate; numbers are formatted into a buffer on the stack.
+    void write (const char* text, const std::size_t& length, const bool& newline);
+    void write (const char* text, const bool& newline);
+    void write (const std::string_view& text, const bool& newline);
     void write (const std::string& text, const bool& newline);
     void write (const int& int_number, const bool& newline);
     void write (const float& float_number, const bool& newline);
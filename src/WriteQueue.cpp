@@ -0,0 +1,250 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        WriteQueue.cpp
+// Description: A bounded, lock-free queue of pending window writes.  Any number of threads may
+//              push writes into it while the UI's render thread pops them off and does the actual
+//              nCurses calls, since nCurses itself is not thread-safe.
+// Notes:       This is the array-based queue described by Dmitry Vyukov: every cell carries a
+//              sequence number that tells producers and consumers whether it is free or full, so a
+//              push or pop only ever costs one compare-and-swap on a shared position.  Popping is
+//              safe from several threads as well, which lets a producer throw away the oldest write
+//              when the queue is full.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "WriteQueue.hpp"
+
+// Marks the bottom of the free record stack; no record has this index
+static const unsigned int no_record = 0xFFFFFFFF;
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies a post into a record.  Assigning the text reuses the record's buffer whenever it
+//         is big enough.
+//--------------------------------------------------------------------------------------------------
+void copy_write_post (const WritePost& post, WriteRecord& record)
+{
+    record.window_number = post.window_number;
+    record.text.assign (post.text);
+    record.newline = post.newline;
+    record.style = post.style;
+    record.sequence = post.sequence;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Rounds the requested capacity up to a power of two so positions can be masked
+//--------------------------------------------------------------------------------------------------
+static std::size_t round_up_to_power_of_two (const std::size_t& value)
+{
+    std::size_t power = 2;
+
+    while (power < value)
+        power *= 2;
+
+    return power;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Allocates every cell up front; the queue never grows
+//--------------------------------------------------------------------------------------------------
+WriteQueue::WriteQueue (const std::size_t& minimum_capacity)
+    : cells (round_up_to_power_of_two (minimum_capacity)),
+      index_mask (round_up_to_power_of_two (minimum_capacity) - 1),
+      enqueue_position (0), dequeue_position (0)
+{
+    for (std::size_t i = 0; i < cells.size(); i++)
+    {
+        cells[i].sequence.store (i, std::memory_order_relaxed);
+        cells[i].record.text.reserve (reserved_write_length);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies post into the queue.  Returns false if the queue is full.  Safe to call from any
+//         number of threads at once.
+//--------------------------------------------------------------------------------------------------
+bool WriteQueue::try_push (const WritePost& post)
+{
+    std::size_t position = enqueue_position.load (std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true)
+    {
+        cell = &cells[position & index_mask];
+
+        std::size_t sequence = cell->sequence.load (std::memory_order_acquire);
+        std::ptrdiff_t difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) position;
+
+        if (difference == 0)
+        {
+            if (enqueue_position.compare_exchange_weak (position, position + 1,
+                                                        std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false;
+        else
+            position = enqueue_position.load (std::memory_order_relaxed);
+    }
+
+    copy_write_post (post, cell->record);
+    cell->sequence.store (position + 1, std::memory_order_release);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Claims the oldest cell for the caller to read.  Returns NULL if the queue is empty;
+//          otherwise the cell must be handed back with release_cell() once read.
+//--------------------------------------------------------------------------------------------------
+WriteQueue::Cell* WriteQueue::claim_oldest_cell (std::size_t& position)
+{
+    position = dequeue_position.load (std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true)
+    {
+        cell = &cells[position & index_mask];
+
+        std::size_t sequence = cell->sequence.load (std::memory_order_acquire);
+        std::ptrdiff_t difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) (position + 1);
+
+        if (difference == 0)
+        {
+            if (dequeue_position.compare_exchange_weak (position, position + 1,
+                                                        std::memory_order_relaxed))
+                return cell;
+        }
+        else if (difference < 0)
+            return NULL;
+        else
+            position = dequeue_position.load (std::memory_order_relaxed);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Hands a claimed cell back to producers
+//--------------------------------------------------------------------------------------------------
+void WriteQueue::release_cell (Cell* cell, const std::size_t& position)
+{
+    cell->sequence.store (position + index_mask + 1, std::memory_order_release);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Copies the oldest record out of the queue into record.  Returns false if the queue is
+//         empty.
+//--------------------------------------------------------------------------------------------------
+bool WriteQueue::try_pop (WriteRecord& record)
+{
+    std::size_t position;
+    Cell* cell = claim_oldest_cell (position);
+
+    if (cell == NULL)
+        return false;
+
+    record = cell->record;
+    release_cell (cell, position);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Throws the oldest record away without copying its text, and sets window_number to the
+//         window it was for.  Returns false if the queue is empty.
+//--------------------------------------------------------------------------------------------------
+bool WriteQueue::try_discard (unsigned int& window_number)
+{
+    std::size_t position;
+    Cell* cell = claim_oldest_cell (position);
+
+    if (cell == NULL)
+        return false;
+
+    window_number = cell->record.window_number;
+    release_cell (cell, position);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns the number of records the queue can hold
+//--------------------------------------------------------------------------------------------------
+std::size_t WriteQueue::get_capacity()
+{
+    return cells.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Returns roughly how many records are queued.  Only exact when no other thread is pushing
+//         or popping at the same time.
+//--------------------------------------------------------------------------------------------------
+std::size_t WriteQueue::get_approximate_size()
+{
+    std::size_t enqueued = enqueue_position.load (std::memory_order_relaxed);
+    std::size_t dequeued = dequeue_position.load (std::memory_order_relaxed);
+
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Constructor - Allocates every record up front and stacks them all as free
+//--------------------------------------------------------------------------------------------------
+WriteRecordPool::WriteRecordPool (const std::size_t& record_count)
+    : records (record_count),
+      next_free_records (new std::atomic<unsigned int>[record_count]),
+      free_records_head (record_count > 0 ? 0 : no_record)
+{
+    for (std::size_t i = 0; i < record_count; i++)
+    {
+        records[i].text.reserve (reserved_write_length);
+        next_free_records[i].store (i + 1 < record_count ? (unsigned int) (i + 1) : no_record,
+                                    std::memory_order_relaxed);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Takes a free record off the stack.  Returns NULL if every record is in use.  Safe to
+//         call from any number of threads at once.
+//--------------------------------------------------------------------------------------------------
+WriteRecord* WriteRecordPool::acquire()
+{
+    std::uint64_t head = free_records_head.load (std::memory_order_acquire);
+
+    while (true)
+    {
+        unsigned int index = (unsigned int) (head & 0xFFFFFFFF);
+
+        if (index == no_record)
+            return NULL;
+
+        std::uint64_t changes = (head >> 32) + 1;
+        std::uint64_t next_index = next_free_records[index].load (std::memory_order_relaxed);
+
+        if (free_records_head.compare_exchange_weak (head, (changes << 32) | next_index,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire))
+            return &records[index];
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Puts a record taken with acquire() back on the stack.  Safe to call from any number of
+//         threads at once.
+//--------------------------------------------------------------------------------------------------
+void WriteRecordPool::release (WriteRecord* record)
+{
+    unsigned int index = (unsigned int) (record - &records[0]);
+    std::uint64_t head = free_records_head.load (std::memory_order_relaxed);
+
+    while (true)
+    {
+        std::uint64_t changes = (head >> 32) + 1;
+
+        next_free_records[index].store ((unsigned int) (head & 0xFFFFFFFF),
+                                        std::memory_order_relaxed);
+
+        if (free_records_head.compare_exchange_weak (head, (changes << 32) | index,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed))
+            return;
+    }
+}
@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        WriteQueue.hpp
+// Description: A bounded, lock-free queue of pending window writes.  Any number of threads may
+//              push writes into it while the UI's render thread pops them off and does the actual
+//              nCurses calls, since nCurses itself is not thread-safe.
+// Notes:       This is the array-based queue described by Dmitry Vyukov: every cell carries a
+//              sequence number that tells producers and consumers whether it is free or full, so a
+//              push or pop only ever costs one compare-and-swap on a shared position.  Popping is
+//              safe from several threads as well, which lets a producer throw away the oldest write
+//              when the queue is full.  Posts are copied into the cells rather than moved, so each
+//              cell keeps its text buffer and a warm queue never allocates.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef WriteQueue_hpp
+#define WriteQueue_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Style.hpp"
+
+// What a producer thread asks the render thread to do.  sequence counts the posts to the window, so
+// a write held back by the coalesce policy can be put back in order with the queued ones.
+struct WriteRecord
+{
+    unsigned int window_number;
+    std::string text;
+    bool newline;
+    Style style = plain_style;
+    unsigned long int sequence = 0;
+};
+
+// What a producer hands over: a WriteRecord whose text still belongs to the caller, so posting
+// doesn't have to build a string of its own
+struct WritePost
+{
+    unsigned int window_number;
+    std::string_view text;
+    bool newline;
+    Style style;
+    unsigned long int sequence;
+};
+
+// Room for a typical line, reserved in every record up front so a post only allocates the first
+// time a record is handed text longer than this
+const std::size_t reserved_write_length = 80;
+
+void copy_write_post (const WritePost& post, WriteRecord& record);
+
+// What a producer does when it finds the queue full
+enum class BackpressurePolicy
+{
+    block,       // Wait for the render thread to make room
+    drop_oldest, // Throw away the oldest queued write to make room
+    coalesce,    // Keep only the newest overflowing write for each window
+};
+
+class WriteQueue
+{
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        WriteRecord record;
+    };
+
+    std::vector<Cell> cells;
+    const std::size_t index_mask;
+
+    // Kept on separate cache lines so producers and the consumer don't fight over one line
+    alignas (64) std::atomic<std::size_t> enqueue_position;
+    alignas (64) std::atomic<std::size_t> dequeue_position;
+
+    Cell* claim_oldest_cell (std::size_t& position);
+    void release_cell (Cell* cell, const std::size_t& position);
+
+public:
+    WriteQueue (const std::size_t& minimum_capacity);
+
+    bool try_push (const WritePost& post);
+    bool try_pop (WriteRecord& record);
+    bool try_discard (unsigned int& window_number);
+
+    std::size_t get_capacity();
+    std::size_t get_approximate_size();
+};
+
+// A fixed set of records handed out to producers and given back once written, so coalesced writes
+// never allocate.  The free records are a lock-free stack; its head carries a count of changes
+// next to the index of the top record, so a thread that was held up can't pop a stale top.
+class WriteRecordPool
+{
+private:
+    std::vector<WriteRecord> records;
+    std::unique_ptr<std::atomic<unsigned int>[]> next_free_records;
+    std::atomic<std::uint64_t> free_records_head;
+
+public:
+    WriteRecordPool (const std::size_t& record_count);
+
+    WriteRecord* acquire();
+    void release (WriteRecord* record);
+};
+
+#endif /* WriteQueue_hpp */
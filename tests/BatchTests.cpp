@@ -0,0 +1,124 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        BatchTests.cpp
+// Description: Tests for bulk writes: write_batch() and write_to_all_windows() apply their writes
+//              in order, newlines included, and update the screen once for the whole call.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 40;
+static const unsigned int screen_height = 6;
+static const unsigned int window_width = screen_width / 2;
+
+static const Style bold_style = { Color::default_color, Color::default_color, bold_attribute };
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns one row of a window's text, where the window's left edge is at column left
+//--------------------------------------------------------------------------------------------------
+static std::string get_window_row (MemoryBackend& screen, const unsigned int& left,
+                                   const unsigned int& row)
+{
+    return screen.get_screen_line (row + 1).substr (left + 1, window_width - 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A batch interleaving two windows lands in each window in order, with each write's newline
+//       and style, and the screen is updated once
+//--------------------------------------------------------------------------------------------------
+static void test_batch_keeps_order()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int left = ui.make_new_window (0, 0, window_width, screen_height, "", false);
+    unsigned int right = ui.make_new_window (window_width, 0, window_width, screen_height, "",
+                                             false);
+    unsigned long int update_count = screen.get_update_count();
+
+    std::vector<WriteOp> ops =
+    {
+        { left, "a", false },
+        { right, "x", true },
+        { left, "b", true, bold_style },
+        { right, "y", false },
+        { left, "c", false },
+    };
+
+    ui.write_batch (ops);
+
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK (get_window_row (screen, 0, 0).find ("ab ") == 0);
+    CHECK (get_window_row (screen, 0, 1).find ("c ") == 0);
+    CHECK (get_window_row (screen, window_width, 0).find ("x ") == 0);
+    CHECK (get_window_row (screen, window_width, 1).find ("y ") == 0);
+    CHECK (screen.get_attributes (1, 2) == pack_style (bold_style));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: write_to_all_windows() only ends the line when asked to, in every window, and updates the
+//       screen once each time
+//--------------------------------------------------------------------------------------------------
+static void test_all_windows_honor_newline()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    ui.make_new_window (0, 0, window_width, screen_height, "", false);
+    ui.make_new_window (window_width, 0, window_width, screen_height, "", false);
+
+    unsigned long int update_count = screen.get_update_count();
+
+    ui.write_to_all_windows ("one ", false);
+    ui.write_to_all_windows ("two", true);
+    ui.write_to_all_windows ("three", false);
+
+    CHECK (screen.get_update_count() == update_count + 3);
+
+    for (unsigned int left : { 0u, window_width })
+    {
+        CHECK (get_window_row (screen, left, 0).find ("one two ") == 0);
+        CHECK (get_window_row (screen, left, 1).find ("three ") == 0);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A write to a window that doesn't exist is skipped, and the rest of the batch still lands
+//--------------------------------------------------------------------------------------------------
+static void test_batch_skips_invalid_window()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, window_width, screen_height, "", false);
+    unsigned int gone = ui.make_new_window (window_width, 0, window_width, screen_height, "",
+                                            false);
+
+    ui.destroy_window (gone);
+
+    WriteOp ops[] =
+    {
+        { window, "before ", false },
+        { gone, "lost", false },
+        { window, "after", false },
+    };
+
+    ui.write_batch (ops, 3);
+
+    CHECK (screen.get_screen_text().find ("before after") != std::string::npos);
+    CHECK (screen.get_screen_text().find ("lost") == std::string::npos);
+}
+
+int main()
+{
+    run_test ("batch_keeps_order", test_batch_keeps_order);
+    run_test ("all_windows_honor_newline", test_all_windows_honor_newline);
+    run_test ("batch_skips_invalid_window", test_batch_skips_invalid_window);
+
+    return failed_check_count;
+}
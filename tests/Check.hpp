@@ -0,0 +1,64 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        Check.hpp
+// Description: The little the unit tests need to check results and report failures.
+// Notes:       Each test file is its own program, registered with ctest, which runs its tests in
+//              turn and exits with the number of checks that failed, so 0 means it passed.  A
+//              failed check prints where it is and carries on, so one run shows every failure.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#ifndef Check_hpp
+#define Check_hpp
+
+#include <cstdio>
+#include <string>
+
+// How many checks have failed in this test program so far
+inline unsigned int failed_check_count = 0;
+
+//--------------------------------------------------------------------------------------------------
+// Public: Prints a failed check with the file and line it is on, and counts it
+//--------------------------------------------------------------------------------------------------
+inline void check (const bool& condition, const char* description, const char* file,
+                   const int& line)
+{
+    if (condition)
+        return;
+
+    std::fprintf (stderr, "%s:%d: check failed: %s\n", file, line, description);
+    failed_check_count++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Checks that two values are equal, printing both when they aren't
+//--------------------------------------------------------------------------------------------------
+inline void check_equal (const std::string& actual, const std::string& expected,
+                         const char* description, const char* file, const int& line)
+{
+    if (actual == expected)
+        return;
+
+    std::fprintf (stderr, "%s:%d: check failed: %s\n    actual:   \"%s\"\n    expected: \"%s\"\n",
+                  file, line, description, actual.c_str(), expected.c_str());
+    failed_check_count++;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public: Runs one test, printing its name so a failure can be told apart from the others
+//--------------------------------------------------------------------------------------------------
+inline void run_test (const char* name, void (*test)())
+{
+    unsigned int failures_before = failed_check_count;
+
+    test();
+
+    std::printf ("%s %s\n", failed_check_count == failures_before ? "passed" : "FAILED", name);
+}
+
+// The file and line of a check are what make a failure quick to find
+#define CHECK(condition) check ((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) \
+    check_equal ((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#endif /* Check_hpp */
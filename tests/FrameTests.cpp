@@ -0,0 +1,94 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        FrameTests.cpp
+// Description: Tests for retained-mode frames: a window's frame only sends the cells whose glyph or
+//              style differ from its previous frame.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 12;
+static const unsigned int screen_height = 5;
+
+// Every cell of the window's text area
+static const unsigned long int cell_count = (screen_width - 2) * (screen_height - 2);
+
+static const Style bold_style = { Color::default_color, Color::default_color, bold_attribute };
+
+//--------------------------------------------------------------------------------------------------
+// Private: Draws one frame holding just the text and returns how many bytes it sent
+//--------------------------------------------------------------------------------------------------
+static unsigned long int draw_frame (UI& ui, const unsigned int& window, const std::string& text,
+                                     const Style& style = plain_style)
+{
+    ui.begin_window_frame (window);
+    ui.write_to_window (window, text, style, false);
+
+    return ui.end_window_frame (window);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: The first frame sends every cell, the same frame again sends none, and a frame with one
+//       character changed sends just that character
+//--------------------------------------------------------------------------------------------------
+static void test_only_changed_cells_are_sent()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    CHECK (draw_frame (ui, window, "abc") == cell_count);
+    CHECK (draw_frame (ui, window, "abc") == 0);
+    CHECK (screen.get_screen_line (1).find ("|abc ") == 0);
+
+    CHECK (draw_frame (ui, window, "abd") == 1);
+    CHECK (screen.get_screen_line (1).find ("|abd ") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A cell whose style changes is sent even though its glyph didn't
+//--------------------------------------------------------------------------------------------------
+static void test_style_change_is_sent()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    draw_frame (ui, window, "abc");
+
+    CHECK (draw_frame (ui, window, "abc", bold_style) == 3);
+    CHECK (screen.get_attributes (1, 1) == pack_style (bold_style));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Once the window is written to outside of a frame, the next frame can't trust what the
+//       screen shows and sends every cell
+//--------------------------------------------------------------------------------------------------
+static void test_write_outside_frame_resends_all()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    draw_frame (ui, window, "abc");
+    ui.write_to_window (window, "xyz", false);
+
+    CHECK (draw_frame (ui, window, "abc") == cell_count);
+    CHECK (screen.get_screen_line (1).find ("|abc ") == 0);
+}
+
+int main()
+{
+    run_test ("only_changed_cells_are_sent", test_only_changed_cells_are_sent);
+    run_test ("style_change_is_sent", test_style_change_is_sent);
+    run_test ("write_outside_frame_resends_all", test_write_outside_frame_resends_all);
+
+    return failed_check_count;
+}
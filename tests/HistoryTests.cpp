@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        HistoryTests.cpp
+// Description: Tests for History: a history keeps only its newest lines, and a window scrolls back
+//              through them.  It only spends memory on multibyte text and on styles once they are
+//              appended, and the lines stored before then survive the slots growing.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+#include "History.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const Style bold_style = { Color::default_color, Color::default_color, bold_attribute };
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the text of one line of the history
+//--------------------------------------------------------------------------------------------------
+static std::string get_line_text (History& history, const unsigned int& line)
+{
+    unsigned int length = 0;
+    const char* text = history.get_line (line, length);
+
+    return std::string (text, length);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the text shown on one row of a window made at the top left of the screen, with
+//          its border taken off
+//--------------------------------------------------------------------------------------------------
+static std::string get_window_row (MemoryBackend& screen, const unsigned int& row,
+                                   const unsigned int& width)
+{
+    return screen.get_screen_line (row + 1).substr (1, width - 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Once the history is full, each new line takes the place of the oldest, and lines longer
+//       than the history is wide wrap onto lines of their own
+//--------------------------------------------------------------------------------------------------
+static void test_full_history_keeps_newest_lines()
+{
+    History history (4, 8);
+
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        std::string line = "line " + std::to_string (i) + "\n";
+
+        history.append (line.data(), line.size());
+    }
+
+    CHECK (history.get_line_count() == 4);
+    CHECK_EQUAL (get_line_text (history, 0), "line 7");
+    CHECK_EQUAL (get_line_text (history, 2), "line 9");
+    CHECK_EQUAL (get_line_text (history, 3), "");
+
+    history.append ("wrapped", 7);
+
+    history.append (" text", 5);
+
+    CHECK_EQUAL (get_line_text (history, 2), "wrapped ");
+    CHECK_EQUAL (get_line_text (history, 3), "text");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A window scrolls back through its history a line at a time or straight to a line, stays
+//       where it is while new lines arrive, and shows them again once it is scrolled to the bottom
+//--------------------------------------------------------------------------------------------------
+static void test_window_scrolls_through_history()
+{
+    const unsigned int width = 10;
+    const unsigned int height = 5;
+
+    MemoryBackend screen (width, height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, width, height, "", false, 8);
+
+    for (unsigned int i = 0; i < 10; i++)
+        ui.write_to_window (window, "line " + std::to_string (i), true);
+
+    CHECK (ui.get_window_history_line_count (window) == 8);
+    CHECK_EQUAL (get_window_row (screen, 0, width), "line 8  ");
+    CHECK_EQUAL (get_window_row (screen, 2, width), "        ");
+
+    ui.scroll_window_up (window, 2);
+
+    CHECK_EQUAL (get_window_row (screen, 0, width), "line 6  ");
+
+    ui.scroll_window_to_line (window, 0);
+
+    CHECK_EQUAL (get_window_row (screen, 0, width), "line 3  ");
+
+    ui.write_to_window (window, "line 10", true);
+
+    CHECK_EQUAL (get_window_row (screen, 0, width), "line 3  ");
+
+    ui.scroll_window_down (window, 100);
+
+    CHECK_EQUAL (get_window_row (screen, 0, width), "line 9  ");
+    CHECK_EQUAL (get_window_row (screen, 1, width), "line 10 ");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Plain ASCII never allocates once the history is made, however many lines go through it;
+//       the first multibyte line grows the slots, and the ones after it fit
+//--------------------------------------------------------------------------------------------------
+static void test_slots_grow_for_multibyte_text()
+{
+    History history (8, 4);
+
+    unsigned long int allocations_before = get_allocation_count();
+
+    for (unsigned int i = 0; i < 20; i++)
+        history.append ("abc\n", 4);
+
+    CHECK (get_allocation_count() == allocations_before);
+    CHECK (history.get_line_style_ids (0) == NULL);
+
+    history.append ("\xC3\xA9\xC3\xA9\xC3\xA9\n", 7);
+
+    allocations_before = get_allocation_count();
+    history.append ("\xE4\xB8\xAD\n", 4);
+
+    CHECK (get_allocation_count() == allocations_before);
+
+    unsigned int line_count = history.get_line_count();
+
+    CHECK_EQUAL (get_line_text (history, line_count - 5), "abc");
+    CHECK_EQUAL (get_line_text (history, line_count - 4), "abc");
+    CHECK_EQUAL (get_line_text (history, line_count - 3), "\xC3\xA9\xC3\xA9\xC3\xA9");
+    CHECK_EQUAL (get_line_text (history, line_count - 2), "\xE4\xB8\xAD");
+    CHECK_EQUAL (get_line_text (history, line_count - 1), "");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Style ids appear with the first styled text, with the plain text before it read as plain,
+//       and are kept when the slots grow afterwards
+//--------------------------------------------------------------------------------------------------
+static void test_style_ids_start_with_styled_text()
+{
+    History history (4, 4);
+
+    history.append ("ab\n", 3);
+
+    CHECK (! history.has_styles());
+    CHECK (history.get_line_style_ids (0) == NULL);
+
+    history.append ("cd", 2, bold_style);
+    history.append ("\xC3\xA9", 2);
+
+    const unsigned char* plain_ids = history.get_line_style_ids (0);
+    const unsigned char* styled_ids = history.get_line_style_ids (1);
+
+    CHECK (history.has_styles());
+    CHECK (plain_ids != NULL && plain_ids[0] == 0 && plain_ids[1] == 0);
+    CHECK (styled_ids != NULL && history.get_style (styled_ids[0]) == bold_style);
+    CHECK (styled_ids != NULL && history.get_style (styled_ids[1]) == bold_style);
+    CHECK (styled_ids != NULL && styled_ids[2] == 0 && styled_ids[3] == 0);
+    CHECK_EQUAL (get_line_text (history, 1), "cd\xC3\xA9");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A line whose every byte is taken by combining marks before its columns are full wraps
+//       rather than getting stuck on the next character
+//--------------------------------------------------------------------------------------------------
+static void test_line_full_of_marks_wraps()
+{
+    History history (4, 2);
+
+    // One column, eight bytes: as many as a two column line can ever hold
+    history.append ("a\xE2\x83\x90\xCC\x81\xCC\x81", 8);
+    history.append ("b", 1);
+
+    CHECK (history.get_line_count() == 2);
+    CHECK_EQUAL (get_line_text (history, 0), "a\xE2\x83\x90\xCC\x81\xCC\x81");
+    CHECK_EQUAL (get_line_text (history, 1), "b");
+}
+
+int main()
+{
+    run_test ("full_history_keeps_newest_lines", test_full_history_keeps_newest_lines);
+    run_test ("window_scrolls_through_history", test_window_scrolls_through_history);
+    run_test ("slots_grow_for_multibyte_text", test_slots_grow_for_multibyte_text);
+    run_test ("style_ids_start_with_styled_text", test_style_ids_start_with_styled_text);
+    run_test ("line_full_of_marks_wraps", test_line_full_of_marks_wraps);
+
+    return failed_check_count;
+}
@@ -0,0 +1,326 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        InputTests.cpp
+// Description: Tests for input: poll_input() delivers every key already typed as events to the
+//              focused window, and nCurses escape sequences arrive as single key codes.
+//              live_input() writes each character the moment it is typed, while live_edit_input()
+//              holds the line in the line editor until enter is pressed.  The line editor moves and
+//              erases whole UTF-8 characters and lays them out by column.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "Check.hpp"
+#include "LineEditor.hpp"
+#include "MemoryBackend.hpp"
+#include "NcursesBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 20;
+static const unsigned int screen_height = 5;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the window's first line of text, as it is on the screen
+//--------------------------------------------------------------------------------------------------
+static std::string get_first_line (MemoryBackend& screen)
+{
+    std::string line = screen.get_screen_line (1);
+
+    return line.substr (1, screen_width - 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Types UTF-8 text into a line editor a byte at a time, as the keyboard delivers it
+//--------------------------------------------------------------------------------------------------
+static void type_text (LineEditor& editor, const std::string& text)
+{
+    for (char character : text)
+        editor.handle_key ((unsigned char) character);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Queues UTF-8 text as key presses, a byte at a time, and returns how many were queued
+//--------------------------------------------------------------------------------------------------
+static unsigned int push_text (MemoryBackend& screen, const std::string& text)
+{
+    for (char character : text)
+        screen.push_key ((unsigned char) character);
+
+    return text.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: One poll_input() delivers a whole burst of keys to the focused window, in order, as
+//       character and key events; with nothing typed it returns at once with none
+//--------------------------------------------------------------------------------------------------
+static void test_poll_input_delivers_burst()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    std::vector<InputEvent> events;
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+    unsigned int other_window = ui.make_new_window (0, 0, 5, 3, "", false);
+
+    ui.set_input_callback (window, [&events] (const InputEvent& event)
+                                   {
+                                       events.push_back (event);
+                                   });
+    ui.set_input_callback (other_window, [&events] (const InputEvent& event)
+                                         {
+                                             events.push_back (event);
+                                         });
+    ui.set_focused_window (window);
+
+    screen.push_key ('a');
+    screen.push_key (key_up);
+    screen.push_key ('b');
+
+    CHECK (ui.poll_input (0) == 3);
+    CHECK (events.size() == 3);
+    CHECK (events[0].type == InputEventType::character && events[0].key == 'a');
+    CHECK (events[1].type == InputEventType::key && events[1].key == key_up);
+    CHECK (events[2].type == InputEventType::character && events[2].key == 'b');
+
+    CHECK (ui.poll_input (0) == 0);
+
+    // A resize goes to every window with a callback, focused or not
+    events.clear();
+    screen.resize_screen (screen_width + 2, screen_height);
+
+    CHECK (ui.poll_input (0) == 1);
+    CHECK (events.size() == 2);
+    CHECK (events[0].type == InputEventType::resize);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A pasted burst of several lines gives the line callback each line in turn, and keys the
+//       line editor has no use for still reach the input callback
+//--------------------------------------------------------------------------------------------------
+static void test_pasted_lines_reach_line_callback()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    std::vector<std::string> lines;
+    std::vector<int> keys;
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    ui.set_line_callback (window, [&lines] (const std::string& line)
+                                  {
+                                      lines.push_back (line);
+                                  });
+    ui.set_input_callback (window, [&keys] (const InputEvent& event)
+                                   {
+                                       keys.push_back (event.key);
+                                   });
+    ui.set_focused_window (window);
+
+    unsigned int key_count = push_text (screen, "first\nsecond\nthi");
+
+    screen.push_key (key_page_up);
+
+    CHECK (ui.poll_input (0) == key_count + 1);
+    CHECK (lines == std::vector<std::string> ({ "first", "second" }));
+    CHECK (keys == std::vector<int> ({ key_page_up }));
+    CHECK (screen.get_screen_line (3).find ("|thi ") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: nCurses decodes the escape sequences terminfo gives for keys into single key codes, and
+//       either byte a terminal sends for backspace becomes key_backspace
+//--------------------------------------------------------------------------------------------------
+static void test_ncurses_decodes_keys()
+{
+    int descriptors[2];
+
+    if (pipe (descriptors) != 0)
+    {
+        CHECK (false);
+        return;
+    }
+
+    FILE* output_file = std::tmpfile();
+    FILE* input_file = fdopen (descriptors[0], "r");
+
+    {
+        NcursesBackend terminal (output_file, input_file, "xterm");
+        const char* key_names[] = { "kcuu1", "kcub1", "kdch1", "kf1" };
+
+        for (const char* key_name : key_names)
+        {
+            const char* sequence = tigetstr (key_name);
+
+            if (sequence != NULL && sequence != (const char*) -1)
+                CHECK (write (descriptors[1], sequence, std::strlen (sequence)) > 0);
+        }
+
+        CHECK (write (descriptors[1], "x\x7F\b", 3) == 3);
+
+        CHECK (terminal.poll_key (1000) == key_up);
+        CHECK (terminal.poll_key (1000) == key_left);
+        CHECK (terminal.poll_key (1000) == key_delete);
+        CHECK (terminal.poll_key (1000) == key_function_1);
+        CHECK (terminal.poll_key (1000) == 'x');
+        CHECK (terminal.poll_key (1000) == key_backspace);
+        CHECK (terminal.poll_key (1000) == key_backspace);
+        CHECK (terminal.poll_key (0) == no_key);
+    }
+
+    close (descriptors[1]);
+    std::fclose (input_file);
+    std::fclose (output_file);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: live_input() writes every character into the window as it is typed.  Keys that aren't
+//       characters, backspace among them, come back as 0 and change nothing.
+//--------------------------------------------------------------------------------------------------
+static void test_live_input_writes_each_key()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    screen.push_key ('a');
+    screen.push_key ('b');
+    screen.push_key (key_backspace);
+
+    CHECK (ui.live_input (window, false) == 'a');
+    CHECK (ui.live_input (window, false) == 'b');
+    CHECK (ui.live_input (window, false) == 0);
+    CHECK (get_first_line (screen).find ("ab") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: live_edit_input() shows the line as it is edited, and only writes it once enter is pressed
+//--------------------------------------------------------------------------------------------------
+static void test_live_edit_input_waits_for_enter()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+    unsigned int line_count = ui.get_window_history_line_count (window);
+
+    screen.push_key ('a');
+    screen.push_key ('x');
+    screen.push_key (key_backspace);
+    screen.push_key ('b');
+
+    for (unsigned int i = 0; i < 4; i++)
+        ui.live_edit_input (window);
+
+    CHECK (get_first_line (screen).find ("ab") == 0);
+    CHECK (ui.get_window_history_line_count (window) == line_count);
+
+    screen.push_key ('\n');
+
+    CHECK (ui.live_edit_input (window) == '\n');
+    CHECK (ui.get_window_history_line_count (window) > line_count);
+    CHECK (get_first_line (screen).find ("ab") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: The cursor steps over a multibyte character in one go, and backspace and delete take out
+//       the whole character rather than one of its bytes
+//--------------------------------------------------------------------------------------------------
+static void test_line_editor_edits_whole_characters()
+{
+    LineEditor editor (10);
+
+    type_text (editor, "h\xC3\xA9llo");
+
+    for (unsigned int i = 0; i < 3; i++)
+        editor.handle_key (key_left);
+
+    CHECK (editor.get_cursor() == 3);
+
+    editor.handle_key (key_backspace);
+
+    CHECK_EQUAL (editor.get_text(), std::string ("hllo"));
+    CHECK (editor.get_cursor() == 1);
+
+    type_text (editor, "\xE4\xB8\xAD");
+    editor.handle_key (key_left);
+    editor.handle_key (key_left);
+
+    CHECK (editor.get_cursor() == 0);
+
+    editor.handle_key (key_right);
+    editor.handle_key (key_right);
+
+    CHECK (editor.get_cursor() == 4);
+
+    editor.handle_key (key_left);
+    editor.handle_key (key_delete);
+
+    CHECK_EQUAL (editor.get_text(), std::string ("hllo"));
+
+    editor.handle_key (key_insert);
+    type_text (editor, "\xC3\xA9");
+
+    CHECK_EQUAL (editor.get_text(), std::string ("h\xC3\xA9lo"));
+    CHECK (editor.get_cursor() == 3);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A wide character takes two columns of the edited line, so the characters after it and the
+//       cursor land where they will be once the line is written
+//--------------------------------------------------------------------------------------------------
+static void test_live_edit_input_lays_out_by_column()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+    unsigned int key_count = push_text (screen, "a\xE4\xB8\xAD\xC3\xA9");
+
+    for (unsigned int i = 0; i < key_count; i++)
+        ui.live_edit_input (window);
+
+    CHECK (get_first_line (screen).find ("a\xE4\xB8\xAD\xC3\xA9 ") == 0);
+    CHECK (screen.get_glyph (1, 2) == 0x4E2D);
+    CHECK (screen.get_glyph (1, 4) == 0xE9);
+
+    screen.push_key (key_left);
+    screen.push_key (key_left);
+    screen.push_key (key_backspace);
+
+    for (unsigned int i = 0; i < 3; i++)
+        ui.live_edit_input (window);
+
+    CHECK (get_first_line (screen).find ("\xE4\xB8\xAD\xC3\xA9  ") == 0);
+    CHECK (screen.get_glyph (1, 3) == 0xE9);
+
+    screen.push_key (key_delete);
+    screen.push_key ('x');
+    ui.live_edit_input (window);
+    ui.live_edit_input (window);
+
+    CHECK (get_first_line (screen).find ("x\xC3\xA9   ") == 0);
+    CHECK (screen.get_glyph (1, 2) == 0xE9);
+
+    screen.push_key ('\n');
+    ui.live_edit_input (window);
+
+    CHECK (get_first_line (screen).find ("x\xC3\xA9   ") == 0);
+}
+
+int main()
+{
+    run_test ("poll_input_delivers_burst", test_poll_input_delivers_burst);
+    run_test ("pasted_lines_reach_line_callback", test_pasted_lines_reach_line_callback);
+    run_test ("ncurses_decodes_keys", test_ncurses_decodes_keys);
+    run_test ("live_input_writes_each_key", test_live_input_writes_each_key);
+    run_test ("live_edit_input_waits_for_enter", test_live_edit_input_waits_for_enter);
+    run_test ("line_editor_edits_whole_characters", test_line_editor_edits_whole_characters);
+    run_test ("live_edit_input_lays_out_by_column", test_live_edit_input_lays_out_by_column);
+
+    return failed_check_count;
+}
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        LayoutTests.cpp
+// Description: Tests for layouts: a layout resolves to cells for any screen size, never smaller
+//              than a border around one cell and moved back onto a screen too small for it, and
+//              windows made from layouts follow the screen when it is resized.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "Check.hpp"
+#include "Layout.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+// Where a layout put a window
+struct Placement
+{
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+};
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns where the layout puts a window on a screen of the given size
+//--------------------------------------------------------------------------------------------------
+static Placement place (const Layout& layout, const unsigned int& screen_width,
+                        const unsigned int& screen_height)
+{
+    Placement placement;
+
+    resolve_layout (layout, screen_width, screen_height, placement.x, placement.y,
+                    placement.width, placement.height);
+
+    return placement;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the placement is the one given
+//--------------------------------------------------------------------------------------------------
+static bool is_placed_at (const Placement& placement, const unsigned int& x, const unsigned int& y,
+                          const unsigned int& width, const unsigned int& height)
+{
+    return placement.x == x && placement.y == y && placement.width == width &&
+           placement.height == height;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Percentages and splits resolve to the cells they describe
+//--------------------------------------------------------------------------------------------------
+static void test_layouts_resolve_to_cells()
+{
+    Layout screen = make_percent_layout (0, 0, 100, 100);
+    Layout above_status = split_layout_cells (screen, LayoutSide::top, -3);
+    Layout left_third = split_layout (above_status, LayoutSide::left, 1.0 / 3);
+    Layout status = split_layout_cells (screen, LayoutSide::bottom, 3);
+
+    CHECK (is_placed_at (place (make_percent_layout (50, 25, 50, 50), 80, 24), 40, 6, 40, 12));
+    CHECK (is_placed_at (place (left_third, 90, 24), 0, 0, 30, 21));
+    CHECK (is_placed_at (place (status, 90, 24), 0, 21, 90, 3));
+    CHECK (is_placed_at (place (make_fixed_layout (5, 2, 10, 4), 80, 24), 5, 2, 10, 4));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: On a screen too small for it, a layout is moved and shrunk to stay on the screen, but
+//       never below minimum_layout_size, even when the screen is smaller still
+//--------------------------------------------------------------------------------------------------
+static void test_small_screens()
+{
+    Layout fixed = make_fixed_layout (10, 10, 20, 20);
+    Layout status = split_layout_cells (make_percent_layout (0, 0, 100, 100), LayoutSide::bottom,
+                                        1);
+
+    CHECK (is_placed_at (place (fixed, 8, 6), 0, 0, 8, 6));
+    CHECK (is_placed_at (place (status, 20, 10), 0, 7, 20, minimum_layout_size));
+    CHECK (is_placed_at (place (make_percent_layout (0, 0, 10, 10), 10, 10), 0, 0,
+                         minimum_layout_size, minimum_layout_size));
+    CHECK (is_placed_at (place (fixed, 2, 1), 0, 0, minimum_layout_size, minimum_layout_size));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: After a resize a layout window takes its new place and keeps its text, and a window made
+//       at a fixed position stays where it is while it still fits
+//--------------------------------------------------------------------------------------------------
+static void test_windows_follow_resize()
+{
+    MemoryBackend screen (40, 10);
+    UI ui (screen);
+
+    unsigned int right_half = ui.make_new_window (make_percent_layout (50, 0, 50, 100), "",
+                                                  false);
+    unsigned int fixed = ui.make_new_window (0, 0, 10, 5, "", false);
+
+    ui.write_to_window (right_half, "kept", false);
+    ui.write_to_window (fixed, "fixed", false);
+
+    CHECK (ui.get_window_width (right_half) == 18);
+
+    screen.resize_screen (60, 12);
+    ui.poll_input (0);
+
+    CHECK (ui.get_window_width (right_half) == 28);
+    CHECK (ui.get_window_height (right_half) == 10);
+    CHECK (ui.get_window_width (fixed) == 8);
+    CHECK (screen.get_screen_line (1).find ("|fixed   |") == 0);
+    CHECK (screen.get_screen_line (1).substr (30, 6) == "|kept ");
+}
+
+int main()
+{
+    run_test ("layouts_resolve_to_cells", test_layouts_resolve_to_cells);
+    run_test ("small_screens", test_small_screens);
+    run_test ("windows_follow_resize", test_windows_follow_resize);
+
+    return failed_check_count;
+}
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        MemoryBackendTests.cpp
+// Description: Tests for the headless MemoryBackend: surfaces reach the visible screen only on
+//              update(), cells keep their glyph and style, wide characters fill two cells, and keys
+//              and resizes are fed in as if they came from a terminal.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <memory>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+
+static const unsigned int screen_width = 20;
+static const unsigned int screen_height = 6;
+
+static const Style bold_style = { Color::red, Color::default_color, bold_attribute };
+
+//--------------------------------------------------------------------------------------------------
+// Test: A staged surface is only seen on the screen after update(), in the place it was made
+//--------------------------------------------------------------------------------------------------
+static void test_surface_shows_on_update()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    std::unique_ptr<Surface> surface = screen.make_surface (2, 1, 10, 3);
+
+    surface->put_text_at (0, 0, "hello", 5);
+    surface->stage_surface();
+
+    CHECK (screen.get_glyph (1, 2) == ' ');
+    CHECK (screen.get_update_count() == 0);
+
+    screen.update();
+
+    CHECK (screen.get_update_count() == 1);
+    CHECK (screen.get_glyph (1, 2) == 'h');
+    CHECK (screen.get_glyph (1, 6) == 'o');
+    CHECK (screen.get_screen_line (1) == "  hello             ");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Each cell keeps the style its text was written in
+//--------------------------------------------------------------------------------------------------
+static void test_cells_keep_their_style()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    std::unique_ptr<Surface> surface = screen.make_surface (0, 0, screen_width, screen_height);
+
+    surface->put_text ("a", 1);
+    surface->set_style (bold_style);
+    surface->put_text ("b", 1);
+    surface->set_style (plain_style);
+    surface->put_text ("c", 1);
+    surface->refresh_surface();
+
+    CHECK (screen.get_attributes (0, 0) == pack_style (plain_style));
+    CHECK (screen.get_attributes (0, 1) == pack_style (bold_style));
+    CHECK (screen.get_attributes (0, 2) == pack_style (plain_style));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A wide character takes two cells, and writing over either half of it blanks the other
+//--------------------------------------------------------------------------------------------------
+static void test_wide_character_takes_two_cells()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    std::unique_ptr<Surface> surface = screen.make_surface (0, 0, screen_width, screen_height);
+
+    surface->put_text ("\xE4\xB8\xAD\xE4\xB8\xAD", 6);
+    surface->refresh_surface();
+
+    CHECK (screen.get_glyph (0, 0) == 0x4E2D);
+    CHECK (screen.get_glyph (0, 1) == continuation_glyph);
+    CHECK (surface->get_cursor_column() == 4);
+
+    surface->put_text_at (0, 1, "x", 1);
+    surface->put_text_at (0, 2, "y", 1);
+    surface->refresh_surface();
+
+    CHECK (screen.get_screen_line (0).find (" xy ") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Pushed keys are read back in order, and resizing the screen blanks it and queues a resize
+//       key after them
+//--------------------------------------------------------------------------------------------------
+static void test_keys_and_resize()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    std::unique_ptr<Surface> surface = screen.make_surface (0, 0, screen_width, screen_height);
+
+    surface->put_text ("x", 1);
+    surface->refresh_surface();
+
+    screen.push_key ('a');
+    screen.push_key (key_left);
+    screen.resize_screen (30, 8);
+
+    CHECK (screen.get_screen_width() == 30);
+    CHECK (screen.get_screen_height() == 8);
+    CHECK (screen.get_glyph (0, 0) == ' ');
+
+    CHECK (screen.poll_key (0) == 'a');
+    CHECK (screen.read_key() == key_left);
+    CHECK (screen.read_key() == key_resize);
+    CHECK (screen.poll_key (0) == no_key);
+}
+
+int main()
+{
+    run_test ("surface_shows_on_update", test_surface_shows_on_update);
+    run_test ("cells_keep_their_style", test_cells_keep_their_style);
+    run_test ("wide_character_takes_two_cells", test_wide_character_takes_two_cells);
+    run_test ("keys_and_resize", test_keys_and_resize);
+
+    return failed_check_count;
+}
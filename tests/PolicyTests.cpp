@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        PolicyTests.cpp
+// Description: Tests for the compile-time window policies: each alignment policy places a line
+//              where it should, the UI builds the window the run-time choices name, and the
+//              refresh policies decide whether a write reaches the screen by itself.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "BasicWindow.hpp"
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 12;
+static const unsigned int screen_height = 4;
+
+//--------------------------------------------------------------------------------------------------
+// Test: The alignment policies place a short line at the start, the middle or the end of the
+//       line, and leave a line with no room to move where it is
+//--------------------------------------------------------------------------------------------------
+static void test_alignment_offsets()
+{
+    CHECK (LeftAlign::get_offset (3, 0, 10) == 0);
+    CHECK (CenterAlign::get_offset (3, 0, 10) == 3);
+    CHECK (RightAlign::get_offset (3, 0, 10) == 7);
+    CHECK (RightAlign::get_offset (3, 4, 10) == 3);
+
+    CHECK (CenterAlign::get_offset (10, 0, 10) == 0);
+    CHECK (RightAlign::get_offset (6, 4, 10) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Windows the UI makes for each alignment lay their text out with that alignment's policy
+//--------------------------------------------------------------------------------------------------
+static void test_ui_windows_use_their_policies()
+{
+    const TextAlignment alignments[] = { TextAlignment::left, TextAlignment::center,
+                                         TextAlignment::right };
+    const std::string expected_lines[] = { "|abc       |", "|   abc    |", "|       abc|" };
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        MemoryBackend screen (screen_width, screen_height);
+        UI ui (screen);
+
+        unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "",
+                                                  alignments[i], TextWrap::character);
+
+        ui.write_to_window (window, "abc", true);
+
+        CHECK_EQUAL (screen.get_screen_line (1), expected_lines[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A window with ImmediateRefresh shows each write at once, even when asked to defer, while
+//       one with DeferredRefresh waits to be staged and for the backend to be updated
+//--------------------------------------------------------------------------------------------------
+static void test_refresh_policies()
+{
+    MemoryBackend screen (screen_width * 2, screen_height);
+
+    BasicWindow<LeftAlign, CharacterWrap, ImmediateRefresh> immediate (0, 0, screen_width,
+                                                                       screen_height, "", 10,
+                                                                       screen);
+    BasicWindow<LeftAlign, CharacterWrap, DeferredRefresh> deferred (screen_width, 0,
+                                                                     screen_width, screen_height,
+                                                                     "", 10, screen);
+
+    immediate.set_deferred_refresh (true);
+    immediate.write ("now", false);
+
+    CHECK (screen.get_screen_line (1).find ("|now ") == 0);
+
+    deferred.write ("later", false);
+    screen.update();
+
+    CHECK (screen.get_screen_line (1).find ("|later") == std::string::npos);
+
+    CHECK (deferred.stage_refresh());
+    screen.update();
+
+    CHECK (screen.get_screen_line (1).find ("|later") == screen_width);
+    CHECK (! deferred.stage_refresh());
+}
+
+int main()
+{
+    run_test ("alignment_offsets", test_alignment_offsets);
+    run_test ("ui_windows_use_their_policies", test_ui_windows_use_their_policies);
+    run_test ("refresh_policies", test_refresh_policies);
+
+    return failed_check_count;
+}
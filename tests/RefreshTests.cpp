@@ -0,0 +1,170 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        RefreshTests.cpp
+// Description: Tests for refreshing: in batched refresh mode, writes to any number of windows
+//              reach the screen together in one update per frame.  tick() draws no more frames
+//              than the target frame rate allows, and only repaints the windows that changed.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 40;
+static const unsigned int screen_height = 12;
+static const unsigned int window_count = 3;
+static const unsigned int writes_per_window = 10;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Makes window_count windows side by side across the screen
+//--------------------------------------------------------------------------------------------------
+static void make_windows (UI& ui, unsigned int (&windows)[window_count])
+{
+    unsigned int width = screen_width / window_count;
+
+    for (unsigned int i = 0; i < window_count; i++)
+        windows[i] = ui.make_new_window (i * width, 0, width, screen_height, "", false);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Batched writes stay off the screen until flush(), which updates it once for every window
+//       and counts each write's refresh as one saved
+//--------------------------------------------------------------------------------------------------
+static void test_batched_writes_update_once()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    unsigned int windows[window_count];
+
+    make_windows (ui, windows);
+    ui.set_batched_refresh (true);
+
+    unsigned long int update_count = screen.get_update_count();
+
+    for (unsigned int i = 0; i < writes_per_window; i++)
+        for (unsigned int window : windows)
+            ui.write_to_window (window, "x", false);
+
+    CHECK (screen.get_update_count() == update_count);
+    CHECK (screen.get_glyph (1, 1) == ' ');
+
+    ui.flush();
+
+    FrameStats frame_stats = ui.get_last_frame_stats();
+
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK (screen.get_glyph (1, 1) == 'x');
+    CHECK (frame_stats.window_refreshes == window_count * writes_per_window);
+    CHECK (frame_stats.windows_repainted == window_count);
+    CHECK (frame_stats.physical_refreshes == 1);
+    CHECK (frame_stats.refreshes_saved == window_count * writes_per_window - 1);
+
+    // A frame with nothing in it sends nothing
+    ui.flush();
+
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK (ui.get_last_frame_stats().physical_refreshes == 0);
+    CHECK (ui.get_total_frame_stats().physical_refreshes == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Without batching every write reaches the screen by itself, and turning batching off sends
+//       whatever was still waiting
+//--------------------------------------------------------------------------------------------------
+static void test_unbatched_writes_update_each_time()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    unsigned int windows[window_count];
+
+    make_windows (ui, windows);
+
+    unsigned long int update_count = screen.get_update_count();
+
+    ui.write_to_window (windows[0], "a", false);
+
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK (screen.get_glyph (1, 1) == 'a');
+
+    ui.set_batched_refresh (true);
+    ui.write_to_window (windows[0], "b", false);
+
+    CHECK (screen.get_glyph (1, 2) == ' ');
+
+    ui.set_batched_refresh (false);
+
+    CHECK (screen.get_glyph (1, 2) == 'b');
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: With a frame rate cap, tick() holds writes back until a frame is due, then repaints only
+//       the window that was written to
+//--------------------------------------------------------------------------------------------------
+static void test_tick_waits_for_frame()
+{
+    const unsigned int fps = 4;
+
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    unsigned int windows[window_count];
+
+    make_windows (ui, windows);
+    ui.set_batched_refresh (true);
+    ui.set_target_fps (fps);
+    ui.flush();
+
+    unsigned long int update_count = screen.get_update_count();
+
+    for (unsigned int i = 0; i < writes_per_window; i++)
+    {
+        ui.write_to_window (windows[1], "x", false);
+        ui.tick();
+    }
+
+    CHECK (screen.get_update_count() == update_count);
+
+    std::this_thread::sleep_for (std::chrono::milliseconds (1000 / fps + 50));
+    ui.tick();
+
+    FrameStats frame_stats = ui.get_last_frame_stats();
+
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK (frame_stats.window_refreshes == writes_per_window);
+    CHECK (frame_stats.windows_repainted == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A latest value window shows only the newest of the writes made since the last frame
+//--------------------------------------------------------------------------------------------------
+static void test_latest_value_window_coalesces()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    unsigned int windows[window_count];
+
+    make_windows (ui, windows);
+    ui.set_window_latest_value_only (windows[0], true);
+    ui.set_batched_refresh (true);
+
+    ui.write_to_window (windows[0], "first", false);
+    ui.write_to_window (windows[0], "second", false);
+    ui.write_to_window (windows[0], "last", false);
+    ui.flush();
+
+    CHECK (screen.get_screen_line (1).find ("|last ") == 0);
+    CHECK (ui.get_window_history_line_count (windows[0]) == 1);
+}
+
+int main()
+{
+    run_test ("batched_writes_update_once", test_batched_writes_update_once);
+    run_test ("unbatched_writes_update_each_time", test_unbatched_writes_update_each_time);
+    run_test ("tick_waits_for_frame", test_tick_waits_for_frame);
+    run_test ("latest_value_window_coalesces", test_latest_value_window_coalesces);
+
+    return failed_check_count;
+}
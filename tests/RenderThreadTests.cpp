@@ -0,0 +1,191 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        RenderThreadTests.cpp
+// Description: Tests for concurrent mode: writes posted to a window reach it in the order they
+//              were posted, however the backpressure policy had to handle them, and once the queue
+//              is warm neither posting nor drawing them allocates.
+// Notes:       The tests run the real render thread against a MemoryBackend, so they can only make
+//              a race likely, not certain; each one is repeated to give it many chances to show.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 20;
+static const unsigned int screen_height = 60;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the numbers in the window's history, one per line, only ever go up, and
+//          sets last_number to the newest of them.  The window must fill the screen; its history is
+//          read a screen at a time by scrolling through it.
+//--------------------------------------------------------------------------------------------------
+static bool is_history_increasing (UI& ui, MemoryBackend& screen, const unsigned int& window,
+                                   long int& last_number)
+{
+    const unsigned int text_height = screen_height - 2;
+
+    unsigned int line_count = ui.get_window_history_line_count (window);
+    bool is_increasing = true;
+
+    last_number = -1;
+
+    for (unsigned int top = 0; top < line_count; top += text_height)
+    {
+        ui.scroll_window_to_line (window, top);
+
+        // The last screen can't scroll past the newest line, so it starts above top
+        unsigned int shown_top = line_count > text_height && top > line_count - text_height
+                                 ? line_count - text_height : top;
+
+        for (unsigned int line_number = top; line_number < top + text_height
+             && line_number < line_count; line_number++)
+        {
+            std::string line = screen.get_screen_line (line_number - shown_top + 1);
+            std::size_t start = line.find_first_of ("0123456789");
+
+            if (start == std::string::npos)
+                continue;
+
+            long int number = std::strtol (line.c_str() + start, NULL, 10);
+
+            if (number <= last_number)
+                is_increasing = false;
+
+            last_number = number;
+        }
+    }
+
+    return is_increasing;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Posts the numbers 0 to count - 1 to the window, one per line, pausing after every few
+//          so the render thread drains the queue while the producer is still posting
+//--------------------------------------------------------------------------------------------------
+static void post_numbers (UI& ui, const unsigned int& window, const long int& count)
+{
+    for (long int i = 0; i < count; i++)
+    {
+        ui.post_to_window (window, std::to_string (i), true);
+
+        if (i % 8 == 7)
+            std::this_thread::sleep_for (std::chrono::microseconds (20));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: With the coalesce policy and a tiny queue, a window's posts overflow into its coalesce
+//       slot and then go back into the queue, over and over.  The window must still show them in
+//       the order they were posted, ending with the newest.
+//--------------------------------------------------------------------------------------------------
+static void test_coalesced_posts_stay_in_order()
+{
+    const unsigned int rounds = 5;
+    const long int posts = 5000;
+
+    for (unsigned int round = 0; round < rounds; round++)
+    {
+        MemoryBackend screen (screen_width, screen_height);
+        UI ui (screen);
+
+        unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false,
+                                                  posts);
+
+        ui.start_render_thread (4, BackpressurePolicy::coalesce);
+        post_numbers (ui, window, posts);
+        ui.stop_render_thread();
+
+        long int last_number = -1;
+
+        CHECK (is_history_increasing (ui, screen, window, last_number));
+        CHECK (last_number == posts - 1);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: With the block policy nothing is dropped, so the window shows every post, in order
+//--------------------------------------------------------------------------------------------------
+static void test_blocked_posts_all_arrive()
+{
+    const long int posts = 5000;
+
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false,
+                                              posts + 1);
+
+    ui.start_render_thread (4, BackpressurePolicy::block);
+    post_numbers (ui, window, posts);
+    ui.stop_render_thread();
+
+    long int last_number = -1;
+
+    CHECK (is_history_increasing (ui, screen, window, last_number));
+    CHECK (last_number == posts - 1);
+    CHECK (ui.get_dropped_write_count() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how many heap allocations posting a line of text longer than a short string
+//          makes, over many posts through a tiny queue, once as many posts have warmed it up.  The
+//          count covers the render thread drawing the posts as well.
+// Notes:   The render thread is stopped and started again between the two rounds.  Stopping it
+//          draws every warm-up post, so none of them can still be on its way to the window, and
+//          be laid out for the first time, once allocations are being counted.
+//--------------------------------------------------------------------------------------------------
+static unsigned long int count_post_allocations (const BackpressurePolicy& policy)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+    const unsigned int posts = 5000;
+
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false, 100);
+
+    ui.start_render_thread (4, policy);
+
+    for (unsigned int i = 0; i < posts; i++)
+        ui.post_to_window (window, text, true);
+
+    ui.stop_render_thread();
+    ui.start_render_thread (4, policy);
+
+    unsigned long int allocations_before = get_allocation_count();
+
+    for (unsigned int i = 0; i < posts; i++)
+        ui.post_to_window (window, text, true);
+
+    unsigned long int allocations = get_allocation_count() - allocations_before;
+
+    ui.stop_render_thread();
+
+    return allocations;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Warm posts make no heap allocations, whichever way a full queue is handled
+//--------------------------------------------------------------------------------------------------
+static void test_posts_do_not_allocate()
+{
+    CHECK (count_post_allocations (BackpressurePolicy::block) == 0);
+    CHECK (count_post_allocations (BackpressurePolicy::drop_oldest) == 0);
+    CHECK (count_post_allocations (BackpressurePolicy::coalesce) == 0);
+}
+
+int main()
+{
+    run_test ("coalesced_posts_stay_in_order", test_coalesced_posts_stay_in_order);
+    run_test ("blocked_posts_all_arrive", test_blocked_posts_all_arrive);
+    run_test ("posts_do_not_allocate", test_posts_do_not_allocate);
+
+    return failed_check_count;
+}
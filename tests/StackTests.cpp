@@ -0,0 +1,134 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StackTests.cpp
+// Description: Tests for overlapping windows: a popup covers the windows beneath it whatever is
+//              written to them, hiding or lowering it shows them again without repainting any
+//              window, and a pad window shows the part of its pad its view is moved to.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 30;
+static const unsigned int screen_height = 10;
+
+// Where the popup goes, over the middle of the base window
+static const unsigned int popup_x = 10;
+static const unsigned int popup_y = 2;
+static const unsigned int popup_width = 12;
+static const unsigned int popup_height = 5;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the columns of the screen line the popup covers
+//--------------------------------------------------------------------------------------------------
+static std::string get_popup_columns (MemoryBackend& screen, const unsigned int& row)
+{
+    return screen.get_screen_line (row).substr (popup_x, popup_width);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A popup covers the window beneath it, even where that window is written to afterwards,
+//       and hiding it shows the window's text again without repainting either window
+//--------------------------------------------------------------------------------------------------
+static void test_hidden_popup_uncovers_window()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int base = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+    unsigned int popup = ui.make_new_window (popup_x, popup_y, popup_width, popup_height, "",
+                                             false);
+
+    ui.set_batched_refresh (true);
+    ui.write_to_window (popup, "popup", false);
+
+    for (unsigned int i = 0; i < screen_height - 2; i++)
+        ui.write_to_window (base, "base line " + std::to_string (i), i + 3 < screen_height);
+
+    ui.flush();
+
+    CHECK_EQUAL (get_popup_columns (screen, popup_y + 1), "|popup     |");
+    CHECK_EQUAL (screen.get_screen_line (popup_y + 1).substr (0, popup_x), "|base line");
+
+    unsigned long int update_count = screen.get_update_count();
+
+    ui.set_window_visible (popup, false);
+    ui.flush();
+
+    CHECK (ui.get_last_frame_stats().windows_repainted == 0);
+    CHECK (screen.get_update_count() == update_count + 1);
+    CHECK_EQUAL (screen.get_screen_line (popup_y + 1), "|base line 2                 |");
+    CHECK (! ui.get_window_visible (popup));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Lowering the popup puts it beneath the window it was over, and raising it puts it back
+//--------------------------------------------------------------------------------------------------
+static void test_raise_and_lower_popup()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int base = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+    unsigned int popup = ui.make_new_window (popup_x, popup_y, popup_width, popup_height, "",
+                                             false);
+
+    ui.write_to_window (popup, "popup", false);
+
+    CHECK_EQUAL (get_popup_columns (screen, popup_y + 1), "|popup     |");
+
+    ui.lower_window (popup);
+    ui.flush();
+
+    CHECK_EQUAL (get_popup_columns (screen, popup_y + 1), "            ");
+
+    ui.raise_window (popup);
+    ui.flush();
+
+    CHECK_EQUAL (get_popup_columns (screen, popup_y + 1), "|popup     |");
+
+    ui.destroy_window (popup);
+    ui.flush();
+
+    CHECK_EQUAL (get_popup_columns (screen, popup_y + 1), "            ");
+    CHECK (ui.get_window_visible (base));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A pad window lays its text out at the width of the pad and shows the part of it the view
+//       is moved to
+//--------------------------------------------------------------------------------------------------
+static void test_pad_view_moves()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_pad_window (0, 0, 12, 4, 40, 10, "", TextAlignment::left,
+                                                  TextWrap::character);
+
+    ui.write_to_window (window, "0123456789abcdefghij", true);
+    ui.write_to_window (window, "second line", true);
+
+    CHECK_EQUAL (screen.get_screen_line (1).substr (0, 12), "|0123456789|");
+
+    ui.set_pad_view_origin (window, 0, 10);
+
+    CHECK_EQUAL (screen.get_screen_line (1).substr (0, 12), "|abcdefghij|");
+    CHECK (ui.get_pad_view_column (window) == 10);
+
+    ui.set_pad_view_origin (window, 1, 0);
+
+    CHECK_EQUAL (screen.get_screen_line (1).substr (0, 12), "|second lin|");
+}
+
+int main()
+{
+    run_test ("hidden_popup_uncovers_window", test_hidden_popup_uncovers_window);
+    run_test ("raise_and_lower_popup", test_raise_and_lower_popup);
+    run_test ("pad_view_moves", test_pad_view_moves);
+
+    return failed_check_count;
+}
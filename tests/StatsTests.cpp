@@ -0,0 +1,112 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StatsTests.cpp
+// Description: Tests for the UI's statistics: each window counts its own writes and bytes, the
+//              totals add up every window including destroyed ones, and a histogram's percentiles
+//              are never more than a quarter above the times recorded in it.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "Stats.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 40;
+static const unsigned int screen_height = 12;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the statistics of the window, or ones with no window number if it has none
+//--------------------------------------------------------------------------------------------------
+static WindowStats find_window_stats (const UIStats& stats, const unsigned int& window)
+{
+    for (const WindowStats& window_stats : stats.windows)
+        if (window_stats.window_number == window)
+            return window_stats;
+
+    WindowStats missing_stats = WindowStats();
+    missing_stats.window_number = invalid_window;
+
+    return missing_stats;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Writes and bytes are counted per window and in total, and a destroyed window's counts stay
+//       in the totals after its own entry is gone
+//--------------------------------------------------------------------------------------------------
+static void test_writes_are_counted()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int first_window = ui.make_new_window (0, 0, 20, 6, "", false);
+    unsigned int second_window = ui.make_new_window (20, 0, 20, 6, "", false);
+
+    for (unsigned int i = 0; i < 3; i++)
+        ui.write_to_window (first_window, "abc", true);
+
+    ui.write_to_window (second_window, "hello", false);
+
+    UIStats stats = ui.get_stats();
+    WindowStats first_stats = find_window_stats (stats, first_window);
+    WindowStats second_stats = find_window_stats (stats, second_window);
+
+    CHECK (stats.windows.size() == 2);
+    CHECK (first_stats.writes == 3);
+    CHECK (first_stats.bytes_written == 9);
+    CHECK (first_stats.refresh_time.count > 0);
+    CHECK (second_stats.writes == 1);
+    CHECK (second_stats.bytes_written == 5);
+    CHECK (stats.writes == 4);
+    CHECK (stats.bytes_written == 14);
+
+    ui.destroy_window (first_window);
+    ui.write_to_window (second_window, "!", false);
+
+    stats = ui.get_stats();
+
+    CHECK (stats.windows.size() == 1);
+    CHECK (find_window_stats (stats, first_window).window_number == invalid_window);
+    CHECK (stats.writes == 5);
+    CHECK (stats.bytes_written == 15);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A histogram's count, total and longest time are exact, and its percentiles are at or a
+//       quarter above the recorded time they fall on
+//--------------------------------------------------------------------------------------------------
+static void test_histogram_percentiles()
+{
+    LatencyHistogram histogram;
+
+    for (unsigned long int nanoseconds = 1000; nanoseconds <= 100000; nanoseconds += 1000)
+        histogram.record (nanoseconds);
+
+    HistogramSnapshot snapshot = histogram.get_snapshot();
+    unsigned long int median = snapshot.get_percentile (0.5);
+    unsigned long int tail = snapshot.get_percentile (0.99);
+
+    CHECK (snapshot.count == 100);
+    CHECK (snapshot.total_nanoseconds == 5050000);
+    CHECK (snapshot.max_nanoseconds == 100000);
+    CHECK (snapshot.get_mean() == 50500);
+    CHECK (median >= 50000 && median <= 62500);
+    CHECK (tail >= 99000 && tail <= 125000);
+
+    HistogramSnapshot merged;
+
+    merged.merge (snapshot);
+    merged.merge (snapshot);
+
+    CHECK (merged.count == 200);
+    CHECK (merged.max_nanoseconds == 100000);
+    CHECK (merged.get_percentile (0.5) == median);
+}
+
+int main()
+{
+    run_test ("writes_are_counted", test_writes_are_counted);
+    run_test ("histogram_percentiles", test_histogram_percentiles);
+
+    return failed_check_count;
+}
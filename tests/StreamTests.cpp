@@ -0,0 +1,155 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StreamTests.cpp
+// Description: Tests for streams: a followed file keeps being shown after it is truncated in
+//              place or rotated, and a UTF-8 character cut in two by a read is held back until the
+//              rest of it arrives.
+// Notes:       A file read to its end is only checked again after stream_check_interval
+//              milliseconds, so the tests wait that long before each read of a changed file.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 20;
+static const unsigned int screen_height = 8;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes text to the file at path, replacing it or adding to its end depending on mode
+//--------------------------------------------------------------------------------------------------
+static void write_file (const std::string& path, const std::string& text, const char* mode)
+{
+    FILE* file = std::fopen (path.c_str(), mode);
+
+    if (file == NULL)
+        return;
+
+    std::fwrite (text.data(), 1, text.size(), file);
+    std::fclose (file);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Reads the streams once the followed files are due to be checked again
+//--------------------------------------------------------------------------------------------------
+static void read_streams_when_due (UI& ui)
+{
+    std::this_thread::sleep_for (std::chrono::milliseconds (stream_check_interval_milliseconds
+                                                            + 10));
+    ui.read_streams();
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the text area of the screen line starts with text
+//--------------------------------------------------------------------------------------------------
+static bool is_line_showing (MemoryBackend& screen, const unsigned int& row,
+                             const std::string& text)
+{
+    return screen.get_screen_line (row).compare (0, text.size() + 1, "|" + text) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A followed file's new lines are shown as they are added, and it is read again from its
+//       start once it is truncated, and from the new file once it is rotated
+//--------------------------------------------------------------------------------------------------
+static void test_followed_file_is_truncated_and_rotated()
+{
+    char directory[] = "/tmp/StreamTestsXXXXXX";
+
+    CHECK (mkdtemp (directory) != NULL);
+
+    std::string path = std::string (directory) + "/log";
+    std::string rotated_path = path + ".1";
+
+    write_file (path, "first\n", "w");
+
+    {
+        MemoryBackend screen (screen_width, screen_height);
+        UI ui (screen);
+
+        unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+        CHECK (ui.attach_stream (window, path));
+
+        ui.read_streams();
+
+        CHECK (is_line_showing (screen, 1, "first "));
+
+        write_file (path, "second\n", "a");
+        read_streams_when_due (ui);
+
+        CHECK (is_line_showing (screen, 2, "second "));
+
+        write_file (path, "third\n", "w");
+        read_streams_when_due (ui);
+
+        CHECK (is_line_showing (screen, 3, "third "));
+
+        std::rename (path.c_str(), rotated_path.c_str());
+        write_file (path, "fourth\n", "w");
+        read_streams_when_due (ui);
+
+        CHECK (is_line_showing (screen, 4, "fourth "));
+    }
+
+    std::remove (path.c_str());
+    std::remove (rotated_path.c_str());
+    rmdir (directory);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A character cut off at the end of a read is held back and shown whole once the rest of it
+//       is read, and one left cut off when the pipe closes is still shown
+//--------------------------------------------------------------------------------------------------
+static void test_cut_character_waits_for_the_rest()
+{
+    const std::string wide_character = "中";
+    int descriptors[2];
+
+    CHECK (pipe (descriptors) == 0);
+
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    CHECK (ui.attach_stream (window, descriptors[0]));
+
+    std::string first_part = "a" + wide_character.substr (0, 1);
+    std::string second_part = wide_character.substr (1) + "b\n" + wide_character.substr (0, 2);
+
+    CHECK (write (descriptors[1], first_part.data(), first_part.size()) > 0);
+    ui.read_streams();
+
+    CHECK (is_line_showing (screen, 1, "a "));
+
+    CHECK (write (descriptors[1], second_part.data(), second_part.size()) > 0);
+    ui.read_streams();
+
+    CHECK (is_line_showing (screen, 1, "a" + wide_character + "b "));
+    CHECK (is_line_showing (screen, 2, " "));
+
+    close (descriptors[1]);
+    ui.read_streams();
+
+    CHECK (is_line_showing (screen, 2, "\xEF\xBF\xBD"));
+
+    ui.detach_stream (window);
+    close (descriptors[0]);
+}
+
+int main()
+{
+    run_test ("followed_file_is_truncated_and_rotated",
+              test_followed_file_is_truncated_and_rotated);
+    run_test ("cut_character_waits_for_the_rest", test_cut_character_waits_for_the_rest);
+
+    return failed_check_count;
+}
@@ -0,0 +1,120 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        StyleTests.cpp
+// Description: Tests for styles: every style packs into an unsigned int and unpacks unchanged, the
+//              spans of a write reach the cells they cover, and the color pair cache sets each
+//              foreground and background up once and keeps drawing in the same pair, or in pair 0
+//              once the terminal has none left.
+// Notes:       nCurses runs headless, started with newterm() on a temporary file as an xterm,
+//              which has 64 color pairs: too few for every combination of the nine colors.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <set>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "NcursesBackend.hpp"
+#include "UI.hpp"
+
+// Every combination of the attribute bits
+static const unsigned int attribute_combinations = 16;
+
+//--------------------------------------------------------------------------------------------------
+// Test: Each style packs to its own value and unpacks to the style it was packed from
+//--------------------------------------------------------------------------------------------------
+static void test_styles_pack_and_unpack()
+{
+    std::set<unsigned int> packed_styles;
+    bool is_unchanged = true;
+
+    for (unsigned int foreground = 0; foreground < color_count; foreground++)
+        for (unsigned int background = 0; background < color_count; background++)
+            for (unsigned int attributes = 0; attributes < attribute_combinations; attributes++)
+            {
+                Style style = { (Color) foreground, (Color) background, attributes };
+                unsigned int packed_style = pack_style (style);
+
+                packed_styles.insert (packed_style);
+
+                if (unpack_style (packed_style) != style)
+                    is_unchanged = false;
+            }
+
+    CHECK (is_unchanged);
+    CHECK (packed_styles.size() == color_count * color_count * attribute_combinations);
+    CHECK (pack_style (plain_style) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: The cells a span covers are drawn in its style and the rest of the write stays plain
+//--------------------------------------------------------------------------------------------------
+static void test_spans_reach_their_cells()
+{
+    MemoryBackend screen (12, 4);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, 12, 4, "", false);
+    const Style warning_style = { Color::yellow, Color::blue,
+                                  bold_attribute | underline_attribute };
+    const StyleSpan spans[] = { { 2, 3, warning_style }, { 5, 1, highlighted_style } };
+
+    ui.write_spans (window, "ab!!!?cd", spans, 2, true);
+
+    CHECK_EQUAL (screen.get_screen_line (1), "|ab!!!?cd  |");
+    CHECK (unpack_style (screen.get_attributes (1, 2)) == plain_style);
+    CHECK (unpack_style (screen.get_attributes (1, 3)) == warning_style);
+    CHECK (unpack_style (screen.get_attributes (1, 5)) == warning_style);
+    CHECK (unpack_style (screen.get_attributes (1, 6)) == highlighted_style);
+    CHECK (unpack_style (screen.get_attributes (1, 7)) == plain_style);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Asking for every combination twice sets up as many pairs as the terminal has, hands out
+//       the same pair the second time, and draws the combinations left over in pair 0
+//--------------------------------------------------------------------------------------------------
+static void test_color_pairs_are_kept()
+{
+    FILE* output_file = std::tmpfile();
+    FILE* input_file = std::fopen ("/dev/null", "r");
+
+    {
+        NcursesBackend terminal (output_file, input_file, "xterm");
+        ColorPairCache& color_pairs = terminal.get_color_pairs();
+        short first_pairs[color_count][color_count];
+
+        for (unsigned int foreground = 0; foreground < color_count; foreground++)
+            for (unsigned int background = 0; background < color_count; background++)
+                first_pairs[foreground][background] = color_pairs.get_pair (
+                    (Color) foreground, (Color) background);
+
+        unsigned long int pair_count = terminal.get_color_pair_count();
+
+        CHECK (pair_count == (unsigned long int) COLOR_PAIRS - 1);
+        CHECK (first_pairs[0][0] == 0);
+        CHECK (first_pairs[color_count - 1][color_count - 1] == 0);
+
+        bool is_same_pair = true;
+
+        for (unsigned int foreground = 0; foreground < color_count; foreground++)
+            for (unsigned int background = 0; background < color_count; background++)
+                if (color_pairs.get_pair ((Color) foreground, (Color) background) !=
+                    first_pairs[foreground][background])
+                    is_same_pair = false;
+
+        CHECK (is_same_pair);
+        CHECK (terminal.get_color_pair_count() == pair_count);
+    }
+
+    std::fclose (input_file);
+    std::fclose (output_file);
+}
+
+int main()
+{
+    run_test ("styles_pack_and_unpack", test_styles_pack_and_unpack);
+    run_test ("spans_reach_their_cells", test_spans_reach_their_cells);
+    run_test ("color_pairs_are_kept", test_color_pairs_are_kept);
+
+    return failed_check_count;
+}
@@ -0,0 +1,126 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        TableTests.cpp
+// Description: Tests for virtualized tables: however many rows a table has, only the rows on
+//              screen are fetched from its cell source and drawn, wherever it is scrolled to.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <set>
+#include <string>
+#include <vector>
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 22;
+static const unsigned int screen_height = 6;
+
+// The window's text area is four rows high, far fewer than the table has
+static const unsigned int visible_rows = screen_height - 2;
+static const unsigned long int row_count = 1000000000;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns the text of one line of the table, as it is on the screen
+//--------------------------------------------------------------------------------------------------
+static std::string get_table_line (MemoryBackend& screen, const unsigned int& line)
+{
+    return screen.get_screen_line (line + 1).substr (1, screen_width - 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Makes a two column table over the whole screen whose cell source notes each row it is
+//          asked for in fetched_rows
+//--------------------------------------------------------------------------------------------------
+static unsigned int make_table (UI& ui, std::set<unsigned long int>& fetched_rows)
+{
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    ui.attach_table (window, { 10, 8 }, row_count,
+                     [&fetched_rows] (const unsigned long int& row, const unsigned int& column)
+                     {
+                         fetched_rows.insert (row);
+
+                         return (column == 0 ? "row " : "c") + std::to_string (row);
+                     });
+
+    return window;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Attaching a table fetches and draws only its first screen of rows, with the first selected
+//--------------------------------------------------------------------------------------------------
+static void test_only_visible_rows_are_fetched()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    std::set<unsigned long int> fetched_rows;
+
+    unsigned int window = make_table (ui, fetched_rows);
+
+    CHECK (fetched_rows == std::set<unsigned long int> ({ 0, 1, 2, 3 }));
+    CHECK_EQUAL (get_table_line (screen, 0), "row 0      c0       ");
+    CHECK_EQUAL (get_table_line (screen, 3), "row 3      c3       ");
+    CHECK (screen.get_attributes (1, 1) == pack_style (highlighted_style));
+    CHECK (screen.get_attributes (2, 1) == pack_style (plain_style));
+    CHECK (ui.get_table_selected_row (window) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Jumping deep into the table, or past its end, fetches only the rows that end up on screen
+//--------------------------------------------------------------------------------------------------
+static void test_jump_fetches_only_its_rows()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    std::set<unsigned long int> fetched_rows;
+
+    unsigned int window = make_table (ui, fetched_rows);
+
+    fetched_rows.clear();
+    ui.jump_table_to_row (window, 500000000);
+
+    CHECK (fetched_rows == std::set<unsigned long int> ({ 500000000, 500000001, 500000002,
+                                                          500000003 }));
+    CHECK_EQUAL (get_table_line (screen, 0), "row 500000 c5000000 ");
+
+    fetched_rows.clear();
+    ui.jump_table_to_row (window, row_count + 5);
+
+    CHECK (fetched_rows.size() == visible_rows);
+    CHECK (*fetched_rows.begin() == row_count - visible_rows);
+    CHECK (ui.get_table_selected_row (window) == row_count - 1);
+    CHECK (screen.get_attributes (visible_rows, 1) == pack_style (highlighted_style));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Moving the selection past the last row on screen scrolls the table by just enough
+//--------------------------------------------------------------------------------------------------
+static void test_selection_scrolls_into_view()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+    std::set<unsigned long int> fetched_rows;
+
+    unsigned int window = make_table (ui, fetched_rows);
+
+    ui.move_table_selection (window, 5);
+
+    CHECK (ui.get_table_selected_row (window) == 5);
+    CHECK_EQUAL (get_table_line (screen, 0), "row 2      c2       ");
+    CHECK (screen.get_attributes (visible_rows, 1) == pack_style (highlighted_style));
+
+    ui.move_table_selection (window, -100);
+
+    CHECK (ui.get_table_selected_row (window) == 0);
+    CHECK_EQUAL (get_table_line (screen, 0), "row 0      c0       ");
+}
+
+int main()
+{
+    run_test ("only_visible_rows_are_fetched", test_only_visible_rows_are_fetched);
+    run_test ("jump_fetches_only_its_rows", test_jump_fetches_only_its_rows);
+    run_test ("selection_scrolls_into_view", test_selection_scrolls_into_view);
+
+    return failed_check_count;
+}
@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        WindowHandleTests.cpp
+// Description: Tests for window handles: a handle to a destroyed window is rejected however many
+//              times its slot has been reused since.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 40;
+static const unsigned int screen_height = 12;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether the UI accepts the handle.  A rejected handle also writes an error to
+//          every window, which does no harm here.
+//--------------------------------------------------------------------------------------------------
+static bool is_handle_accepted (UI& ui, const unsigned int& window)
+{
+    return ui.get_window_width (window) != (unsigned int) -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A destroyed window's handle stays invalid while its slot is reused
+//--------------------------------------------------------------------------------------------------
+static void test_reused_slot_rejects_old_handle()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int first_window = ui.make_new_window (0, 0, 10, 5, "", false);
+
+    ui.destroy_window (first_window);
+
+    unsigned int second_window = ui.make_new_window (0, 0, 10, 5, "", false);
+
+    CHECK (second_window != first_window);
+    CHECK (is_handle_accepted (ui, second_window));
+    CHECK (! is_handle_accepted (ui, first_window));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Once a slot has used up every generation it is retired, so the handles it gave out first
+//       never become valid again and new windows go in a fresh slot
+//--------------------------------------------------------------------------------------------------
+static void test_worn_out_slot_is_retired()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int first_window = ui.make_new_window (0, 0, 10, 5, "", false);
+    unsigned int window = first_window;
+    bool is_slot_reused = true;
+
+    for (unsigned int i = 0; i < window_generation_mask; i++)
+    {
+        ui.destroy_window (window);
+        window = ui.make_new_window (0, 0, 10, 5, "", false);
+
+        if ((window & window_slot_mask) != (first_window & window_slot_mask))
+            is_slot_reused = false;
+    }
+
+    CHECK (is_slot_reused);
+    CHECK (window == (window_generation_mask << window_generation_shift | first_window));
+
+    ui.destroy_window (window);
+
+    unsigned int fresh_window = ui.make_new_window (0, 0, 10, 5, "", false);
+
+    CHECK (fresh_window != invalid_window);
+    CHECK ((fresh_window & window_slot_mask) != (first_window & window_slot_mask));
+    CHECK (! is_handle_accepted (ui, first_window));
+    CHECK (! is_handle_accepted (ui, window));
+}
+
+int main()
+{
+    run_test ("reused_slot_rejects_old_handle", test_reused_slot_rejects_old_handle);
+    run_test ("worn_out_slot_is_retired", test_worn_out_slot_is_retired);
+
+    return failed_check_count;
+}
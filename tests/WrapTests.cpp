@@ -0,0 +1,184 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        WrapTests.cpp
+// Description: Tests for the wrap policies: laying text out always moves through it, even when a
+//              character is too wide for any line of the window.  Tabs and other control
+//              characters are laid out in the columns nCurses draws them in.  Wrapped lines are
+//              aligned one by one, cut off lines end in an ellipsis, and laying out the same text
+//              again at the same width comes from the line break cache.
+// Notes:       A wrap policy that stops moving through the text hangs the write, so these tests
+//              fail by timing out under ctest.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <string>
+#include "BasicWindow.hpp"
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "TextPolicy.hpp"
+#include "UI.hpp"
+
+// Two columns each
+static const std::string wide_text = "中文";
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns whether laying the text out with WrapPolicy from column of a line width columns
+//          wide takes at least one byte of it
+//--------------------------------------------------------------------------------------------------
+template <typename WrapPolicy>
+static bool is_piece_moving_on (const std::string& text, const unsigned int& column,
+                                const unsigned int& width)
+{
+    LinePiece piece;
+
+    WrapPolicy::get_piece (text.c_str(), text.size(), column, width, piece);
+
+    return piece.length + piece.skip > 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Each wrap policy moves on from a wide character at the start of a one column line
+//--------------------------------------------------------------------------------------------------
+static void test_wide_character_in_one_column()
+{
+    CHECK (is_piece_moving_on<CharacterWrap> (wide_text, 0, 1));
+    CHECK (is_piece_moving_on<WordWrap> (wide_text, 0, 1));
+    CHECK (is_piece_moving_on<Truncate> (wide_text, 0, 1));
+
+    CHECK (is_piece_moving_on<WordWrap> ("a" + wide_text, 0, 1));
+    CHECK (is_piece_moving_on<WordWrap> (wide_text + " " + wide_text, 0, 1));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A word wrapped window with a text area one column wide takes wide text, whatever its
+//       alignment, and shows the narrow characters around it
+//--------------------------------------------------------------------------------------------------
+static void test_wide_text_in_one_column_window()
+{
+    const TextAlignment alignments[] = { TextAlignment::left, TextAlignment::center,
+                                         TextAlignment::right };
+
+    for (const TextAlignment& alignment : alignments)
+    {
+        MemoryBackend screen (3, 6);
+        UI ui (screen);
+
+        unsigned int window = ui.make_new_window (0, 0, 3, 6, "", alignment, TextWrap::word);
+
+        ui.write_to_window (window, wide_text + "a " + wide_text + "b", true);
+
+        CHECK_EQUAL (screen.get_screen_line (1), "|a|");
+        CHECK_EQUAL (screen.get_screen_line (2), "|b|");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Control characters are found wherever they fall in the eight byte words the text is
+//       checked in, and neither '\n' nor UTF-8 counts as one
+//--------------------------------------------------------------------------------------------------
+static void test_control_characters_are_found()
+{
+    CHECK (! has_control_characters ("plain text\nand more text", 24));
+    CHECK (! has_control_characters (wide_text.c_str(), wide_text.size()));
+    CHECK (has_control_characters ("twelve bytes\t", 13));
+    CHECK (has_control_characters ("1234567\x7F", 8));
+    CHECK (has_control_characters ("\x1F", 1));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A tab moves the text after it to the next tab stop, from wherever on the line it falls,
+//       and other control characters are shown as a caret and a letter
+//--------------------------------------------------------------------------------------------------
+static void test_line_with_tab()
+{
+    MemoryBackend screen (22, 6);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, 22, 6, "", TextAlignment::left,
+                                              TextWrap::character);
+
+    ui.write_to_window (window, "a\tb", true);
+    ui.write_to_window (window, "12345678\tx", true);
+    ui.write_to_window (window, "ab", false);
+    ui.write_to_window (window, "\tc\rd", true);
+
+    CHECK_EQUAL (screen.get_screen_line (1), "|a       b           |");
+    CHECK_EQUAL (screen.get_screen_line (2), "|12345678        x   |");
+    CHECK_EQUAL (screen.get_screen_line (3), "|ab      c^Md        |");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Word wrapped text breaks between words and each wrapped line is centered on its own
+//--------------------------------------------------------------------------------------------------
+static void test_word_wrap_centers_each_line()
+{
+    MemoryBackend screen (12, 6);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, 12, 6, "", TextAlignment::center,
+                                              TextWrap::word);
+
+    ui.write_to_window (window, "one two three four", true);
+
+    CHECK_EQUAL (screen.get_screen_line (1), "| one two  |");
+    CHECK_EQUAL (screen.get_screen_line (2), "|three four|");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Truncated text that doesn't fit ends in an ellipsis, counted in columns not bytes, and text
+//       that fits is aligned untouched
+//--------------------------------------------------------------------------------------------------
+static void test_truncate_with_ellipsis()
+{
+    MemoryBackend screen (12, 6);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, 12, 6, "", TextAlignment::right,
+                                              TextWrap::truncate);
+
+    ui.write_to_window (window, "abcdefghijklmnop", true);
+    ui.write_to_window (window, wide_text + wide_text + wide_text, true);
+    ui.write_to_window (window, "short", true);
+
+    CHECK_EQUAL (screen.get_screen_line (1), "|abcdefg...|");
+    CHECK_EQUAL (screen.get_screen_line (2), "| " + wide_text + "中...|");
+    CHECK_EQUAL (screen.get_screen_line (3), "|     short|");
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Resizing a window back to a width it had before lays its lines out from the line break
+//       cache and draws the same text
+//--------------------------------------------------------------------------------------------------
+static void test_resize_uses_line_break_cache()
+{
+    MemoryBackend screen (16, 6);
+
+    BasicWindow<CenterAlign, WordWrap, ImmediateRefresh> window (0, 0, 12, 6, "", 10, screen);
+
+    window.write ("one two three four", true);
+    window.set_geometry (0, 0, 16, 6);
+
+    unsigned long int hit_count = window.get_line_break_cache_hits();
+    unsigned long int miss_count = window.get_line_break_cache_misses();
+
+    window.set_geometry (0, 0, 12, 6);
+    screen.update();
+
+    CHECK (window.get_line_break_cache_hits() > hit_count);
+    CHECK (window.get_line_break_cache_misses() == miss_count);
+    CHECK_EQUAL (screen.get_screen_line (1), "| one two  |    ");
+    CHECK_EQUAL (screen.get_screen_line (2), "|three four|    ");
+}
+
+int main()
+{
+    run_test ("wide_character_in_one_column", test_wide_character_in_one_column);
+    run_test ("wide_text_in_one_column_window", test_wide_text_in_one_column_window);
+    run_test ("control_characters_are_found", test_control_characters_are_found);
+    run_test ("line_with_tab", test_line_with_tab);
+    run_test ("word_wrap_centers_each_line", test_word_wrap_centers_each_line);
+    run_test ("truncate_with_ellipsis", test_truncate_with_ellipsis);
+    run_test ("resize_uses_line_break_cache", test_resize_uses_line_break_cache);
+
+    return failed_check_count;
+}
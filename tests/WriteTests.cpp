@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------------------------------------
+// Name:        nCurses UI Library
+// File:        WriteTests.cpp
+// Description: Tests for the write path: once it is warm, writing any type of value to a window
+//              must not allocate, whichever backend draws it and however it is refreshed, and text
+//              is never read as a printf format.  A terminal nCurses can't start on is reported
+//              when the backend is made.
+// Notes:       nCurses runs headless, started with newterm() on a temporary file, so the tests
+//              need no terminal.
+// Author:      Joseph Lyons
+//--------------------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+#include "MemoryBackend.hpp"
+#include "NcursesBackend.hpp"
+#include "UI.hpp"
+
+static const unsigned int screen_width = 80;
+static const unsigned int screen_height = 24;
+
+// Enough writes to fill every window's history, so the steady state is what gets measured
+static const unsigned int warm_up_writes = 200;
+static const unsigned int measured_writes = 1000;
+
+//--------------------------------------------------------------------------------------------------
+// Private: Writes every type of value to the window once, each on its own line
+//--------------------------------------------------------------------------------------------------
+static void write_every_type (UI& ui, const unsigned int& window, const std::string& text)
+{
+    ui.write_to_window (window, text.c_str(), text.size(), true);
+    ui.write_to_window (window, text.c_str(), true);
+    ui.write_to_window (window, std::string_view (text), true);
+    ui.write_to_window (window, text, true);
+    ui.write_to_window (window, 123456, true);
+    ui.write_to_window (window, 3.25f, true);
+    ui.write_to_window (window, 2.5e-300, true);
+    ui.write_to_window (window, 'x', true);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Returns how many heap allocations measured_writes rounds of write_every_type() make,
+//          once warm_up_writes rounds have been made first
+//--------------------------------------------------------------------------------------------------
+static unsigned long int count_write_allocations (UI& ui, const unsigned int& window)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+
+    for (unsigned int i = 0; i < warm_up_writes; i++)
+    {
+        write_every_type (ui, window, text);
+        ui.flush();
+    }
+
+    unsigned long int allocations_before = get_allocation_count();
+
+    for (unsigned int i = 0; i < measured_writes; i++)
+    {
+        write_every_type (ui, window, text);
+        ui.flush();
+    }
+
+    return get_allocation_count() - allocations_before;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Private: Checks a left aligned and a centered window, refreshed on every write and batched
+//--------------------------------------------------------------------------------------------------
+static void check_write_allocations (UI& ui)
+{
+    unsigned int left = ui.make_new_window (0, 0, screen_width / 2, screen_height, "Left", false,
+                                            100);
+    unsigned int centered = ui.make_new_window (screen_width / 2, 0, screen_width / 2,
+                                                screen_height, "Centered", true, 100);
+
+    CHECK (count_write_allocations (ui, left) == 0);
+    CHECK (count_write_allocations (ui, centered) == 0);
+
+    ui.set_batched_refresh (true);
+
+    CHECK (count_write_allocations (ui, left) == 0);
+    CHECK (count_write_allocations (ui, centered) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Warm writes on the MemoryBackend make no heap allocations
+//--------------------------------------------------------------------------------------------------
+static void test_memory_writes_do_not_allocate()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    check_write_allocations (ui);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Warm writes on the NcursesBackend make no heap allocations
+//--------------------------------------------------------------------------------------------------
+static void test_ncurses_writes_do_not_allocate()
+{
+    FILE* output_file = std::tmpfile();
+    FILE* input_file = std::fopen ("/dev/null", "r");
+
+    {
+        NcursesBackend terminal (output_file, input_file, "xterm");
+        UI ui (terminal);
+
+        check_write_allocations (ui);
+    }
+
+    std::fclose (input_file);
+    std::fclose (output_file);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: Text is written exactly as it is, never read as a printf format, while write_formatted()
+//       still formats its arguments
+//--------------------------------------------------------------------------------------------------
+static void test_memory_text_is_not_a_format()
+{
+    MemoryBackend screen (screen_width, screen_height);
+    UI ui (screen);
+
+    unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+    ui.write_to_window (window, "100% %s %n %d", true);
+    ui.write_formatted (window, true, "%d%% of %s", 42, "lines");
+
+    CHECK (screen.get_screen_line (1).find ("|100% %s %n %d ") == 0);
+    CHECK (screen.get_screen_line (2).find ("|42% of lines ") == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: The NcursesBackend sends format directives to the terminal as plain text too
+//--------------------------------------------------------------------------------------------------
+static void test_ncurses_text_is_not_a_format()
+{
+    FILE* output_file = std::tmpfile();
+    FILE* input_file = std::fopen ("/dev/null", "r");
+
+    {
+        NcursesBackend terminal (output_file, input_file, "xterm");
+        UI ui (terminal);
+
+        unsigned int window = ui.make_new_window (0, 0, screen_width, screen_height, "", false);
+
+        ui.write_to_window (window, "100% %s %n %d", true);
+    }
+
+    std::string output (65536, '\0');
+
+    std::fflush (output_file);
+    std::rewind (output_file);
+    output.resize (std::fread (&output[0], 1, output.size(), output_file));
+
+    CHECK (output.find ("100% %s %n %d") != std::string::npos);
+
+    std::fclose (input_file);
+    std::fclose (output_file);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Test: A terminal type terminfo doesn't know is reported rather than left to crash later
+//--------------------------------------------------------------------------------------------------
+static void test_ncurses_rejects_unknown_terminal()
+{
+    FILE* output_file = std::tmpfile();
+    FILE* input_file = std::fopen ("/dev/null", "r");
+    bool is_rejected = false;
+
+    try
+    {
+        NcursesBackend terminal (output_file, input_file, "no-such-terminal");
+    }
+    catch (const std::runtime_error& error)
+    {
+        is_rejected = std::string (error.what()).find ("no-such-terminal") != std::string::npos;
+    }
+
+    CHECK (is_rejected);
+
+    std::fclose (input_file);
+    std::fclose (output_file);
+}
+
+int main()
+{
+    // Make newterm() size its screen from these rather than from terminfo
+    setenv ("COLUMNS", std::to_string (screen_width).c_str(), 1);
+    setenv ("LINES", std::to_string (screen_height).c_str(), 1);
+
+    run_test ("memory_writes_do_not_allocate", test_memory_writes_do_not_allocate);
+    run_test ("ncurses_writes_do_not_allocate", test_ncurses_writes_do_not_allocate);
+    run_test ("memory_text_is_not_a_format", test_memory_text_is_not_a_format);
+    run_test ("ncurses_text_is_not_a_format", test_ncurses_text_is_not_a_format);
+    run_test ("ncurses_rejects_unknown_terminal", test_ncurses_rejects_unknown_terminal);
+
+    return failed_check_count;
+}